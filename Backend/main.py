@@ -2,8 +2,10 @@ import os
 from fastapi import FastAPI, HTTPException, Depends
 from fastapi.security import OAuth2AuthorizationCodeBearer
 from fastapi import Request, HTTPException
+from fastapi.responses import JSONResponse, StreamingResponse
 from mangum import Mangum
 import boto3
+from botocore.exceptions import ClientError
 from jose import jwt, JWTError
 from pydantic import BaseModel
 from typing import Dict
@@ -12,7 +14,9 @@ import openai
 from dotenv import load_dotenv
 import requests
 import json
+import re
 import sys
+import time
 import logging
 
 # Set up logging
@@ -39,6 +43,8 @@ except Exception as e:
 dynamodb = boto3.resource("dynamodb", region_name="us-east-2")
 secrets_client = boto3.client("secretsmanager")
 table = dynamodb.Table("SummonerUsers")
+# One item per charged idempotency key ("<userId>#<key>"), expired through the table's TTL on expiresAt
+CHARGE_KEYS_TABLE = "SummonerChargeKeys"
 
 # Cognito settings
 COGNITO_USER_POOL_ID = "us-east-2_pvCcMvaRP"
@@ -287,11 +293,53 @@ async def purchase_credits(request: PurchaseRequest, user_id: str = Depends(get_
         sys.stdout.flush()
         raise HTTPException(status_code=400, detail=str(e))
 
-@app.post("/generate-parameters")
-async def generate_parameters(user_input: UserInput, user_id: str = Depends(get_current_user)):
-    logger.info("Reached /generate-parameters endpoint for user_id: %s", user_id)
-    print("Reached /generate-parameters endpoint for user_id:", user_id)
-    sys.stdout.flush()
+# Generation responses carry the balance left after their charge, so clients
+# don't have to ask /get-credits again after every prompt
+CREDITS_HEADER = "X-Credits-Remaining"
+
+# Clients send the same key on every copy of one prompt (hedged duplicates and
+# retries), so only the first copy to arrive is charged
+IDEMPOTENCY_HEADER = "Idempotency-Key"
+CHARGE_KEY_TTL_SECONDS = 24 * 60 * 60
+
+def charge_credit_once(user_id: str, idempotency_key: str) -> int:
+    """Charges like charge_credit, but at most once per idempotency key. A repeated key
+    is not charged again; it gets the current balance."""
+    client = dynamodb.meta.client
+    try:
+        client.transact_write_items(TransactItems=[
+            {"Put": {
+                "TableName": CHARGE_KEYS_TABLE,
+                "Item": {
+                    "chargeKey": {"S": f"{user_id}#{idempotency_key}"},
+                    "expiresAt": {"N": str(int(time.time()) + CHARGE_KEY_TTL_SECONDS)}
+                },
+                "ConditionExpression": "attribute_not_exists(chargeKey)"
+            }},
+            {"Update": {
+                "TableName": table.name,
+                "Key": {"userId": {"S": user_id}},
+                "UpdateExpression": "SET credits = credits - :val",
+                "ConditionExpression": "credits >= :val",
+                "ExpressionAttributeValues": {":val": {"N": "1"}}
+            }}
+        ])
+    except ClientError as e:
+        reasons = [reason.get("Code") for reason in e.response.get("CancellationReasons", [])]
+        if len(reasons) > 0 and reasons[0] == "ConditionalCheckFailed":
+            logger.info("Idempotency key already charged for user_id: %s", user_id)
+        elif len(reasons) > 1 and reasons[1] == "ConditionalCheckFailed":
+            logger.error("Insufficient credits detected for user_id: %s", user_id)
+            raise HTTPException(status_code=402, detail="Insufficient credits")
+        else:
+            raise
+    user = table.get_item(Key={"userId": user_id}, ConsistentRead=True).get("Item", {})
+    remaining = int(user.get("credits", 0))
+    logger.info("Credits for user_id: %s, %d left", user_id, remaining)
+    return remaining
+
+def charge_credit(user_id: str, idempotency_key: str | None = None) -> int:
+    """Takes one credit for a generation and returns the balance left, raising 404/402 when it can't."""
     response = table.get_item(Key={"userId": user_id})
     logger.info("DynamoDB response: %s", response)
     print("DynamoDB response:", response)
@@ -302,6 +350,10 @@ async def generate_parameters(user_input: UserInput, user_id: str = Depends(get_
         print("User not found in DynamoDB:", user_id)
         sys.stdout.flush()
         raise HTTPException(status_code=404, detail="User not found")
+    if idempotency_key:
+        # The balance check is part of the conditional write: a copy arriving after the
+        # first one spent the last credit must still see its own charge, not a 402
+        return charge_credit_once(user_id, idempotency_key)
     credits = int(user.get("credits", 0))
     logger.info("User credits: %d", credits)
     print("User credits:", credits)
@@ -311,19 +363,32 @@ async def generate_parameters(user_input: UserInput, user_id: str = Depends(get_
         print("Insufficient credits detected for user_id:", user_id)
         sys.stdout.flush()
         raise HTTPException(status_code=402, detail="Insufficient credits")
-    table.update_item(
+    updated = table.update_item(
         Key={"userId": user_id},
         UpdateExpression="SET credits = credits - :val",
-        ExpressionAttributeValues={":val": 1}
+        ExpressionAttributeValues={":val": 1},
+        ReturnValues="UPDATED_NEW"
     )
-    logger.info("Credits updated for user_id: %s", user_id)
-    print("Credits updated for user_id:", user_id)
+    remaining = int(updated.get("Attributes", {}).get("credits", credits - 1))
+    logger.info("Credits updated for user_id: %s, %d left", user_id, remaining)
+    print("Credits updated for user_id:", user_id, "remaining:", remaining)
     sys.stdout.flush()
+    return remaining
+
+def build_serum_prompt(user_text: str) -> str:
+    return f"Interpret the user's request with creativity within the specified ranges and default values, leveraging sound design knowledge to produce engaging and innovative soundscapes using the provided Serum VST parameters. While every response should include all 123 parameters in order formatted as {{\"Parameter Name\", \"Value\"}} in a consistent list, allow for variations that reflect musicality and style. The user's request will be inputted at the bottom of this prompt. Follow these guidelines: Use the full spectrum of provided values and descriptions to address specific or abstract prompts (e.g., \"bright and plucky\", \"deep and textured\") while staying within bounds. Be imaginative in assigning values to create sound textures that meet the user's description, but adhere strictly to parameter names and ensure all 123 parameters are included every time. Return the parameters in the format {{\"Parameter Name\", \"Value\"}}, even if a parameter's default value remains unchanged. Here are the 123 parameters and their default values: [{{\"Parameter Name\": \"Env1 Atk\", \"Value\": \"0.5 ms\"}}, {{\"Parameter Name\": \"Env1 Hold\", \"Value\": \"0.0 ms\"}}, {{\"Parameter Name\": \"Env1 Dec\", \"Value\": \"1.00 s\"}}, {{\"Parameter Name\": \"Env1 Sus\", \"Value\": \"0.0 dB\"}}, {{\"Parameter Name\": \"Env1 Rel\", \"Value\": \"15 ms\"}}, {{\"Parameter Name\": \"Osc A On\", \"Value\": \"on\"}}, {{\"Parameter Name\": \"A UniDet\", \"Value\": \"0.25\"}}, {{\"Parameter Name\": \"A UniBlend\", \"Value\": \"75\"}}, {{\"Parameter Name\": \"A WTPos\", \"Value\": \"Sine\"}}, {{\"Parameter Name\": \"A Pan\", \"Value\": \"0\"}}, {{\"Parameter Name\": \"A Vol\", \"Value\": \"75%\"}}, {{\"Parameter Name\": \"A Unison\", \"Value\": \"1\"}}, {{\"Parameter Name\": \"A Octave\", \"Value\": \"0 Oct\"}}, {{\"Parameter Name\": \"A Semi\", \"Value\": \"0 semitones\"}}, {{\"Parameter Name\": \"A Fine\", \"Value\": \"0 cents\"}}, {{\"Parameter Name\": \"Fil Type\", \"Value\": \"MG Low 12\"}}, {{\"Parameter Name\": \"Fil Cutoff\", \"Value\": \"425 Hz\"}}, {{\"Parameter Name\": \"Fil Reso\", \"Value\": \"10%\"}}, {{\"Parameter Name\": \"Filter On\", \"Value\": \"off\"}}, {{\"Parameter Name\": \"Fil Driv\", \"Value\": \"0%\"}}, {{\"Parameter Name\": \"Fil Var\", \"Value\": \"0%\"}}, {{\"Parameter Name\": \"Fil Mix\", \"Value\": \"100%\"}}, {{\"Parameter Name\": \"OscA>Fil\", \"Value\": \"on\"}}, {{\"Parameter Name\": \"OscB>Fil\", \"Value\": \"off\"}}, {{\"Parameter Name\": \"OscN>Fil\", \"Value\": \"off\"}}, {{\"Parameter Name\": \"OscS>Fil\", \"Value\": \"off\"}}, {{\"Parameter Name\": \"Osc N On\", \"Value\": \"off\"}}, {{\"Parameter Name\": \"Noise Pitch\", \"Value\": \"50%\"}}, {{\"Parameter Name\": \"Noise Level\", \"Value\": \"25%\"}}, {{\"Parameter Name\": \"Osc S On\", \"Value\": \"off\"}}, {{\"Parameter Name\": \"Sub Osc Level\", \"Value\": \"75%\"}}, {{\"Parameter Name\": \"SubOscOctave\", \"Value\": \"0 Oct\"}}, {{\"Parameter Name\": \"SubOscShape\", \"Value\": \"Sine\"}}, {{\"Parameter Name\": \"Osc B On\", \"Value\": \"off\"}}, {{\"Parameter Name\": \"B UniDet\", \"Value\": \"0.25\"}}, {{\"Parameter Name\": \"B UniBlend\", \"Value\": \"75\"}}, {{\"Parameter Name\": \"B WTPos\", \"Value\": \"1\"}}, {{\"Parameter Name\": \"B Pan\", \"Value\": \"0\"}}, {{\"Parameter Name\": \"B Vol\", \"Value\": \"75%\"}}, {{\"Parameter Name\": \"B Unison\", \"Value\": \"1\"}}, {{\"Parameter Name\": \"B Octave\", \"Value\": \"0 Oct\"}}, {{\"Parameter Name\": \"B Semi\", \"Value\": \"0 semitones\"}}, {{\"Parameter Name\": \"B Fine\", \"Value\": \"0 cents\"}}, {{\"Parameter Name\": \"Hyp Enable\", \"Value\": \"off\"}}, {{\"Parameter Name\": \"Hyp_Rate\", \"Value\": \"40%\"}}, {{\"Parameter Name\": \"Hyp_Detune\", \"Value\": \"25%\"}}, {{\"Parameter Name\": \"Hyp_Retrig\", \"Value\": \"off\"}}, {{\"Parameter Name\": \"Hyp_Wet\", \"Value\": \"50%\"}}, {{\"Parameter Name\": \"Hyp_Unision\", \"Value\": \"4\"}}, {{\"Parameter Name\": \"HypDim_Size\", \"Value\": \"50%\"}}, {{\"Parameter Name\": \"HypDim_Mix\", \"Value\": \"0%\"}}, {{\"Parameter Name\": \"Dist Enable\", \"Value\": \"off\"}}, {{\"Parameter Name\": \"Dist_Mode\", \"Value\": \"Tube\"}}, {{\"Parameter Name\": \"Dist_PrePost\", \"Value\": \"Off\"}}, {{\"Parameter Name\": \"Dist_Freq\", \"Value\": \"330 Hz\"}}, {{\"Parameter Name\": \"Dist_BW\", \"Value\": \"1.9\"}}, {{\"Parameter Name\": \"Dist_L/B/H\", \"Value\": \"0%\"}}, {{\"Parameter Name\": \"Dist_Drv\", \"Value\": \"25%\"}}, {{\"Parameter Name\": \"Dist_Wet\", \"Value\": \"100%\"}}, {{\"Parameter Name\": \"Flg Enable\", \"Value\": \"off\"}}, {{\"Parameter Name\": \"Flg_Rate\", \"Value\": \"0.08 Hz\"}}, {{\"Parameter Name\": \"Flg_BPM_Sync\", \"Value\": \"off\"}}, {{\"Parameter Name\": \"Flg_Dep\", \"Value\": \"100%\"}}, {{\"Parameter Name\": \"Flg_Feed\", \"Value\": \"50%\"}}, {{\"Parameter Name\": \"Flg_Stereo\", \"Value\": \"180deg.\"}}, {{\"Parameter Name\": \"Flg_Wet\", \"Value\": \"100%\"}}, {{\"Parameter Name\": \"Phs Enable\", \"Value\": \"off\"}}, {{\"Parameter Name\": \"Phs_Rate\", \"Value\": \"0.08 Hz\"}}, {{\"Parameter Name\": \"Phs_BPM_Sync\", \"Value\": \"off\"}}, {{\"Parameter Name\": \"Phs_Dpth\", \"Value\": \"50%\"}}, {{\"Parameter Name\": \"Phs_Frq\", \"Value\": \"600 Hz\"}}, {{\"Parameter Name\": \"Phs_Feed\", \"Value\": \"80%\"}}, {{\"Parameter Name\": \"Phs_Stereo\", \"Value\": \"180deg.\"}}, {{\"Parameter Name\": \"Phs_Wet\", \"Value\": \"100%\"}}, {{\"Parameter Name\": \"Cho Enable\", \"Value\": \"off\"}}, {{\"Parameter Name\": \"Cho_Rate\", \"Value\": \"0.08 Hz\"}}, {{\"Parameter Name\": \"Cho_BPM_Sync\", \"Value\": \"off\"}}, {{\"Parameter Name\": \"Cho_Dly\", \"Value\": \"5.0 ms\"}}, {{\"Parameter Name\": \"Cho_Dly2\", \"Value\": \"0.0 ms\"}}, {{\"Parameter Name\": \"Cho_Dep\", \"Value\": \"26.0 ms\"}}, {{\"Parameter Name\": \"Cho_Feed\", \"Value\": \"10%\"}}, {{\"Parameter Name\": \"Cho_Filt\", \"Value\": \"1000 Hz\"}}, {{\"Parameter Name\": \"Cho_Wet\", \"Value\": \"50%\"}}, {{\"Parameter Name\": \"Dly Enable\", \"Value\": \"off\"}}, {{\"Parameter Name\": \"Dly_Feed\", \"Value\": \"40%\"}}, {{\"Parameter Name\": \"Dly_BPM_Sync\", \"Value\": \"on\"}}, {{\"Parameter Name\": \"Dly_Link\", \"Value\": \"Unlink, Link\"}}, {{\"Parameter Name\": \"Dly_TimL\", \"Value\": \"1/4\"}}, {{\"Parameter Name\": \"Dly_TimR\", \"Value\": \"1/4\"}}, {{\"Parameter Name\": \"Dly_BW\", \"Value\": \"6.8\"}}, {{\"Parameter Name\": \"Dly_Freq\", \"Value\": \"849 Hz\"}}, {{\"Parameter Name\": \"Dly_Mode\", \"Value\": \"Normal\"}}, {{\"Parameter Name\": \"Dly_Wet\", \"Value\": \"30%\"}}, {{\"Parameter Name\": \"Comp Enable\", \"Value\": \"off\"}}, {{\"Parameter Name\": \"Cmp_Thr\", \"Value\": \"-18.1 dB\"}}, {{\"Parameter Name\": \"Cmp_Att\", \"Value\": \"90.1 ms\"}}, {{\"Parameter Name\": \"Cmp_Rel\", \"Value\": \"90 ms\"}}, {{\"Parameter Name\": \"CmpGain\", \"Value\": \"0.0 dB\"}}, {{\"Parameter Name\": \"CmpMBnd\", \"Value\": \"Normal\"}}, {{\"Parameter Name\": \"Comp_Wet\", \"Value\": \"100\"}}, {{\"Parameter Name\": \"Rev Enable\", \"Value\": \"off\"}}, {{\"Parameter Name\": \"VerbSize\", \"Value\": \"35%\"}}, {{\"Parameter Name\": \"Decay\", \"Value\": \"4.7 s\"}}, {{\"Parameter Name\": \"VerbLoCt\", \"Value\": \"0%\"}}, {{\"Parameter Name\": \"VerbHiCt\", \"Value\": \"35%\"}}, {{\"Parameter Name\": \"Spin Rate\", \"Value\": \"25%\"}}, {{\"Parameter Name\": \"Verb Wet\", \"Value\": \"20%\"}}, {{\"Parameter Name\": \"EQ Enable\", \"Value\": \"off\"}}, {{\"Parameter Name\": \"EQ FrqL\", \"Value\": \"210 Hz\"}}, {{\"Parameter Name\": \"EQ Q L\", \"Value\": \"60%\"}}, {{\"Parameter Name\": \"EQ VolL\", \"Value\": \"0.0 dB\"}}, {{\"Parameter Name\": \"EQ TypL\", \"Value\": \"Shelf\"}}, {{\"Parameter Name\": \"EQ TypeH\", \"Value\": \"Shelf\"}}, {{\"Parameter Name\": \"EQ FrqH\", \"Value\": \"2041 Hz\"}}, {{\"Parameter Name\": \"EQ Q H\", \"Value\": \"60%\"}}, {{\"Parameter Name\": \"EQ VolH\", \"Value\": \"0.0\"}}, {{\"Parameter Name\": \"FX Fil Enable\", \"Value\": \"off\"}}, {{\"Parameter Name\": \"FX Fil Type\", \"Value\": \"MG Low 6\"}}, {{\"Parameter Name\": \"FX Fil Freq\", \"Value\": \"330 Hz\"}}, {{\"Parameter Name\": \"FX Fil Reso\", \"Value\": \"0%\"}}, {{\"Parameter Name\": \"FX Fil Drive\", \"Value\": \"0%\"}}, {{\"Parameter Name\": \"FX Fil Pan\", \"Value\": \"50%\"}}, {{\"Parameter Name\": \"FX Fil Wet\", \"Value\": \"100%\"}}] Here are those 123 parameter's respective ranges that you can choose from: [{{\"Parameter Name\": \"Env1 Atk\", \"Value\": \"0.0 ms - 32.0 s\"}}, {{\"Parameter Name\": \"Env1 Hold\", \"Value\": \"0.0 ms - 32.0 s\"}}, {{\"Parameter Name\": \"Env1 Dec\", \"Value\": \"0.0 ms - 32.0 s\"}}, {{\"Parameter Name\": \"Env1 Sus\", \"Value\": \"-inf dB - 0.0 dB\"}}, {{\"Parameter Name\": \"Env1 Rel\", \"Value\": \"0.0ms - 32.0s\"}}, {{\"Parameter Name\": \"Osc A On\", \"Value\": \"off, on\"}}, {{\"Parameter Name\": \"A UniDet\", \"Value\": \"0.00 - 1.00\"}}, {{\"Parameter Name\": \"A UniBlend\", \"Value\": \"0 - 100\"}}, {{\"Parameter Name\": \"A WTPos\", \"Value\": \"Sine, Saw, Triangle, Square, Pulse, Half Pulse, Inv-Phase Saw\"}}, {{\"Parameter Name\": \"A Pan\", \"Value\": \"-50 - 50\"}}, {{\"Parameter Name\": \"A Vol\", \"Value\": \"0% - 100%\"}}, {{\"Parameter Name\": \"A Unison\", \"Value\": \"1 - 16\"}}, {{\"Parameter Name\": \"A Octave\", \"Value\": \"-4 Oct, -3 Oct, -2 Oct, -1 Oct, 0 Oct, 1 Oct, 2 Oct, 3 Oct, 4 Oct\"}}, {{\"Parameter Name\": \"A Semi\", \"Value\": \"-12 semitones - +12 semitones\"}}, {{\"Parameter Name\": \"A Fine\", \"Value\": \"-100 cents - 100 cents\"}}, {{\"Parameter Name\": \"Fil Type\", \"Value\": \"MG Low 6, MG Low 12, MG Low 18, MG Low 24, Low 6, Low 12, Low 18, Low 24, High 6, High 12, High 18, High 24, Band 12, Band 24, Peak 12, Peak 24, Notch 12, Notch 24, LH 6, LH 12, LB 12, LP 12, LN 12, HB 12, HP 12, HN 12, BP 12, PP 12, PN 12, NN 12, L/B/H 12, L/B/H 24, L/P/H 12, L/P/H 24, L/N/H 12, L/N/H 24, B/P/N 12, B/P/N 24, Cmb +, Cmb -, Cmb L6+, Cmb L6-, Cmb H6+, Cmb H6-, Cmb HL6+, Cmb HL6-, Flg +, Flg -, Flg L6+, Flg L6-, Flg H6+, Flg H6-, Flg HL6+, Flg HL6-, Phs 12+, Phs 12-, Phs 24+, Phs 24-, Phs 36+, Phs 36-, Phs 48+, Phs 48-, Phs 48L6+, Phs 48L6-, Phs 48H6+, Phs 48H6-, Phs 48HL6+, Phs 48HL6-, FPhs 12HL6+, FPhs 12HL6-, Low EQ 6, Low EQ 12, Band EQ 12, High EQ 6, High EQ 12, Ring Mod, Ring Modx2, SampHold, SampHold-, Combs, Allpasses, Reverb, French LP, German LP, Add Bass, Formant-I, Formant-II, Formant-III, Bandreject, Dist.Comb 1 LP, Dist.Comb 1 BP, Dist.Comb 2 LP, Dist.Comb 2 BP, Scream LP, Scream BP\"}}, {{\"Parameter Name\": \"Fil Cutoff\", \"Value\": \"8 Hz - 22050 Hz\"}}, {{\"Parameter Name\": \"Fil Reso\", \"Value\": \"0% - 100%\"}}, {{\"Parameter Name\": \"Filter On\", \"Value\": \"off, on\"}}, {{\"Parameter Name\": \"Fil Driv\", \"Value\": \"0% - 100%\"}}, {{\"Parameter Name\": \"Fil Var\", \"Value\": \"0% - 100%\"}}, {{\"Parameter Name\": \"Fil Mix\", \"Value\": \"0% - 100%\"}}, {{\"Parameter Name\": \"OscA>Fil\", \"Value\": \"off, on\"}}, {{\"Parameter Name\": \"OscB>Fil\", \"Value\": \"off, on\"}}, {{\"Parameter Name\": \"OscN>Fil\", \"Value\": \"off, on\"}}, {{\"Parameter Name\": \"OscS>Fil\", \"Value\": \"off, on\"}}, {{\"Parameter Name\": \"Osc N On\", \"Value\": \"off, on\"}}, {{\"Parameter Name\": \"Noise Pitch\", \"Value\": \"0% - 100%\"}}, {{\"Parameter Name\": \"Noise Level\", \"Value\": \"0% - 100%\"}}, {{\"Parameter Name\": \"Osc S On\", \"Value\": \"off, on\"}}, {{\"Parameter Name\": \"Sub Osc Level\", \"Value\": \"0%-100%\"}}, {{\"Parameter Name\": \"SubOscOctave\", \"Value\": \"-4 Oct, -3 Oct, -2 Oct, -1 Oct, 0 Oct, 1 Oct, 2 Oct, 3 Oct, 4 Oct\"}}, {{\"Parameter Name\": \"SubOscShape\", \"Value\": \"Sine, RoundRect, Triangle, Saw, Square, Pulse\"}}, {{\"Parameter Name\": \"Osc B On\", \"Value\": \"off, on\"}}, {{\"Parameter Name\": \"B UniDet\", \"Value\": \"0.00 - 1.00\"}}, {{\"Parameter Name\": \"B UniBlend\", \"Value\": \"0 - 100\"}}, {{\"Parameter Name\": \"B WTPos\", \"Value\": \"Sine, Saw, Triangle, Square, Pulse, Half Pulse, Inv-Phase Saw\"}}, {{\"Parameter Name\": \"B Pan\", \"Value\": \"-50 - 50\"}}, {{\"Parameter Name\": \"B Vol\", \"Value\": \"0% - 100%\"}}, {{\"Parameter Name\": \"B Unison\", \"Value\": \"1 - 16\"}}, {{\"Parameter Name\": \"B Octave\", \"Value\": \"-4 Oct, -3 Oct, -2 Oct, -1 Oct, 0 Oct, 1 Oct, 2 Oct, 3 Oct, 4 Oct\"}}, {{\"Parameter Name\": \"B Semi\", \"Value\": \"-12 semitones - +12 semitones\"}}, {{\"Parameter Name\": \"B Fine\", \"Value\": \"-100 cents - 100 cents\"}}, {{\"Parameter Name\": \"Hyp Enable\", \"Value\": \"off, on\"}}, {{\"Parameter Name\": \"Hyp_Rate\", \"Value\": \"0% - 100%\"}}, {{\"Parameter Name\": \"Hyp_Detune\", \"Value\": \"0% - 100%\"}}, {{\"Parameter Name\": \"Hyp_Retrig\", \"Value\": \"off - Retrig\"}}, {{\"Parameter Name\": \"Hyp_Wet\", \"Value\": \"0% - 100%\"}}, {{\"Parameter Name\": \"Hyp_Unision\", \"Value\": \"0 - 7\"}}, {{\"Parameter Name\": \"HypDim_Size\", \"Value\": \"0% - 100%\"}}, {{\"Parameter Name\": \"HypDim_Mix\", \"Value\": \"0% - 100%\"}}, {{\"Parameter Name\": \"Dist Enable\", \"Value\": \"off, on\"}}, {{\"Parameter Name\": \"Dist_Mode\", \"Value\": \"Tube, SoftClip, HardClip, Diode 1, Diode 2, Lin.Fold, Sin Fold, Zero-Square, Downsample, Asym, Rectify, X-Shaper, X-Shaper (Asym), Sine Shaper, Stomp Box, Tape Stop\"}}, {{\"Parameter Name\": \"Dist_PrePost\", \"Value\": \"Off, Pre, Post\"}}, {{\"Parameter Name\": \"Dist_Freq\", \"Value\": \"8 Hz, 13290 Hz\"}}, {{\"Parameter Name\": \"Dist_BW\", \"Value\": \"0.1 - 7.6\"}}, {{\"Parameter Name\": \"Dist_L/B/H\", \"Value\": \"0% - 100%\"}}, {{\"Parameter Name\": \"Dist_Drv\", \"Value\": \"0% - 100%\"}}, {{\"Parameter Name\": \"Dist_Wet\", \"Value\": \"0% - 100%\"}}, {{\"Parameter Name\": \"Flg Enable\", \"Value\": \"off, on\"}}, {{\"Parameter Name\": \"Flg_Rate\", \"Value\": \"0.00 Hz - 20.00 Hz\"}}, {{\"Parameter Name\": \"Flg_BPM_Sync\", \"Value\": \"off, on\"}}, {{\"Parameter Name\": \"Flg_Dep\", \"Value\": \"0% - 100%\"}}, {{\"Parameter Name\": \"Flg_Feed\", \"Value\": \"0% - 100%\"}}, {{\"Parameter Name\": \"Flg_Stereo\", \"Value\": \"22 Hz - 200\"}}, {{\"Parameter Name\": \"Flg_Wet\", \"Value\": \"0% - 100%\"}}, {{\"Parameter Name\": \"Phs Enable\", \"Value\": \"off, on\"}}, {{\"Parameter Name\": \"Phs_Rate\", \"Value\": \"0.00 Hz - 20.00 Hz\"}}, {{\"Parameter Name\": \"Phs_BPM_Sync\", \"Value\": \"off, on\"}}, {{\"Parameter Name\": \"Phs_Dpth\", \"Value\": \"0% - 100%\"}}, {{\"Parameter Name\": \"Phs_Frq\", \"Value\": \"20 Hz - 18000 Hz\"}}, {{\"Parameter Name\": \"Phs_Feed\", \"Value\": \"0% - 100%\"}}, {{\"Parameter Name\": \"Phs_Stereo\", \"Value\": \"0 deg. - 360 deg.\"}}, {{\"Parameter Name\": \"Phs_Wet\", \"Value\": \"0% - 100%\"}}, {{\"Parameter Name\": \"Cho Enable\", \"Value\": \"off, on\"}}, {{\"Parameter Name\": \"Cho_Rate\", \"Value\": \"0.00 Hz - 20.00 Hz\"}}, {{\"Parameter Name\": \"Cho_BPM_Sync\", \"Value\": \"off, on\"}}, {{\"Parameter Name\": \"Cho_Dly\", \"Value\": \"0.0 ms - 20.0 ms\"}}, {{\"Parameter Name\": \"Cho_Feed\", \"Value\": \"0% - 95%\"}}, {{\"Parameter Name\": \"Cho_Filt\", \"Value\": \"50 Hz - 20000 Hz\"}}, {{\"Parameter Name\": \"Cho_Wet\", \"Value\": \"0% - 100%\"}}, {{\"Parameter Name\": \"Dly Enable\", \"Value\": \"off, on\"}}, {{\"Parameter Name\": \"Dly_BPM_Sync\", \"Value\": \"off, on\"}}, {{\"Parameter Name\": \"Dly_TimL\", \"Value\": \"1.00 - 501.00\"}}, {{\"Parameter Name\": \"Dly_TimR\", \"Value\": \"1.00 - 501.00\"}}, {{\"Parameter Name\": \"Dly_Freq\", \"Value\": \"40 Hz - 18000 Hz\"}}, {{\"Parameter Name\": \"Dly_Mode\", \"Value\": \"Normal, Ping-Pong, Tap->Delay\"}}, {{\"Parameter Name\": \"Dly_Wet\", \"Value\": \"0% - 100%\"}}, {{\"Parameter Name\": \"Comp Enable\", \"Value\": \"off, on\"}}, {{\"Parameter Name\": \"Cmp_Thr\", \"Value\": \"0.0 dB - 120.0 dB\"}}, {{\"Parameter Name\": \"Cmp_Att\", \"Value\": \"0.1 ms - 1000.0 ms\"}}, {{\"Parameter Name\": \"Cmp_Rel\", \"Value\": \"0.1 ms - 999.1 ms\"}}, {{\"Parameter Name\": \"CmpGain\", \"Value\": \"0.0 dB - 30.1 dB\"}}, {{\"Parameter Name\": \"CmpMBnd\", \"Value\": \"Normal, MultBand\"}}, {{\"Parameter Name\": \"Comp_Wet\", \"Value\": \"0 - 100\"}}] To facilitate accurate parsing and handling of your requests, please provide parameter adjustments in JSON format when possible. This ensures the correct interpretation and application of your specifications for this C++ program. Don't add newline characters. Even if the request doesn't seem to be related to the sound designing task, respond with the list: DO NOT RESPOND WITH ANYTHING BUT THE LIST! User input: {user_text}. Return as JSON."
+
+@app.post("/generate-parameters")
+async def generate_parameters(user_input: UserInput, request: Request, user_id: str = Depends(get_current_user)):
+    logger.info("Reached /generate-parameters endpoint for user_id: %s", user_id)
+    print("Reached /generate-parameters endpoint for user_id:", user_id)
+    sys.stdout.flush()
+    remaining = charge_credit(user_id, request.headers.get(IDEMPOTENCY_HEADER))
     logger.info("Calling ChatGPT with input: %s", user_input.input)
     print("Calling ChatGPT with input:", user_input.input)
     sys.stdout.flush()
     openai.api_key = get_chatgpt_key()
-    prompt = f"Interpret the user's request with creativity within the specified ranges and default values, leveraging sound design knowledge to produce engaging and innovative soundscapes using the provided Serum VST parameters. While every response should include all 123 parameters in order formatted as {{\"Parameter Name\", \"Value\"}} in a consistent list, allow for variations that reflect musicality and style. The user's request will be inputted at the bottom of this prompt. Follow these guidelines: Use the full spectrum of provided values and descriptions to address specific or abstract prompts (e.g., \"bright and plucky\", \"deep and textured\") while staying within bounds. Be imaginative in assigning values to create sound textures that meet the user's description, but adhere strictly to parameter names and ensure all 123 parameters are included every time. Return the parameters in the format {{\"Parameter Name\", \"Value\"}}, even if a parameter's default value remains unchanged. Here are the 123 parameters and their default values: [{{\"Parameter Name\": \"Env1 Atk\", \"Value\": \"0.5 ms\"}}, {{\"Parameter Name\": \"Env1 Hold\", \"Value\": \"0.0 ms\"}}, {{\"Parameter Name\": \"Env1 Dec\", \"Value\": \"1.00 s\"}}, {{\"Parameter Name\": \"Env1 Sus\", \"Value\": \"0.0 dB\"}}, {{\"Parameter Name\": \"Env1 Rel\", \"Value\": \"15 ms\"}}, {{\"Parameter Name\": \"Osc A On\", \"Value\": \"on\"}}, {{\"Parameter Name\": \"A UniDet\", \"Value\": \"0.25\"}}, {{\"Parameter Name\": \"A UniBlend\", \"Value\": \"75\"}}, {{\"Parameter Name\": \"A WTPos\", \"Value\": \"Sine\"}}, {{\"Parameter Name\": \"A Pan\", \"Value\": \"0\"}}, {{\"Parameter Name\": \"A Vol\", \"Value\": \"75%\"}}, {{\"Parameter Name\": \"A Unison\", \"Value\": \"1\"}}, {{\"Parameter Name\": \"A Octave\", \"Value\": \"0 Oct\"}}, {{\"Parameter Name\": \"A Semi\", \"Value\": \"0 semitones\"}}, {{\"Parameter Name\": \"A Fine\", \"Value\": \"0 cents\"}}, {{\"Parameter Name\": \"Fil Type\", \"Value\": \"MG Low 12\"}}, {{\"Parameter Name\": \"Fil Cutoff\", \"Value\": \"425 Hz\"}}, {{\"Parameter Name\": \"Fil Reso\", \"Value\": \"10%\"}}, {{\"Parameter Name\": \"Filter On\", \"Value\": \"off\"}}, {{\"Parameter Name\": \"Fil Driv\", \"Value\": \"0%\"}}, {{\"Parameter Name\": \"Fil Var\", \"Value\": \"0%\"}}, {{\"Parameter Name\": \"Fil Mix\", \"Value\": \"100%\"}}, {{\"Parameter Name\": \"OscA>Fil\", \"Value\": \"on\"}}, {{\"Parameter Name\": \"OscB>Fil\", \"Value\": \"off\"}}, {{\"Parameter Name\": \"OscN>Fil\", \"Value\": \"off\"}}, {{\"Parameter Name\": \"OscS>Fil\", \"Value\": \"off\"}}, {{\"Parameter Name\": \"Osc N On\", \"Value\": \"off\"}}, {{\"Parameter Name\": \"Noise Pitch\", \"Value\": \"50%\"}}, {{\"Parameter Name\": \"Noise Level\", \"Value\": \"25%\"}}, {{\"Parameter Name\": \"Osc S On\", \"Value\": \"off\"}}, {{\"Parameter Name\": \"Sub Osc Level\", \"Value\": \"75%\"}}, {{\"Parameter Name\": \"SubOscOctave\", \"Value\": \"0 Oct\"}}, {{\"Parameter Name\": \"SubOscShape\", \"Value\": \"Sine\"}}, {{\"Parameter Name\": \"Osc B On\", \"Value\": \"off\"}}, {{\"Parameter Name\": \"B UniDet\", \"Value\": \"0.25\"}}, {{\"Parameter Name\": \"B UniBlend\", \"Value\": \"75\"}}, {{\"Parameter Name\": \"B WTPos\", \"Value\": \"1\"}}, {{\"Parameter Name\": \"B Pan\", \"Value\": \"0\"}}, {{\"Parameter Name\": \"B Vol\", \"Value\": \"75%\"}}, {{\"Parameter Name\": \"B Unison\", \"Value\": \"1\"}}, {{\"Parameter Name\": \"B Octave\", \"Value\": \"0 Oct\"}}, {{\"Parameter Name\": \"B Semi\", \"Value\": \"0 semitones\"}}, {{\"Parameter Name\": \"B Fine\", \"Value\": \"0 cents\"}}, {{\"Parameter Name\": \"Hyp Enable\", \"Value\": \"off\"}}, {{\"Parameter Name\": \"Hyp_Rate\", \"Value\": \"40%\"}}, {{\"Parameter Name\": \"Hyp_Detune\", \"Value\": \"25%\"}}, {{\"Parameter Name\": \"Hyp_Retrig\", \"Value\": \"off\"}}, {{\"Parameter Name\": \"Hyp_Wet\", \"Value\": \"50%\"}}, {{\"Parameter Name\": \"Hyp_Unision\", \"Value\": \"4\"}}, {{\"Parameter Name\": \"HypDim_Size\", \"Value\": \"50%\"}}, {{\"Parameter Name\": \"HypDim_Mix\", \"Value\": \"0%\"}}, {{\"Parameter Name\": \"Dist Enable\", \"Value\": \"off\"}}, {{\"Parameter Name\": \"Dist_Mode\", \"Value\": \"Tube\"}}, {{\"Parameter Name\": \"Dist_PrePost\", \"Value\": \"Off\"}}, {{\"Parameter Name\": \"Dist_Freq\", \"Value\": \"330 Hz\"}}, {{\"Parameter Name\": \"Dist_BW\", \"Value\": \"1.9\"}}, {{\"Parameter Name\": \"Dist_L/B/H\", \"Value\": \"0%\"}}, {{\"Parameter Name\": \"Dist_Drv\", \"Value\": \"25%\"}}, {{\"Parameter Name\": \"Dist_Wet\", \"Value\": \"100%\"}}, {{\"Parameter Name\": \"Flg Enable\", \"Value\": \"off\"}}, {{\"Parameter Name\": \"Flg_Rate\", \"Value\": \"0.08 Hz\"}}, {{\"Parameter Name\": \"Flg_BPM_Sync\", \"Value\": \"off\"}}, {{\"Parameter Name\": \"Flg_Dep\", \"Value\": \"100%\"}}, {{\"Parameter Name\": \"Flg_Feed\", \"Value\": \"50%\"}}, {{\"Parameter Name\": \"Flg_Stereo\", \"Value\": \"180deg.\"}}, {{\"Parameter Name\": \"Flg_Wet\", \"Value\": \"100%\"}}, {{\"Parameter Name\": \"Phs Enable\", \"Value\": \"off\"}}, {{\"Parameter Name\": \"Phs_Rate\", \"Value\": \"0.08 Hz\"}}, {{\"Parameter Name\": \"Phs_BPM_Sync\", \"Value\": \"off\"}}, {{\"Parameter Name\": \"Phs_Dpth\", \"Value\": \"50%\"}}, {{\"Parameter Name\": \"Phs_Frq\", \"Value\": \"600 Hz\"}}, {{\"Parameter Name\": \"Phs_Feed\", \"Value\": \"80%\"}}, {{\"Parameter Name\": \"Phs_Stereo\", \"Value\": \"180deg.\"}}, {{\"Parameter Name\": \"Phs_Wet\", \"Value\": \"100%\"}}, {{\"Parameter Name\": \"Cho Enable\", \"Value\": \"off\"}}, {{\"Parameter Name\": \"Cho_Rate\", \"Value\": \"0.08 Hz\"}}, {{\"Parameter Name\": \"Cho_BPM_Sync\", \"Value\": \"off\"}}, {{\"Parameter Name\": \"Cho_Dly\", \"Value\": \"5.0 ms\"}}, {{\"Parameter Name\": \"Cho_Dly2\", \"Value\": \"0.0 ms\"}}, {{\"Parameter Name\": \"Cho_Dep\", \"Value\": \"26.0 ms\"}}, {{\"Parameter Name\": \"Cho_Feed\", \"Value\": \"10%\"}}, {{\"Parameter Name\": \"Cho_Filt\", \"Value\": \"1000 Hz\"}}, {{\"Parameter Name\": \"Cho_Wet\", \"Value\": \"50%\"}}, {{\"Parameter Name\": \"Dly Enable\", \"Value\": \"off\"}}, {{\"Parameter Name\": \"Dly_Feed\", \"Value\": \"40%\"}}, {{\"Parameter Name\": \"Dly_BPM_Sync\", \"Value\": \"on\"}}, {{\"Parameter Name\": \"Dly_Link\", \"Value\": \"Unlink, Link\"}}, {{\"Parameter Name\": \"Dly_TimL\", \"Value\": \"1/4\"}}, {{\"Parameter Name\": \"Dly_TimR\", \"Value\": \"1/4\"}}, {{\"Parameter Name\": \"Dly_BW\", \"Value\": \"6.8\"}}, {{\"Parameter Name\": \"Dly_Freq\", \"Value\": \"849 Hz\"}}, {{\"Parameter Name\": \"Dly_Mode\", \"Value\": \"Normal\"}}, {{\"Parameter Name\": \"Dly_Wet\", \"Value\": \"30%\"}}, {{\"Parameter Name\": \"Comp Enable\", \"Value\": \"off\"}}, {{\"Parameter Name\": \"Cmp_Thr\", \"Value\": \"-18.1 dB\"}}, {{\"Parameter Name\": \"Cmp_Att\", \"Value\": \"90.1 ms\"}}, {{\"Parameter Name\": \"Cmp_Rel\", \"Value\": \"90 ms\"}}, {{\"Parameter Name\": \"CmpGain\", \"Value\": \"0.0 dB\"}}, {{\"Parameter Name\": \"CmpMBnd\", \"Value\": \"Normal\"}}, {{\"Parameter Name\": \"Comp_Wet\", \"Value\": \"100\"}}, {{\"Parameter Name\": \"Rev Enable\", \"Value\": \"off\"}}, {{\"Parameter Name\": \"VerbSize\", \"Value\": \"35%\"}}, {{\"Parameter Name\": \"Decay\", \"Value\": \"4.7 s\"}}, {{\"Parameter Name\": \"VerbLoCt\", \"Value\": \"0%\"}}, {{\"Parameter Name\": \"VerbHiCt\", \"Value\": \"35%\"}}, {{\"Parameter Name\": \"Spin Rate\", \"Value\": \"25%\"}}, {{\"Parameter Name\": \"Verb Wet\", \"Value\": \"20%\"}}, {{\"Parameter Name\": \"EQ Enable\", \"Value\": \"off\"}}, {{\"Parameter Name\": \"EQ FrqL\", \"Value\": \"210 Hz\"}}, {{\"Parameter Name\": \"EQ Q L\", \"Value\": \"60%\"}}, {{\"Parameter Name\": \"EQ VolL\", \"Value\": \"0.0 dB\"}}, {{\"Parameter Name\": \"EQ TypL\", \"Value\": \"Shelf\"}}, {{\"Parameter Name\": \"EQ TypeH\", \"Value\": \"Shelf\"}}, {{\"Parameter Name\": \"EQ FrqH\", \"Value\": \"2041 Hz\"}}, {{\"Parameter Name\": \"EQ Q H\", \"Value\": \"60%\"}}, {{\"Parameter Name\": \"EQ VolH\", \"Value\": \"0.0\"}}, {{\"Parameter Name\": \"FX Fil Enable\", \"Value\": \"off\"}}, {{\"Parameter Name\": \"FX Fil Type\", \"Value\": \"MG Low 6\"}}, {{\"Parameter Name\": \"FX Fil Freq\", \"Value\": \"330 Hz\"}}, {{\"Parameter Name\": \"FX Fil Reso\", \"Value\": \"0%\"}}, {{\"Parameter Name\": \"FX Fil Drive\", \"Value\": \"0%\"}}, {{\"Parameter Name\": \"FX Fil Pan\", \"Value\": \"50%\"}}, {{\"Parameter Name\": \"FX Fil Wet\", \"Value\": \"100%\"}}] Here are those 123 parameter's respective ranges that you can choose from: [{{\"Parameter Name\": \"Env1 Atk\", \"Value\": \"0.0 ms - 32.0 s\"}}, {{\"Parameter Name\": \"Env1 Hold\", \"Value\": \"0.0 ms - 32.0 s\"}}, {{\"Parameter Name\": \"Env1 Dec\", \"Value\": \"0.0 ms - 32.0 s\"}}, {{\"Parameter Name\": \"Env1 Sus\", \"Value\": \"-inf dB - 0.0 dB\"}}, {{\"Parameter Name\": \"Env1 Rel\", \"Value\": \"0.0ms - 32.0s\"}}, {{\"Parameter Name\": \"Osc A On\", \"Value\": \"off, on\"}}, {{\"Parameter Name\": \"A UniDet\", \"Value\": \"0.00 - 1.00\"}}, {{\"Parameter Name\": \"A UniBlend\", \"Value\": \"0 - 100\"}}, {{\"Parameter Name\": \"A WTPos\", \"Value\": \"Sine, Saw, Triangle, Square, Pulse, Half Pulse, Inv-Phase Saw\"}}, {{\"Parameter Name\": \"A Pan\", \"Value\": \"-50 - 50\"}}, {{\"Parameter Name\": \"A Vol\", \"Value\": \"0% - 100%\"}}, {{\"Parameter Name\": \"A Unison\", \"Value\": \"1 - 16\"}}, {{\"Parameter Name\": \"A Octave\", \"Value\": \"-4 Oct, -3 Oct, -2 Oct, -1 Oct, 0 Oct, 1 Oct, 2 Oct, 3 Oct, 4 Oct\"}}, {{\"Parameter Name\": \"A Semi\", \"Value\": \"-12 semitones - +12 semitones\"}}, {{\"Parameter Name\": \"A Fine\", \"Value\": \"-100 cents - 100 cents\"}}, {{\"Parameter Name\": \"Fil Type\", \"Value\": \"MG Low 6, MG Low 12, MG Low 18, MG Low 24, Low 6, Low 12, Low 18, Low 24, High 6, High 12, High 18, High 24, Band 12, Band 24, Peak 12, Peak 24, Notch 12, Notch 24, LH 6, LH 12, LB 12, LP 12, LN 12, HB 12, HP 12, HN 12, BP 12, PP 12, PN 12, NN 12, L/B/H 12, L/B/H 24, L/P/H 12, L/P/H 24, L/N/H 12, L/N/H 24, B/P/N 12, B/P/N 24, Cmb +, Cmb -, Cmb L6+, Cmb L6-, Cmb H6+, Cmb H6-, Cmb HL6+, Cmb HL6-, Flg +, Flg -, Flg L6+, Flg L6-, Flg H6+, Flg H6-, Flg HL6+, Flg HL6-, Phs 12+, Phs 12-, Phs 24+, Phs 24-, Phs 36+, Phs 36-, Phs 48+, Phs 48-, Phs 48L6+, Phs 48L6-, Phs 48H6+, Phs 48H6-, Phs 48HL6+, Phs 48HL6-, FPhs 12HL6+, FPhs 12HL6-, Low EQ 6, Low EQ 12, Band EQ 12, High EQ 6, High EQ 12, Ring Mod, Ring Modx2, SampHold, SampHold-, Combs, Allpasses, Reverb, French LP, German LP, Add Bass, Formant-I, Formant-II, Formant-III, Bandreject, Dist.Comb 1 LP, Dist.Comb 1 BP, Dist.Comb 2 LP, Dist.Comb 2 BP, Scream LP, Scream BP\"}}, {{\"Parameter Name\": \"Fil Cutoff\", \"Value\": \"8 Hz - 22050 Hz\"}}, {{\"Parameter Name\": \"Fil Reso\", \"Value\": \"0% - 100%\"}}, {{\"Parameter Name\": \"Filter On\", \"Value\": \"off, on\"}}, {{\"Parameter Name\": \"Fil Driv\", \"Value\": \"0% - 100%\"}}, {{\"Parameter Name\": \"Fil Var\", \"Value\": \"0% - 100%\"}}, {{\"Parameter Name\": \"Fil Mix\", \"Value\": \"0% - 100%\"}}, {{\"Parameter Name\": \"OscA>Fil\", \"Value\": \"off, on\"}}, {{\"Parameter Name\": \"OscB>Fil\", \"Value\": \"off, on\"}}, {{\"Parameter Name\": \"OscN>Fil\", \"Value\": \"off, on\"}}, {{\"Parameter Name\": \"OscS>Fil\", \"Value\": \"off, on\"}}, {{\"Parameter Name\": \"Osc N On\", \"Value\": \"off, on\"}}, {{\"Parameter Name\": \"Noise Pitch\", \"Value\": \"0% - 100%\"}}, {{\"Parameter Name\": \"Noise Level\", \"Value\": \"0% - 100%\"}}, {{\"Parameter Name\": \"Osc S On\", \"Value\": \"off, on\"}}, {{\"Parameter Name\": \"Sub Osc Level\", \"Value\": \"0%-100%\"}}, {{\"Parameter Name\": \"SubOscOctave\", \"Value\": \"-4 Oct, -3 Oct, -2 Oct, -1 Oct, 0 Oct, 1 Oct, 2 Oct, 3 Oct, 4 Oct\"}}, {{\"Parameter Name\": \"SubOscShape\", \"Value\": \"Sine, RoundRect, Triangle, Saw, Square, Pulse\"}}, {{\"Parameter Name\": \"Osc B On\", \"Value\": \"off, on\"}}, {{\"Parameter Name\": \"B UniDet\", \"Value\": \"0.00 - 1.00\"}}, {{\"Parameter Name\": \"B UniBlend\", \"Value\": \"0 - 100\"}}, {{\"Parameter Name\": \"B WTPos\", \"Value\": \"Sine, Saw, Triangle, Square, Pulse, Half Pulse, Inv-Phase Saw\"}}, {{\"Parameter Name\": \"B Pan\", \"Value\": \"-50 - 50\"}}, {{\"Parameter Name\": \"B Vol\", \"Value\": \"0% - 100%\"}}, {{\"Parameter Name\": \"B Unison\", \"Value\": \"1 - 16\"}}, {{\"Parameter Name\": \"B Octave\", \"Value\": \"-4 Oct, -3 Oct, -2 Oct, -1 Oct, 0 Oct, 1 Oct, 2 Oct, 3 Oct, 4 Oct\"}}, {{\"Parameter Name\": \"B Semi\", \"Value\": \"-12 semitones - +12 semitones\"}}, {{\"Parameter Name\": \"B Fine\", \"Value\": \"-100 cents - 100 cents\"}}, {{\"Parameter Name\": \"Hyp Enable\", \"Value\": \"off, on\"}}, {{\"Parameter Name\": \"Hyp_Rate\", \"Value\": \"0% - 100%\"}}, {{\"Parameter Name\": \"Hyp_Detune\", \"Value\": \"0% - 100%\"}}, {{\"Parameter Name\": \"Hyp_Retrig\", \"Value\": \"off - Retrig\"}}, {{\"Parameter Name\": \"Hyp_Wet\", \"Value\": \"0% - 100%\"}}, {{\"Parameter Name\": \"Hyp_Unision\", \"Value\": \"0 - 7\"}}, {{\"Parameter Name\": \"HypDim_Size\", \"Value\": \"0% - 100%\"}}, {{\"Parameter Name\": \"HypDim_Mix\", \"Value\": \"0% - 100%\"}}, {{\"Parameter Name\": \"Dist Enable\", \"Value\": \"off, on\"}}, {{\"Parameter Name\": \"Dist_Mode\", \"Value\": \"Tube, SoftClip, HardClip, Diode 1, Diode 2, Lin.Fold, Sin Fold, Zero-Square, Downsample, Asym, Rectify, X-Shaper, X-Shaper (Asym), Sine Shaper, Stomp Box, Tape Stop\"}}, {{\"Parameter Name\": \"Dist_PrePost\", \"Value\": \"Off, Pre, Post\"}}, {{\"Parameter Name\": \"Dist_Freq\", \"Value\": \"8 Hz, 13290 Hz\"}}, {{\"Parameter Name\": \"Dist_BW\", \"Value\": \"0.1 - 7.6\"}}, {{\"Parameter Name\": \"Dist_L/B/H\", \"Value\": \"0% - 100%\"}}, {{\"Parameter Name\": \"Dist_Drv\", \"Value\": \"0% - 100%\"}}, {{\"Parameter Name\": \"Dist_Wet\", \"Value\": \"0% - 100%\"}}, {{\"Parameter Name\": \"Flg Enable\", \"Value\": \"off, on\"}}, {{\"Parameter Name\": \"Flg_Rate\", \"Value\": \"0.00 Hz - 20.00 Hz\"}}, {{\"Parameter Name\": \"Flg_BPM_Sync\", \"Value\": \"off, on\"}}, {{\"Parameter Name\": \"Flg_Dep\", \"Value\": \"0% - 100%\"}}, {{\"Parameter Name\": \"Flg_Feed\", \"Value\": \"0% - 100%\"}}, {{\"Parameter Name\": \"Flg_Stereo\", \"Value\": \"22 Hz - 200\"}}, {{\"Parameter Name\": \"Flg_Wet\", \"Value\": \"0% - 100%\"}}, {{\"Parameter Name\": \"Phs Enable\", \"Value\": \"off, on\"}}, {{\"Parameter Name\": \"Phs_Rate\", \"Value\": \"0.00 Hz - 20.00 Hz\"}}, {{\"Parameter Name\": \"Phs_BPM_Sync\", \"Value\": \"off, on\"}}, {{\"Parameter Name\": \"Phs_Dpth\", \"Value\": \"0% - 100%\"}}, {{\"Parameter Name\": \"Phs_Frq\", \"Value\": \"20 Hz - 18000 Hz\"}}, {{\"Parameter Name\": \"Phs_Feed\", \"Value\": \"0% - 100%\"}}, {{\"Parameter Name\": \"Phs_Stereo\", \"Value\": \"0 deg. - 360 deg.\"}}, {{\"Parameter Name\": \"Phs_Wet\", \"Value\": \"0% - 100%\"}}, {{\"Parameter Name\": \"Cho Enable\", \"Value\": \"off, on\"}}, {{\"Parameter Name\": \"Cho_Rate\", \"Value\": \"0.00 Hz - 20.00 Hz\"}}, {{\"Parameter Name\": \"Cho_BPM_Sync\", \"Value\": \"off, on\"}}, {{\"Parameter Name\": \"Cho_Dly\", \"Value\": \"0.0 ms - 20.0 ms\"}}, {{\"Parameter Name\": \"Cho_Feed\", \"Value\": \"0% - 95%\"}}, {{\"Parameter Name\": \"Cho_Filt\", \"Value\": \"50 Hz - 20000 Hz\"}}, {{\"Parameter Name\": \"Cho_Wet\", \"Value\": \"0% - 100%\"}}, {{\"Parameter Name\": \"Dly Enable\", \"Value\": \"off, on\"}}, {{\"Parameter Name\": \"Dly_BPM_Sync\", \"Value\": \"off, on\"}}, {{\"Parameter Name\": \"Dly_TimL\", \"Value\": \"1.00 - 501.00\"}}, {{\"Parameter Name\": \"Dly_TimR\", \"Value\": \"1.00 - 501.00\"}}, {{\"Parameter Name\": \"Dly_Freq\", \"Value\": \"40 Hz - 18000 Hz\"}}, {{\"Parameter Name\": \"Dly_Mode\", \"Value\": \"Normal, Ping-Pong, Tap->Delay\"}}, {{\"Parameter Name\": \"Dly_Wet\", \"Value\": \"0% - 100%\"}}, {{\"Parameter Name\": \"Comp Enable\", \"Value\": \"off, on\"}}, {{\"Parameter Name\": \"Cmp_Thr\", \"Value\": \"0.0 dB - 120.0 dB\"}}, {{\"Parameter Name\": \"Cmp_Att\", \"Value\": \"0.1 ms - 1000.0 ms\"}}, {{\"Parameter Name\": \"Cmp_Rel\", \"Value\": \"0.1 ms - 999.1 ms\"}}, {{\"Parameter Name\": \"CmpGain\", \"Value\": \"0.0 dB - 30.1 dB\"}}, {{\"Parameter Name\": \"CmpMBnd\", \"Value\": \"Normal, MultBand\"}}, {{\"Parameter Name\": \"Comp_Wet\", \"Value\": \"0 - 100\"}}] To facilitate accurate parsing and handling of your requests, please provide parameter adjustments in JSON format when possible. This ensures the correct interpretation and application of your specifications for this C++ program. Don't add newline characters. Even if the request doesn't seem to be related to the sound designing task, respond with the list: DO NOT RESPOND WITH ANYTHING BUT THE LIST! User input: {user_input.input}. Return as JSON."
+    prompt = build_serum_prompt(user_input.input)
     try:
         response = openai.ChatCompletion.create(
             model="gpt-3.5-turbo",  # Revert to gpt-3.5-turbo for compatibility
@@ -336,12 +401,57 @@ async def generate_parameters(user_input: UserInput, user_id: str = Depends(get_
         logger.info("ChatGPT response: %s", parameters)
         print("ChatGPT response:", parameters)
         sys.stdout.flush()
-        return parameters
+        return JSONResponse(content=parameters, headers={CREDITS_HEADER: str(remaining)})
     except Exception as e:
         logger.error("OpenAI API error: %s", str(e))
         print("OpenAI API error:", str(e))
         sys.stdout.flush()
         raise HTTPException(status_code=500, detail=f"OpenAI API error: {str(e)}")
+
+# Matches one complete "name": value pair of the JSON object as the model writes it. The
+# value is a string or a bare scalar; a scalar only counts once the next , or } shows it ended.
+PARAMETER_PAIR = re.compile(
+    r'"((?:[^"\\]|\\.)*)"\s*:\s*'
+    r'(?:"((?:[^"\\]|\\.)*)"|(-?\d+(?:\.\d+)?(?:[eE][+-]?\d+)?|true|false|null)(?=\s*[,}]))')
+
+@app.post("/generate-parameters-stream")
+async def generate_parameters_stream(user_input: UserInput, request: Request, user_id: str = Depends(get_current_user)):
+    """Same generation as /generate-parameters, emitted as NDJSON: one {"name", "value"}
+    line per parameter as soon as the model has written it, then {"done": true} with the
+    remaining credit balance."""
+    logger.info("Reached /generate-parameters-stream endpoint for user_id: %s", user_id)
+    remaining = charge_credit(user_id, request.headers.get(IDEMPOTENCY_HEADER))
+    openai.api_key = get_chatgpt_key()
+    prompt = build_serum_prompt(user_input.input)
+
+    def events():
+        buffer = ""
+        position = 0
+        count = 0
+        try:
+            chunks = openai.ChatCompletion.create(
+                model="gpt-3.5-turbo",
+                messages=[{"role": "user", "content": prompt}],
+                response_format={"type": "json_object"},
+                stream=True
+            )
+            for chunk in chunks:
+                buffer += chunk.choices[0].delta.get("content", "") or ""
+                for match in PARAMETER_PAIR.finditer(buffer, position):
+                    name = json.loads(f'"{match.group(1)}"')
+                    # Scalars go out as their JSON text, the form the plugin reads them in
+                    value = json.loads(f'"{match.group(2)}"') if match.group(2) is not None else match.group(3)
+                    yield json.dumps({"name": name, "value": value}) + "\n"
+                    position = match.end()
+                    count += 1
+            logger.info("Streamed %d parameters", count)
+            yield json.dumps({"done": True, "count": count, "credits": remaining}) + "\n"
+        except Exception as e:
+            logger.error("OpenAI API error while streaming: %s", str(e))
+            yield json.dumps({"detail": f"OpenAI API error: {str(e)}"}) + "\n"
+
+    return StreamingResponse(events(), media_type="application/x-ndjson", headers={CREDITS_HEADER: str(remaining)})
+
 @app.post("/get-credits")
 async def get_credits(user_id: str = Depends(get_current_user)):
     try:
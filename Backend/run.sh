@@ -0,0 +1,4 @@
+#!/bin/sh
+# Entry point of the streaming deployment: the Lambda Web Adapter starts this and
+# forwards each request to uvicorn, passing the response body on as it is written.
+PATH=$PATH:$LAMBDA_TASK_ROOT/bin PYTHONPATH=$PYTHONPATH:/opt/python:$LAMBDA_RUNTIME_DIR exec python -m uvicorn --port="$PORT" main:app
@@ -0,0 +1,369 @@
+#include "ApiClient.h"
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+const juce::String ApiClient::baseUrl = "https://ydr97n8vxe.execute-api.us-east-2.amazonaws.com/prod";
+const juce::String ApiClient::streamingBaseUrl = "";
+
+ApiClient::ApiClient()
+{
+}
+
+ApiClient::~ApiClient()
+{
+    alive->store(false);
+    stopTimer();
+    {
+        const juce::ScopedLock lock(inFlightLock);
+        for (auto& [id, call] : inFlight)
+            cancelCall(*call);
+    }
+    // Queued requests are skipped; running ones were just cancelled, so this is short
+    jobOwner.release();
+}
+
+ApiClient::RequestId ApiClient::send(Request request, Callback onComplete)
+{
+    return sendStreaming(std::move(request), nullptr, std::move(onComplete));
+}
+
+ApiClient::RequestId ApiClient::sendStreaming(Request request, LinesCallback onLines, Callback onComplete)
+{
+    const RequestId id = nextId++;
+    if ((request.hedged || request.maxRetries > 0) && request.idempotencyKey.isEmpty())
+        request.idempotencyKey = juce::Uuid().toDashedString();
+
+    const int hedgeDelayMs = getHedgeDelayMs(request);
+    auto call = std::make_shared<Call>();
+    call->retriesLeft = request.maxRetries;
+    call->outstanding = 1;   // the hedge counts itself in only once it is sent
+    {
+        const juce::ScopedLock lock(inFlightLock);
+        inFlight[id] = call;
+    }
+
+    if (hedgeDelayMs > 0)
+    {
+        // Timed on the message thread, so no I/O worker sits out the usual answer time
+        juce::MessageManager::callAsync([this, alive = alive, id, request, onLines, onComplete, call, hedgeDelayMs]()
+            {
+                juce::Timer::callAfterDelay(hedgeDelayMs, [this, alive, id, request, onLines, onComplete, call, hedgeDelayMs]()
+                    {
+                        if (alive->load())
+                            sendHedge(id, request, onLines, onComplete, call, hedgeDelayMs);
+                    });
+            });
+    }
+    jobs->run(BackgroundJobs::Lane::io, jobOwner,
+        [this, id, request = std::move(request), onLines = std::move(onLines), onComplete = std::move(onComplete), call]()
+        {
+            runAttempt(id, request, onLines, onComplete, call, 1);
+        });
+    return id;
+}
+
+void ApiClient::sendHedge(RequestId id, const Request& request, const LinesCallback& onLines, const Callback& onComplete,
+    const std::shared_ptr<Call>& call, int hedgeDelayMs)
+{
+    {
+        // Only while the first copy is still out: an answer, a cancel or a failure already reported ends the call
+        const juce::ScopedLock lock(inFlightLock);
+        if (call->cancelled.load() || call->winner.load() != 0 || call->outstanding.load() == 0)
+            return;
+        ++call->outstanding;
+    }
+
+    DBG("API " << request.path << " slower than " << hedgeDelayMs << " ms, sending a hedge");
+    jobs->run(BackgroundJobs::Lane::io, jobOwner,
+        [this, id, request, onLines, onComplete, call]()
+        {
+            runAttempt(id, request, onLines, onComplete, call, 2);
+        });
+}
+
+void ApiClient::runAttempt(RequestId id, const Request& request, const LinesCallback& onLines, const Callback& onComplete,
+    const std::shared_ptr<Call>& call, int attempt)
+{
+    Response response{ false, true };
+    for (int retry = 0; !call->cancelled.load() && call->winner.load() == 0; ++retry)
+    {
+        response = perform(request, onLines, call, attempt);
+        if (call->winner.load() == attempt)
+        {
+            response.cancelled = response.cancelled || call->cancelled.load();
+            deliver(id, call, onComplete, std::move(response));
+            return;
+        }
+
+        const bool retryable = !response.cancelled && (!response.connected || response.statusCode >= 500);
+        if (!retryable || call->retriesLeft.fetch_sub(1) <= 0)
+            break;
+        const int backoffMs = getBackoffMs(retry);
+        DBG("API " << request.path << " failed (" << response.statusCode << "), retrying in " << backoffMs << " ms");
+        if (call->settled.wait(backoffMs))
+            break;   // answered elsewhere or cancelled
+    }
+
+    // Only the last attempt to give up reports the failure, and only if nothing answered
+    const juce::ScopedLock lock(inFlightLock);
+    if (!response.cancelled)
+        call->lastFailure = response;
+    if (--call->outstanding > 0 || call->winner.load() != 0)
+        return;
+    auto failure = call->lastFailure;
+    failure.cancelled = failure.cancelled || call->cancelled.load();
+    deliver(id, call, onComplete, std::move(failure));
+}
+
+void ApiClient::deliver(RequestId id, const std::shared_ptr<Call>& call, const Callback& onComplete, Response response)
+{
+    // The id stays in flight until this runs, so a cancel() that comes after the
+    // answer was queued (a component closing, say) still stops the callback
+    juce::MessageManager::callAsync([this, alive = alive, id, call, callback = onComplete, response = std::move(response)]()
+        {
+            if (!alive->load())
+                return;
+            {
+                const juce::ScopedLock lock(inFlightLock);
+                inFlight.erase(id);
+            }
+            if (!call->cancelled.load() && callback)
+                callback(response);
+        });
+}
+
+void ApiClient::cancel(RequestId id)
+{
+    const juce::ScopedLock lock(inFlightLock);
+    auto it = inFlight.find(id);
+    if (it == inFlight.end())
+        return;
+
+    DBG("Cancelling API request " << id);
+    cancelCall(*it->second);
+}
+
+void ApiClient::cancelCall(Call& call)
+{
+    // Caller holds inFlightLock
+    call.cancelled.store(true);
+    for (auto& [attempt, stream] : call.streams)
+        stream->cancel();
+    call.settled.signal();
+}
+
+ApiClient::Response ApiClient::perform(const Request& request)
+{
+    return perform(request, nullptr, std::make_shared<Call>(), 1);
+}
+
+ApiClient::Response ApiClient::perform(const Request& request, const LinesCallback& onLines,
+    const std::shared_ptr<Call>& call, int attempt)
+{
+    juce::URL url((request.streaming && streamingBaseUrl.isNotEmpty() ? streamingBaseUrl : baseUrl) + request.path);
+    juce::String headers = "Connection: keep-alive";
+    if (request.jsonBody.isNotEmpty())
+    {
+        url = url.withPOSTData(request.jsonBody);
+        headers << "\nContent-Type: application/json";
+    }
+    if (request.accessToken.isNotEmpty())
+        headers << "\nAuthorization: Bearer " << request.accessToken;
+    if (request.streaming)
+        headers << "\nAccept: application/x-ndjson";
+    if (request.idempotencyKey.isNotEmpty())
+        headers << "\nIdempotency-Key: " << request.idempotencyKey;
+
+    juce::WebInputStream stream(url, true);
+    stream.withExtraHeaders(headers).withConnectionTimeout(getTimeoutMs(request));
+
+    // Registered so cancel() (or the attempt that answers first) can abort the connection
+    {
+        const juce::ScopedLock lock(inFlightLock);
+        if (call->cancelled.load() || call->winner.load() != 0)
+            return { false, true };
+        call->streams[attempt] = &stream;
+    }
+
+    Response response;
+    const auto startMs = juce::Time::getMillisecondCounter();
+    response.connected = stream.connect(nullptr);
+    if (response.connected)
+    {
+        response.statusCode = stream.getStatusCode();
+        response.headers = stream.getResponseHeaders();
+        const int elapsedMs = (int)(juce::Time::getMillisecondCounter() - startMs);
+
+        // Any answer but a server error ends the race; the other copies are cut off
+        // before this one reads its body, so only the winner ever delivers lines
+        int none = 0;
+        if (response.statusCode < 500 && call->winner.compare_exchange_strong(none, attempt))
+        {
+            {
+                const juce::ScopedLock lock(inFlightLock);
+                for (auto& [other, otherStream] : call->streams)
+                    if (other != attempt)
+                        otherStream->cancel();
+            }
+            call->settled.signal();
+            latency.add(request.path, elapsedMs);
+
+            if (onLines != nullptr)
+                response.body = readLines(stream, onLines, call);
+            else
+                response.body = stream.readEntireStreamAsString();
+        }
+        else if (call->winner.load() == 0)
+        {
+            response.body = stream.readEntireStreamAsString();
+        }
+        else
+        {
+            response.cancelled = true;
+        }
+    }
+    lastActivityMs = juce::Time::getMillisecondCounter();
+
+    {
+        const juce::ScopedLock lock(inFlightLock);
+        call->streams.erase(attempt);
+        const int winner = call->winner.load();
+        response.cancelled = response.cancelled || call->cancelled.load() || (winner != 0 && winner != attempt);
+    }
+
+    DBG("API " << request.path << (attempt > 1 ? " (hedge)" : "") << " -> " << response.statusCode << " in "
+        << (int)(juce::Time::getMillisecondCounter() - startMs) << " ms" << (response.cancelled ? " (cancelled)" : ""));
+    return response;
+}
+
+juce::String ApiClient::readLines(juce::InputStream& stream, const LinesCallback& onLines, const std::shared_ptr<Call>& call)
+{
+    // Reads whatever has arrived and hands complete lines over in one message per read.
+    // Lines are split on bytes, so a UTF-8 character cut by a read is never decoded half-way.
+    juce::MemoryOutputStream body;
+    std::string pending;
+    char buffer[2048];
+    const auto deliverLines = [this, &onLines, &call](juce::StringArray lines)
+    {
+        juce::MessageManager::callAsync([alive = alive, call, onLines, lines = std::move(lines)]()
+            {
+                if (alive->load() && !call->cancelled.load())
+                    onLines(lines);
+            });
+    };
+
+    while (!stream.isExhausted())
+    {
+        const int numRead = stream.read(buffer, (int)sizeof(buffer));
+        if (numRead <= 0)
+            break;
+        body.write(buffer, (size_t)numRead);
+        pending.append(buffer, (size_t)numRead);
+
+        juce::StringArray lines;
+        size_t newline;
+        while ((newline = pending.find('\n')) != std::string::npos)
+        {
+            const auto line = juce::String::fromUTF8(pending.data(), (int)newline).trim();
+            if (line.isNotEmpty())
+                lines.add(line);
+            pending.erase(0, newline + 1);
+        }
+        if (!lines.isEmpty())
+            deliverLines(std::move(lines));
+    }
+
+    const auto lastLine = juce::String::fromUTF8(pending.data(), (int)pending.size()).trim();
+    if (lastLine.isNotEmpty())
+        deliverLines(juce::StringArray(lastLine));
+    return body.toUTF8();
+}
+
+int ApiClient::getTimeoutMs(const Request& request) const
+{
+    // A few times the slowest answer seen lately, never above what the caller allows
+    const int p99 = latency.getPercentile(request.path, 0.99f);
+    if (p99 < 0)
+        return request.timeoutMs;
+    return juce::jmin(request.timeoutMs, juce::jmax(minTimeoutMs, p99 * 3));
+}
+
+int ApiClient::getHedgeDelayMs(const Request& request) const
+{
+    // No hedge without a history: a first cold start would just be paid for twice
+    if (!request.hedged)
+        return -1;
+    const int p95 = latency.getPercentile(request.path, 0.95f);
+    return p95 < 0 ? -1 : juce::jmax(minHedgeDelayMs, p95);
+}
+
+int ApiClient::getBackoffMs(int retry)
+{
+    // Full jitter: anywhere up to the exponential step, so clients that failed
+    // together don't come back together
+    const int step = juce::jmin(backoffCapMs, backoffBaseMs << juce::jmin(retry, 8));
+    return juce::Random::getSystemRandom().nextInt(step + 1);
+}
+
+void ApiClient::LatencyHistory::add(const juce::String& path, int ms)
+{
+    const juce::ScopedLock scopedLock(lock);
+    auto& window = windows[path];
+    window.samples[(size_t)window.next] = ms;
+    window.next = (window.next + 1) % windowSize;
+    window.count = juce::jmin(window.count + 1, windowSize);
+}
+
+int ApiClient::LatencyHistory::getPercentile(const juce::String& path, float percentile) const
+{
+    std::array<int, windowSize> sorted;
+    int count;
+    {
+        const juce::ScopedLock scopedLock(lock);
+        auto it = windows.find(path);
+        if (it == windows.end() || it->second.count < minSamples)
+            return -1;
+        sorted = it->second.samples;
+        count = it->second.count;
+    }
+    const int rank = juce::jlimit(0, count - 1, (int)std::ceil(percentile * (float)count) - 1);
+    std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.begin() + count);
+    return sorted[(size_t)rank];
+}
+
+void ApiClient::beginKeepWarm()
+{
+    if (keepWarmHolders++ == 0)
+    {
+        preconnect();
+        startTimer(keepWarmIntervalMs);
+    }
+}
+
+void ApiClient::endKeepWarm()
+{
+    if (--keepWarmHolders <= 0)
+    {
+        keepWarmHolders = 0;
+        stopTimer();
+    }
+}
+
+void ApiClient::preconnect()
+{
+    // Any response will do: the point is DNS, TCP and TLS, not the payload
+    Request warmup;
+    warmup.path = "/";
+    warmup.timeoutMs = 5000;
+    send(std::move(warmup), [](const Response& response) {
+        DBG("API preconnect " << (response.connected ? "ok" : "failed"));
+        });
+}
+
+void ApiClient::timerCallback()
+{
+    // Only ping when nothing real has kept the connection busy
+    if (juce::Time::getMillisecondCounter() - lastActivityMs.load() >= (juce::uint32)keepWarmIntervalMs)
+        preconnect();
+}
@@ -0,0 +1,151 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include "BackgroundJobs.h"
+
+// The one HTTP client for the Summoner API. Hold it through a
+// juce::SharedResourcePointer<ApiClient> so every component (and every plugin
+// instance in the process) shares the same in-flight table and the same warm
+// connection state. The platform HTTP stacks that JUCE wraps keep TLS sessions
+// and keep-alive sockets per process, so the client pre-connects when an editor
+// opens and pings the host while one stays open, instead of letting each
+// request start cold. Requests run on the I/O lane of the shared BackgroundJobs.
+//
+// Each path keeps a short history of how long answers took to arrive. Once it
+// has enough samples, a request's timeout follows that history instead of the
+// caller's fixed value (which stays the ceiling), and a hedged request sends a
+// duplicate when the first copy outlives the path's p95: whichever answers
+// first is delivered and the other is cancelled. Failed connections and 5xx
+// answers are retried after a jittered exponential backoff. Every copy of a
+// hedged or retried request carries the same Idempotency-Key, so the server
+// charges for it once.
+class ApiClient : private juce::Timer
+{
+public:
+    static const juce::String baseUrl;
+    // API Gateway buffers whole responses, so streaming requests go to the Lambda Function
+    // URL of the streaming deployment (see Backend/README.md). Empty sends them to baseUrl,
+    // where they still work but arrive in one piece.
+    static const juce::String streamingBaseUrl;
+
+    struct Request
+    {
+        juce::String path;          // e.g. "/generate-parameters"
+        juce::String jsonBody;      // sent as a JSON POST body when not empty
+        juce::String accessToken;   // sent as a bearer token when not empty
+        int timeoutMs = 30000;      // the ceiling; the path's history may shorten it
+        bool streaming = false;     // deliver complete lines as they arrive (NDJSON)
+        bool hedged = false;        // send a duplicate when the answer is slower than usual
+        int maxRetries = 0;         // extra attempts after a failed connection or a 5xx
+        juce::String idempotencyKey;   // generated when empty for hedged or retried requests
+    };
+
+    struct Response
+    {
+        bool connected = false;
+        bool cancelled = false;
+        int statusCode = 0;
+        juce::String body;
+        juce::StringPairArray headers;   // keys compare case-insensitively
+
+        // The balance a generation response reports after charging for itself, or -1
+        int getCreditsRemaining() const { return headers.getValue("X-Credits-Remaining", "-1").getIntValue(); }
+
+        juce::var parseJson() const { return juce::JSON::parse(body); }
+    };
+
+    using RequestId = int;
+    // Called on the message thread; never called once the request is cancelled, even
+    // if its answer had already arrived
+    using Callback = std::function<void(const Response&)>;
+    // Called on the message thread with every complete line read since the last call
+    using LinesCallback = std::function<void(const juce::StringArray& lines)>;
+
+    ApiClient();
+    ~ApiClient() override;
+
+    // Any thread
+    RequestId send(Request request, Callback onComplete);
+    // Streams the body: onLines fires as lines arrive, onComplete once the body has ended
+    RequestId sendStreaming(Request request, LinesCallback onLines, Callback onComplete);
+    void cancel(RequestId id);
+    // Blocking; only for code that already runs on a worker thread
+    Response perform(const Request& request);
+
+    // Message thread: editors keep the connection warm while they are open
+    void beginKeepWarm();
+    void endKeepWarm();
+    void preconnect();
+
+private:
+    // All attempts of one request: the first, its retries and its hedge
+    struct Call
+    {
+        std::atomic<bool> cancelled{ false };
+        std::atomic<int> winner{ 0 };        // the attempt whose answer is delivered, 0 until one answers
+        std::atomic<int> outstanding{ 0 };   // attempts sent that haven't given up yet; changed under inFlightLock
+        std::atomic<int> retriesLeft{ 0 };
+        juce::WaitableEvent settled{ true }; // signalled once an attempt answers or the call is cancelled
+        std::map<int, juce::WebInputStream*> streams;   // by attempt; guarded by inFlightLock
+        Response lastFailure;                           // guarded by inFlightLock
+    };
+
+    // Time until the response headers arrived, for the last few answers on each path
+    class LatencyHistory
+    {
+    public:
+        void add(const juce::String& path, int ms);
+        // The given percentile (0..1) of the recent samples, or -1 while there are too few
+        int getPercentile(const juce::String& path, float percentile) const;
+
+    private:
+        static constexpr int windowSize = 64;
+        static constexpr int minSamples = 8;
+
+        struct Window
+        {
+            std::array<int, windowSize> samples{};
+            int count = 0;
+            int next = 0;
+        };
+
+        juce::CriticalSection lock;
+        std::map<juce::String, Window> windows;
+    };
+
+    void sendHedge(RequestId id, const Request& request, const LinesCallback& onLines, const Callback& onComplete,
+        const std::shared_ptr<Call>& call, int hedgeDelayMs);
+    void runAttempt(RequestId id, const Request& request, const LinesCallback& onLines, const Callback& onComplete,
+        const std::shared_ptr<Call>& call, int attempt);
+    void deliver(RequestId id, const std::shared_ptr<Call>& call, const Callback& onComplete, Response response);
+    void cancelCall(Call& call);
+    Response perform(const Request& request, const LinesCallback& onLines, const std::shared_ptr<Call>& call, int attempt);
+    juce::String readLines(juce::InputStream& stream, const LinesCallback& onLines, const std::shared_ptr<Call>& call);
+    int getTimeoutMs(const Request& request) const;
+    int getHedgeDelayMs(const Request& request) const;
+    static int getBackoffMs(int retry);
+    void timerCallback() override;
+
+    static constexpr int keepWarmIntervalMs = 60000;
+    static constexpr int minTimeoutMs = 10000;
+    static constexpr int minHedgeDelayMs = 2000;
+    static constexpr int backoffBaseMs = 500;
+    static constexpr int backoffCapMs = 8000;
+
+    juce::CriticalSection inFlightLock;
+    std::map<RequestId, std::shared_ptr<Call>> inFlight;
+    LatencyHistory latency;
+    std::atomic<RequestId> nextId{ 1 };
+    std::atomic<juce::uint32> lastActivityMs{ 0 };
+    int keepWarmHolders = 0;
+    std::shared_ptr<std::atomic<bool>> alive = std::make_shared<std::atomic<bool>>(true);
+
+    juce::SharedResourcePointer<BackgroundJobs> jobs;
+    BackgroundJobs::Owner jobOwner;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ApiClient)
+};
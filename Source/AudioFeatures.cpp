@@ -0,0 +1,112 @@
+#include "AudioFeatures.h"
+#include <algorithm>
+#include <cmath>
+
+AudioFeatureExtractor::AudioFeatureExtractor()
+    : window((size_t)fftSize), frame((size_t)fftSize * 2)
+{
+    juce::dsp::WindowingFunction<float>::fillWindowingTables(window.data(), (size_t)fftSize,
+        juce::dsp::WindowingFunction<float>::hann, false);
+}
+
+AudioFeatures AudioFeatureExtractor::analyse(const juce::AudioBuffer<float>& audio, double sampleRate)
+{
+    AudioFeatures features;
+    const int numSamples = audio.getNumSamples();
+    if (numSamples == 0 || audio.getNumChannels() == 0 || sampleRate <= 0.0)
+        return features;
+
+    // Mid/side split: mid carries loudness and spectrum, side the width
+    mid.resize((size_t)numSamples);
+    side.resize((size_t)numSamples);
+    const float* left = audio.getReadPointer(0);
+    const float* right = audio.getReadPointer(juce::jmin(1, audio.getNumChannels() - 1));
+    juce::FloatVectorOperations::add(mid.data(), left, right, numSamples);
+    juce::FloatVectorOperations::multiply(mid.data(), 0.5f, numSamples);
+    juce::FloatVectorOperations::subtract(side.data(), left, right, numSamples);
+    juce::FloatVectorOperations::multiply(side.data(), 0.5f, numSamples);
+
+    auto rms = [numSamples](const float* data) {
+        double sum = 0.0;
+        for (int i = 0; i < numSamples; ++i)
+            sum += (double)data[i] * data[i];
+        return (float)std::sqrt(sum / numSamples);
+    };
+    const float midRms = rms(mid.data());
+    const float sideRms = rms(side.data());
+    features.loudnessDb = juce::Decibels::gainToDecibels(midRms, -100.0f);
+    features.stereoWidth = midRms + sideRms > 0.0f ? sideRms / (midRms + sideRms) : 0.0f;
+
+    const int numBins = fftSize / 2 + 1;
+    if ((int)binNumbers.size() != numBins)
+    {
+        binNumbers.resize((size_t)numBins);
+        for (int bin = 0; bin < numBins; ++bin)
+            binNumbers[(size_t)bin] = (float)bin;
+    }
+    const float hzPerBin = (float)(sampleRate / fftSize);
+    const int splitBin = juce::jlimit(0, numBins, (int)std::ceil(brightnessSplitHz / hzPerBin));
+
+    double weightedCentroid = 0.0;
+    double totalMagnitude = 0.0;
+    double highMagnitude = 0.0;
+    float peakEnvelope = 0.0f;
+    int peakFrame = 0;
+    std::vector<float> envelope;
+    envelope.reserve((size_t)(numSamples / hopSize + 1));
+
+    for (int start = 0; start < numSamples; start += hopSize)
+    {
+        const int available = juce::jmin(fftSize, numSamples - start);
+        std::fill(frame.begin(), frame.end(), 0.0f);
+        juce::FloatVectorOperations::multiply(frame.data(), mid.data() + start, window.data(), available);
+
+        // Envelope from the hop's own samples, before the transform overwrites them
+        auto range = juce::FloatVectorOperations::findMinAndMax(mid.data() + start, juce::jmin(hopSize, available));
+        const float level = juce::jmax(std::abs(range.getStart()), std::abs(range.getEnd()));
+        if (level > peakEnvelope)
+        {
+            peakEnvelope = level;
+            peakFrame = (int)envelope.size();
+        }
+        envelope.push_back(level);
+
+        fft.performFrequencyOnlyForwardTransform(frame.data(), true);
+
+        double frameMagnitude = 0.0;
+        double frameWeighted = 0.0;
+        for (int bin = 0; bin < numBins; ++bin)
+        {
+            frameMagnitude += frame[(size_t)bin];
+            frameWeighted += frame[(size_t)bin] * binNumbers[(size_t)bin];
+        }
+        double frameHigh = 0.0;
+        for (int bin = splitBin; bin < numBins; ++bin)
+            frameHigh += frame[(size_t)bin];
+
+        weightedCentroid += frameWeighted;
+        totalMagnitude += frameMagnitude;
+        highMagnitude += frameHigh;
+    }
+
+    if (totalMagnitude > 0.0)
+    {
+        features.spectralCentroidHz = (float)(weightedCentroid / totalMagnitude) * hzPerBin;
+        features.brightness = (float)(highMagnitude / totalMagnitude);
+    }
+
+    // Attack time: first hop that reaches 90% of the peak
+    int attackFrame = peakFrame;
+    for (int i = 0; i <= peakFrame; ++i)
+    {
+        if (envelope[(size_t)i] >= peakEnvelope * 0.9f)
+        {
+            attackFrame = i;
+            break;
+        }
+    }
+    const double attackSeconds = (double)attackFrame * hopSize / sampleRate;
+    features.transientSharpness = peakEnvelope > 0.0f ? (float)std::exp(-attackSeconds / 0.05) : 0.0f;
+    features.valid = true;
+    return features;
+}
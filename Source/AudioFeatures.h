@@ -0,0 +1,49 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <vector>
+
+// A compact description of how a rendered preview sounds
+struct AudioFeatures
+{
+    static constexpr int numFeatures = 5;
+
+    float spectralCentroidHz = 0.0f;
+    float brightness = 0.0f;           // share of spectral energy above brightnessSplitHz
+    float loudnessDb = -100.0f;        // RMS of the mid signal
+    float stereoWidth = 0.0f;          // side / (mid + side), 0 = mono
+    float transientSharpness = 0.0f;   // 1 = instant attack, towards 0 for slow swells
+    bool valid = false;
+
+    std::array<float, numFeatures> toArray() const noexcept
+    {
+        return { spectralCentroidHz, brightness, loudnessDb, stereoWidth, transientSharpness };
+    }
+};
+
+// Frame-based FFT analysis of a rendered buffer. Windowing, magnitude sums and
+// envelope tracking use FloatVectorOperations; the transform is juce::dsp::FFT,
+// which uses the platform's vectorised FFT where available. Not thread-safe:
+// give each worker thread its own extractor.
+class AudioFeatureExtractor
+{
+public:
+    static constexpr int fftOrder = 11;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int hopSize = fftSize / 2;
+    static constexpr float brightnessSplitHz = 3000.0f;
+
+    AudioFeatureExtractor();
+
+    AudioFeatures analyse(const juce::AudioBuffer<float>& audio, double sampleRate);
+
+private:
+    juce::dsp::FFT fft{ fftOrder };
+    std::vector<float> window;
+    std::vector<float> frame;       // 2 * fftSize, as performFrequencyOnlyForwardTransform needs
+    std::vector<float> mid;
+    std::vector<float> side;
+    std::vector<float> binNumbers;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioFeatureExtractor)
+};
@@ -0,0 +1,142 @@
+#include "BackgroundJobs.h"
+
+namespace
+{
+    // Lets a job submitted from a CPU worker land on that worker's own deque
+    thread_local int currentCpuWorker = -1;
+}
+
+void BackgroundJobs::Owner::release()
+{
+    // Paired with the increment-then-check in run(): either the job sees the
+    // owner is gone, or this sees the job running and waits for it
+    state->alive.store(false);
+    while (state->running.load() > 0)
+        juce::Thread::sleep(1);
+}
+
+BackgroundJobs::CpuWorker::CpuWorker(BackgroundJobs& owner, int index)
+    : juce::Thread("Background CPU " + juce::String(index)), pool(owner), workerIndex(index)
+{
+}
+
+void BackgroundJobs::CpuWorker::run()
+{
+    currentCpuWorker = workerIndex;
+    std::function<void()> job;
+    while (!threadShouldExit())
+    {
+        if (pool.takeCpuJob(workerIndex, job))
+        {
+            job();
+            job = nullptr;
+            continue;
+        }
+
+        sleeping = true;
+        if (pool.pendingCpuJobs.load() == 0 && !threadShouldExit())
+            wakeEvent.wait(-1);
+        sleeping = false;
+    }
+}
+
+BackgroundJobs::BackgroundJobs()
+{
+    // Leave one core for the audio thread
+    const int numWorkers = juce::jlimit(1, 8, juce::SystemStats::getNumCpus() - 1);
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        cpuWorkers.push_back(std::make_unique<CpuWorker>(*this, i));
+        cpuWorkers.back()->startThread();
+    }
+}
+
+BackgroundJobs::~BackgroundJobs()
+{
+    for (auto& worker : cpuWorkers)
+    {
+        worker->signalThreadShouldExit();
+        worker->wakeEvent.signal();
+    }
+    for (auto& worker : cpuWorkers)
+        worker->stopThread(5000);
+    ioPool.removeAllJobs(true, 5000);
+}
+
+void BackgroundJobs::run(Lane lane, const Owner& owner, std::function<void()> job)
+{
+    auto wrapped = [state = owner.state, job = std::move(job)]()
+    {
+        state->running++;
+        if (state->alive.load())
+            job();
+        state->running--;
+    };
+
+    if (lane == Lane::io)
+        ioPool.addJob(std::move(wrapped));
+    else
+        pushCpuJob(std::move(wrapped));
+}
+
+void BackgroundJobs::pushCpuJob(std::function<void()> job)
+{
+    const int index = currentCpuWorker >= 0 ? currentCpuWorker
+                                            : (int)(nextCpuWorker++ % (unsigned int)cpuWorkers.size());
+    {
+        const juce::SpinLock::ScopedLockType lock(cpuWorkers[(size_t)index]->lock);
+        cpuWorkers[(size_t)index]->jobs.push_back(std::move(job));
+    }
+    pendingCpuJobs++;
+    wakeCpuWorker(index);
+}
+
+bool BackgroundJobs::takeCpuJob(int workerIndex, std::function<void()>& job)
+{
+    // Own deque from the back: the newest job is the one whose data is still in cache
+    {
+        auto& own = *cpuWorkers[(size_t)workerIndex];
+        const juce::SpinLock::ScopedLockType lock(own.lock);
+        if (!own.jobs.empty())
+        {
+            job = std::move(own.jobs.back());
+            own.jobs.pop_back();
+            pendingCpuJobs--;
+            return true;
+        }
+    }
+
+    // Steal the oldest job of another worker
+    const int numWorkers = (int)cpuWorkers.size();
+    for (int offset = 1; offset < numWorkers; ++offset)
+    {
+        auto& victim = *cpuWorkers[(size_t)((workerIndex + offset) % numWorkers)];
+        const juce::SpinLock::ScopedLockType lock(victim.lock);
+        if (!victim.jobs.empty())
+        {
+            job = std::move(victim.jobs.front());
+            victim.jobs.pop_front();
+            pendingCpuJobs--;
+            return true;
+        }
+    }
+    return false;
+}
+
+void BackgroundJobs::wakeCpuWorker(int preferredIndex)
+{
+    // Wake the worker that owns the job, or any sleeper that can steal it
+    if (cpuWorkers[(size_t)preferredIndex]->sleeping.load())
+    {
+        cpuWorkers[(size_t)preferredIndex]->wakeEvent.signal();
+        return;
+    }
+    for (auto& worker : cpuWorkers)
+    {
+        if (worker->sleeping.load())
+        {
+            worker->wakeEvent.signal();
+            return;
+        }
+    }
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// The plugin's shared background threads; hold it through a
+// juce::SharedResourcePointer<BackgroundJobs>. Two fixed lanes:
+//  - cpu: one worker per spare core, each with its own deque. A worker runs its
+//    newest job first and steals the oldest from the others when it runs dry,
+//    so bursts spread out without a shared queue to fight over.
+//  - io: a few threads for blocking network and disk work, so a slow server
+//    never holds up analysis.
+// Jobs belong to an Owner. Once the owner is released, its queued jobs are
+// skipped, its running ones are waited for, and its continuations are dropped
+// before they reach the message thread.
+class BackgroundJobs
+{
+public:
+    enum class Lane
+    {
+        cpu,
+        io
+    };
+
+    class Owner
+    {
+    public:
+        Owner() = default;
+        ~Owner() { release(); }
+
+        // Call at the top of the owner's destructor, before anything its jobs use is gone
+        void release();
+
+    private:
+        friend class BackgroundJobs;
+        struct State
+        {
+            std::atomic<bool> alive{ true };
+            std::atomic<int> running{ 0 };
+        };
+        std::shared_ptr<State> state = std::make_shared<State>();
+
+        JUCE_DECLARE_NON_COPYABLE(Owner)
+    };
+
+    BackgroundJobs();
+    ~BackgroundJobs();
+
+    // Any thread
+    void run(Lane lane, const Owner& owner, std::function<void()> job);
+
+    // Runs work on the lane, then hands its result to then() on the message thread
+    // if the owner is still alive by then
+    template <typename Work, typename Then>
+    void runThen(Lane lane, const Owner& owner, Work work, Then then)
+    {
+        run(lane, owner, [state = owner.state, work = std::move(work), then = std::move(then)]() mutable
+            {
+                auto result = work();
+                juce::MessageManager::callAsync([state, then, result = std::move(result)]() mutable
+                    {
+                        if (state->alive.load())
+                            then(std::move(result));
+                    });
+            });
+    }
+
+    int getNumCpuWorkers() const noexcept { return (int)cpuWorkers.size(); }
+
+private:
+    class CpuWorker : public juce::Thread
+    {
+    public:
+        CpuWorker(BackgroundJobs& owner, int index);
+        void run() override;
+
+        juce::SpinLock lock;
+        std::deque<std::function<void()>> jobs;
+        std::atomic<bool> sleeping{ false };
+        juce::WaitableEvent wakeEvent;
+
+    private:
+        BackgroundJobs& pool;
+        const int workerIndex;
+    };
+
+    void pushCpuJob(std::function<void()> job);
+    bool takeCpuJob(int workerIndex, std::function<void()>& job);
+    void wakeCpuWorker(int preferredIndex);
+
+    static constexpr int numIoThreads = 6;
+
+    std::vector<std::unique_ptr<CpuWorker>> cpuWorkers;
+    std::atomic<int> pendingCpuJobs{ 0 };
+    std::atomic<unsigned int> nextCpuWorker{ 0 };
+    juce::ThreadPool ioPool{ numIoThreads };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BackgroundJobs)
+};
@@ -0,0 +1,101 @@
+#include "CandidateRanker.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace
+{
+    enum FeatureIndex { centroid = 0, brightness, loudness, width, sharpness };
+
+    struct KeywordIntent
+    {
+        const char* words;   // the keyword and its inflections, matched as whole words
+        FeatureIndex feature;
+        float weight;
+    };
+
+    const KeywordIntent keywordIntents[] = {
+        { "bright brighter brightest brightness", brightness, 1.0f }, { "shiny shinier", brightness, 1.0f },
+        { "crisp crisper crispy", brightness, 0.7f }, { "airy airier", brightness, 0.7f }, { "harsh harsher", brightness, 0.8f },
+        { "dark darker darkest", brightness, -1.0f }, { "warm warmer warmth", centroid, -0.7f },
+        { "mellow mellower", centroid, -0.8f }, { "muffled", brightness, -1.0f }, { "deep deeper deepest", centroid, -0.8f },
+        { "bass basses bassy", centroid, -1.0f }, { "sub subs", centroid, -1.0f }, { "lead leads", centroid, 0.5f },
+        { "wide wider widest", width, 1.0f }, { "stereo", width, 0.8f }, { "huge", width, 0.6f },
+        { "spacious", width, 0.8f }, { "mono", width, -1.0f }, { "narrow narrower", width, -1.0f },
+        { "pluck plucks plucky plucked", sharpness, 1.0f }, { "punchy punchier punch", sharpness, 1.0f },
+        { "stab stabs", sharpness, 1.0f }, { "percussive", sharpness, 1.0f }, { "snappy snappier", sharpness, 0.8f },
+        { "pad pads", sharpness, -1.0f }, { "swell swells swelling", sharpness, -1.0f }, { "ambient", sharpness, -0.7f },
+        { "soft softer", sharpness, -0.6f }, { "smooth smoother", sharpness, -0.5f },
+        { "loud louder loudest", loudness, 1.0f }, { "aggressive", loudness, 0.8f }, { "heavy heavier", loudness, 0.6f },
+        { "quiet quieter", loudness, -1.0f }, { "subtle", loudness, -0.8f },
+    };
+}
+
+CandidateRanker::IntentWeights CandidateRanker::parseIntent(const juce::String& prompt)
+{
+    IntentWeights weights{};
+    juce::StringArray words;
+    words.addTokens(prompt.toLowerCase(), " ,.;:!?-/\t\r\n", "\"'");
+    for (const auto& intent : keywordIntents)
+    {
+        const auto forms = juce::StringArray::fromTokens(intent.words, false);
+        for (const auto& word : words)
+            if (forms.contains(word))
+                weights[(size_t)intent.feature] += intent.weight;
+    }
+    return weights;
+}
+
+std::vector<int> CandidateRanker::rank(const std::vector<AudioFeatures>& candidates, const juce::String& prompt)
+{
+    std::vector<int> order(candidates.size());
+    std::iota(order.begin(), order.end(), 0);
+
+    const auto weights = parseIntent(prompt);
+    const bool hasIntent = std::any_of(weights.begin(), weights.end(), [](float w) { return w != 0.0f; });
+
+    // Standardise each feature over the valid candidates
+    std::array<float, AudioFeatures::numFeatures> mean{}, deviation{};
+    int numValid = 0;
+    for (const auto& candidate : candidates)
+    {
+        if (!candidate.valid)
+            continue;
+        const auto values = candidate.toArray();
+        for (size_t f = 0; f < values.size(); ++f)
+            mean[f] += values[f];
+        ++numValid;
+    }
+    for (auto& m : mean)
+        m /= (float)juce::jmax(1, numValid);
+    for (const auto& candidate : candidates)
+    {
+        if (!candidate.valid)
+            continue;
+        const auto values = candidate.toArray();
+        for (size_t f = 0; f < values.size(); ++f)
+            deviation[f] += (values[f] - mean[f]) * (values[f] - mean[f]);
+    }
+    for (auto& d : deviation)
+        d = std::sqrt(d / (float)juce::jmax(1, numValid));
+
+    std::vector<float> scores(candidates.size(), 0.0f);
+    for (size_t i = 0; i < candidates.size(); ++i)
+    {
+        if (!candidates[i].valid)
+        {
+            scores[i] = -std::numeric_limits<float>::max();
+            continue;
+        }
+        const auto values = candidates[i].toArray();
+        for (size_t f = 0; f < values.size(); ++f)
+            if (deviation[f] > 1.0e-6f)
+                scores[i] += weights[f] * (values[f] - mean[f]) / deviation[f];
+        if (!hasIntent)
+            scores[i] = 0.0f;
+    }
+
+    std::stable_sort(order.begin(), order.end(), [&scores](int a, int b) { return scores[(size_t)a] > scores[(size_t)b]; });
+    return order;
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <vector>
+#include "AudioFeatures.h"
+
+// Orders candidate presets by how well their rendered features fit the words
+// of the prompt ("bright", "wide", "pluck", ...). Features are standardised
+// across the candidates so each keyword pulls on a comparable scale.
+class CandidateRanker
+{
+public:
+    using IntentWeights = std::array<float, AudioFeatures::numFeatures>;
+
+    static IntentWeights parseIntent(const juce::String& prompt);
+
+    // Returns candidate indices, best match first. Invalid candidates sort last;
+    // with no recognised keywords the original order is kept.
+    static std::vector<int> rank(const std::vector<AudioFeatures>& candidates, const juce::String& prompt);
+};
@@ -33,9 +33,32 @@ public:
     }
 };
 
+class SuggestionLookAndFeel : public juce::LookAndFeel_V4
+{
+public:
+    void drawButtonText(juce::Graphics& g, juce::TextButton& button,
+        bool /*isMouseOverButton*/, bool /*isButtonDown*/) override
+    {
+        g.setFont(juce::Font("Press Start 2P", 9.0f, juce::Font::plain));
+        g.setColour(button.findColour(juce::TextButton::textColourOffId));
+        g.drawFittedText(button.getButtonText(), button.getLocalBounds().reduced(4, 0),
+            juce::Justification::centredLeft, 1, 1.0f);
+    }
+    void drawButtonBackground(juce::Graphics& g, juce::Button& button,
+        const juce::Colour& backgroundColour,
+        bool isMouseOverButton, bool /*isButtonDown*/) override
+    {
+        g.setColour(isMouseOverButton ? juce::Colours::darkblue : backgroundColour);
+        g.fillRect(button.getLocalBounds());
+        g.setColour(juce::Colours::dimgrey);
+        g.drawRect(button.getLocalBounds());
+    }
+};
+
 ChatBarComponent::ChatBarComponent(SummonerXSerum2AudioProcessor& p) : processor(p)
 {
     static ChatBarButtonLookAndFeel customSummonButton;
+    static SuggestionLookAndFeel suggestionLookAndFeel;
 
     // Initialize appProps for accessing the access token
     juce::PropertiesFile::Options options;
@@ -58,6 +81,16 @@ ChatBarComponent::ChatBarComponent(SummonerXSerum2AudioProcessor& p) : processor
     sendButton.setColour(juce::TextButton::textColourOffId, juce::Colours::white);
     sendButton.setLookAndFeel(&customSummonButton);
 
+    addAndMakeVisible(freshButton);
+    freshButton.setButtonText("Fresh");
+    freshButton.setClickingTogglesState(true);
+    freshButton.setTooltip("Generate a new sound even if this prompt was summoned before");
+    freshButton.setColour(juce::TextButton::buttonColourId, juce::Colours::black);
+    freshButton.setColour(juce::TextButton::buttonOnColourId, juce::Colours::dimgrey);
+    freshButton.setColour(juce::TextButton::textColourOnId, juce::Colours::whitesmoke);
+    freshButton.setColour(juce::TextButton::textColourOffId, juce::Colours::grey);
+    freshButton.setLookAndFeel(&customSummonButton);
+
     addAndMakeVisible(creditsLabel);
     creditsLabel.setText("Credits: 0", juce::dontSendNotification);
     creditsLabel.setFont(juce::Font("Press Start 2P", 12.0f, juce::Font::plain));
@@ -68,11 +101,6 @@ ChatBarComponent::ChatBarComponent(SummonerXSerum2AudioProcessor& p) : processor
     creditsLabel.addMouseListener(this, false);
 
     sendButton.onClick = [this]() {
-        if (requestInProgress)
-        {
-            DBG("Request already in progress, ignoring new request");
-            return;
-        }
         juce::String userInput = chatInput.getText();
         if (userInput.isEmpty())
         {
@@ -83,12 +111,53 @@ ChatBarComponent::ChatBarComponent(SummonerXSerum2AudioProcessor& p) : processor
             return;
         }
 
-        if (onLoadingStateChanged)
+        // Shift-summon puts the prompt ahead of everything already waiting
+        const auto priority = juce::ModifierKeys::currentModifiers.isShiftDown() ? PromptScheduler::Priority::high
+                                                                                 : PromptScheduler::Priority::normal;
+        if (scheduler.submit(userInput, priority) == 0)
         {
-            onLoadingStateChanged(true);
+            juce::AlertWindow::showMessageBoxAsync(
+                juce::AlertWindow::InfoIcon,
+                "Queue Full",
+                "Up to " + juce::String(PromptScheduler::maxQueued) + " prompts can wait at once. Cancel one or try again shortly.");
+            return;
         }
+        clearSuggestions();
+        };
 
-        sendPromptToGenerateParameters(userInput);
+    addChildComponent(cancelButton);
+    cancelButton.setButtonText("Cancel");
+    cancelButton.setTooltip("Stop the running prompt; the next queued one starts");
+    cancelButton.setColour(juce::TextButton::buttonColourId, juce::Colours::black);
+    cancelButton.setColour(juce::TextButton::textColourOffId, juce::Colours::white);
+    cancelButton.setLookAndFeel(&customSummonButton);
+    cancelButton.onClick = [this]() {
+        scheduler.cancel(scheduler.getActiveTicket());
+        };
+
+    addAndMakeVisible(queueLabel);
+    queueLabel.setFont(juce::Font("Press Start 2P", 10.0f, juce::Font::plain));
+    queueLabel.setColour(juce::Label::textColourId, juce::Colours::grey);
+    queueLabel.setJustificationType(juce::Justification::centredLeft);
+
+    // The editor stays usable while prompts run: progress shows here instead of over everything
+    scheduler.onStart = [this](PromptScheduler::Ticket, const juce::String& prompt) {
+        sendPromptToGenerateParameters(prompt);
+        };
+    scheduler.onCancel = [this](PromptScheduler::Ticket) {
+        api->cancel(promptRequest);
+        promptRequest = 0;
+        streamFinished = true;
+        processor.revertStreamedParameters();   // a cancelled prompt leaves no half-applied patch behind
+        };
+    scheduler.onQueueChanged = [this]() {
+        updateQueueStatus();
+        };
+    scheduler.onDropped = [](PromptScheduler::Ticket, const juce::String& prompt) {
+        juce::AlertWindow::showMessageBoxAsync(
+            juce::AlertWindow::InfoIcon,
+            "Queue Full",
+            "\"" + prompt + "\" was taken out of the queue to make room for a priority prompt. Summon it again when the queue has space.");
         };
 
     // Enable Enter key to trigger summon button
@@ -96,6 +165,29 @@ ChatBarComponent::ChatBarComponent(SummonerXSerum2AudioProcessor& p) : processor
         sendButton.onClick();
     };
 
+    // Past prompts that read like the one being typed, each a click away from its sound
+    for (int i = 0; i < maxSuggestions; ++i)
+    {
+        auto& button = suggestionButtons[(size_t)i];
+        addChildComponent(button);
+        button.setTooltip("Play the sound summoned for this prompt before, without spending a credit");
+        button.setColour(juce::TextButton::buttonColourId, juce::Colours::black);
+        button.setColour(juce::TextButton::textColourOffId, juce::Colours::grey);
+        button.setLookAndFeel(&suggestionLookAndFeel);
+        button.onClick = [this, i]() { applySuggestion(i); };
+    }
+    chatInput.onTextChange = [this]() {
+        updateSuggestions();
+    };
+    if (promptIndex.getNumEntries() == 0 || promptCache.wasIndexRebuilt())
+    {
+        // First run with an index, or the cache's keys may have changed under it: seed it from the cache
+        promptIndex.clear();
+        promptCache.forEachPrompt([this](juce::int64 key, const juce::String& canonical) {
+            promptIndex.add(key, canonical);
+            });
+    }
+
     // Initialize mystical floating boxes effect
     floatingBoxes.reserve(40); // Reserve space for up to 40 boxes
     startTimer(50); // 50ms timer for smooth animation (20 FPS)
@@ -103,8 +195,17 @@ ChatBarComponent::ChatBarComponent(SummonerXSerum2AudioProcessor& p) : processor
 
 ChatBarComponent::~ChatBarComponent()
 {
+    // Callbacks of cancelled requests never run, so none can reach this component
+    scheduler.onQueueChanged = nullptr;
+    scheduler.cancelAll();
+    for (auto id : creditsRequests)
+        api->cancel(id);
     stopTimer();
     sendButton.setLookAndFeel(nullptr);
+    freshButton.setLookAndFeel(nullptr);
+    cancelButton.setLookAndFeel(nullptr);
+    for (auto& button : suggestionButtons)
+        button.setLookAndFeel(nullptr);
 }
 
 void ChatBarComponent::paint(juce::Graphics& g)
@@ -151,225 +252,410 @@ void ChatBarComponent::resized()
     auto yPosition = (getHeight() - chatBarHeight) / 2;
     chatInput.setBounds((getWidth() - chatBarWidth - buttonWidth - 10) / 2, yPosition + -50, chatBarWidth, chatBarHeight);
     sendButton.setBounds(chatInput.getRight() + 10, yPosition - 50, buttonWidth, chatBarHeight);
+    freshButton.setBounds(sendButton.getX(), sendButton.getBottom() + 5, buttonWidth, 20);
+    cancelButton.setBounds(sendButton.getRight() + 10, sendButton.getY(), buttonWidth, chatBarHeight);
+    queueLabel.setBounds(chatInput.getX(), chatInput.getBottom() + 5, chatInput.getWidth(), 20);
+    const int suggestionWidth = (chatInput.getWidth() - 10 * (maxSuggestions - 1)) / maxSuggestions;
+    for (int i = 0; i < maxSuggestions; ++i)
+        suggestionButtons[(size_t)i].setBounds(chatInput.getX() + i * (suggestionWidth + 10), queueLabel.getBottom() + 5,
+            suggestionWidth, 20);
     creditsLabel.setBounds(10, 20, 200, 30);
 }
 
+void ChatBarComponent::updateQueueStatus()
+{
+    cancelButton.setVisible(scheduler.isBusy());
+    if (!scheduler.isBusy())
+    {
+        queueLabel.setText({}, juce::dontSendNotification);
+        return;
+    }
+
+    juce::String status = "Summoning: " + scheduler.getActivePrompt();
+    if (scheduler.getNumQueued() > 0)
+        status << "  (+" << scheduler.getNumQueued() << " queued)";
+    queueLabel.setText(status, juce::dontSendNotification);
+}
+
+void ChatBarComponent::finishPrompt()
+{
+    scheduler.finished(scheduler.getActiveTicket());
+}
+
+void ChatBarComponent::updateSuggestions()
+{
+    suggestions = promptIndex.search(chatInput.getText(), maxSuggestions);
+    for (int i = 0; i < maxSuggestions; ++i)
+    {
+        auto& button = suggestionButtons[(size_t)i];
+        const bool shown = i < (int)suggestions.size();
+        button.setVisible(shown);
+        if (shown)
+            button.setButtonText(suggestions[(size_t)i].prompt);
+    }
+}
+
+void ChatBarComponent::applySuggestion(int suggestion)
+{
+    if (suggestion < 0 || suggestion >= (int)suggestions.size())
+        return;
+
+    juce::String canonical;
+    PromptCache::Entry cached;
+    if (!promptCache.lookup(suggestions[(size_t)suggestion].key, canonical, cached))
+    {
+        // Gone from the cache (or unreadable), so it is never offered again
+        promptIndex.remove(suggestions[(size_t)suggestion].key);
+        updateSuggestions();
+        return;
+    }
+
+    processor.setResponseWithPlan(std::move(cached.response), std::move(cached.plan), cached.parameterCount);
+    if (auto* serumInterface = dynamic_cast<SerumInterfaceComponent*>(&processor.getSerumInterface()))
+    {
+        serumInterface->updateResponseCounter();
+    }
+    chatInput.setText(canonical, false);
+    clearSuggestions();
+}
+
+void ChatBarComponent::clearSuggestions()
+{
+    suggestions.clear();
+    for (auto& button : suggestionButtons)
+        button.setVisible(false);
+}
+
 void ChatBarComponent::sendPromptToGenerateParameters(const juce::String& userPrompt)
 {
-    requestInProgress = true;
+    // Tweaks of the current sound are worked out here; only new sounds go to the server
+    if (processor.applyRelativeEdit(userPrompt, relativeEditor))
+    {
+        finishPrompt();
+        return;
+    }
 
-    std::thread([this, userPrompt]() {
-        // Force reload properties to ensure we have the latest values
-        appProps.getUserSettings()->reload();
-        
-        juce::String accessToken = appProps.getUserSettings()->getValue("accessToken", "");
-        bool isLoggedIn = appProps.getUserSettings()->getBoolValue("isLoggedIn", false);
-        int credits = appProps.getUserSettings()->getIntValue("credits", 0);
-        
-        DBG("Token retrieval debug - isLoggedIn: " << (isLoggedIn ? "true" : "false") 
-            << ", accessToken length: " << accessToken.length() 
-            << ", credits: " << credits);
-            
-        // Check if user has credits before making request
-        if (credits <= 0)
+    // The same prompt again costs no credit and no round-trip, unless a fresh take was asked for
+    PromptCache::Entry cached;
+    if (!freshButton.getToggleState() && promptCache.lookup(userPrompt, cached))
+    {
+        processor.setResponseWithPlan(std::move(cached.response), std::move(cached.plan), cached.parameterCount);
+        if (auto* serumInterface = dynamic_cast<SerumInterfaceComponent*>(&processor.getSerumInterface()))
         {
-            DBG("No credits available - showing out of credits modal");
-            juce::MessageManager::callAsync([this]() {
-                showOutOfCreditsModal();
-                if (onLoadingStateChanged)
-                {
-                    onLoadingStateChanged(false);
-                }
-                requestInProgress = false;
-            });
-            return;
+            serumInterface->updateResponseCounter();
         }
-            
-        if (accessToken.isEmpty())
+        finishPrompt();
+        return;
+    }
+
+    // A local draft plays at once while the server works, and is all there is offline
+    // or out of credits; the server's answer then joins it in the response list
+    draftIndex = showLocalDraft(userPrompt);
+
+    // Force reload properties to ensure we have the latest values
+    appProps.getUserSettings()->reload();
+
+    juce::String accessToken = appProps.getUserSettings()->getValue("accessToken", "");
+    bool isLoggedIn = appProps.getUserSettings()->getBoolValue("isLoggedIn", false);
+    int credits = appProps.getUserSettings()->getIntValue("credits", 0);
+
+    DBG("Token retrieval debug - isLoggedIn: " << (isLoggedIn ? "true" : "false") 
+        << ", accessToken length: " << accessToken.length() 
+        << ", credits: " << credits);
+
+    // Check if user has credits before making request
+    if (credits <= 0)
+    {
+        DBG("No credits available - showing out of credits modal");
+        showOutOfCreditsModal();
+        finishPrompt();
+        return;
+    }
+
+    if (accessToken.isEmpty())
+    {
+        DBG("Access token is empty - login state: " << (isLoggedIn ? "logged in" : "not logged in"));
+        // Try to refresh token first before showing error
+        if (onRefreshTokenRequested)
         {
-            DBG("Access token is empty - login state: " << (isLoggedIn ? "logged in" : "not logged in"));
-            juce::MessageManager::callAsync([this]() {
-                // Try to refresh token first before showing error
-                if (onRefreshTokenRequested)
-                {
-                    onRefreshTokenRequested();
-                    
-                    // Give it a moment then check again
-                    juce::Timer::callAfterDelay(2000, [this]() {
-                        juce::String refreshedToken = appProps.getUserSettings()->getValue("accessToken", "");
-                        if (refreshedToken.isEmpty()) {
-                            juce::AlertWindow::showMessageBoxAsync(
-                                juce::AlertWindow::WarningIcon,
-                                "Authentication Error",
-                                "No access token found. Please log in again.");
-                        }
-                        if (onLoadingStateChanged)
-                        {
-                            onLoadingStateChanged(false);
-                        }
-                        requestInProgress = false;
-                    });
-                }
-                else
-                {
+            onRefreshTokenRequested();
+
+            // Give it a moment then check again; the prompt may have been cancelled meanwhile
+            juce::Timer::callAfterDelay(2000, [safeThis = juce::Component::SafePointer<ChatBarComponent>(this),
+                                               ticket = scheduler.getActiveTicket()]() {
+                if (safeThis == nullptr || safeThis->scheduler.getActiveTicket() != ticket)
+                    return;
+                juce::String refreshedToken = safeThis->appProps.getUserSettings()->getValue("accessToken", "");
+                if (refreshedToken.isEmpty()) {
                     juce::AlertWindow::showMessageBoxAsync(
                         juce::AlertWindow::WarningIcon,
                         "Authentication Error", 
                         "No access token found. Please log in again.");
-                    requestInProgress = false;
                 }
-                });
-            return;
+                safeThis->scheduler.finished(ticket);
+            });
         }
-        
-        DBG("Using access token for request: " << accessToken.substring(0, 10) << "...[truncated]");
+        else
+        {
+            juce::AlertWindow::showMessageBoxAsync(
+                juce::AlertWindow::WarningIcon,
+                "Authentication Error", 
+                "No access token found. Please log in again.");
+            finishPrompt();
+        }
+        return;
+    }
 
-        juce::URL endpoint("https://ydr97n8vxe.execute-api.us-east-2.amazonaws.com/prod/generate-parameters");
+    DBG("Using access token for request: " << accessToken.substring(0, 10) << "...[truncated]");
 
-        // Create JSON body
-        juce::DynamicObject::Ptr jsonObject = new juce::DynamicObject();
-        jsonObject->setProperty("input", userPrompt);
-        juce::String postData = juce::JSON::toString(jsonObject.get());
-        DBG("Sending POST request to /generate-parameters with JSON data: " + postData);
+    // Create JSON body
+    juce::DynamicObject::Ptr jsonObject = new juce::DynamicObject();
+    jsonObject->setProperty("input", userPrompt);
 
-        juce::URL urlWithPostData = endpoint.withPOSTData(postData);
+    ApiClient::Request request;
+    request.path = "/generate-parameters-stream";
+    request.jsonBody = juce::JSON::toString(jsonObject.get());
+    request.accessToken = accessToken;
+    request.timeoutMs = 50000;
+    request.streaming = true;
+    // A slow or cold backend gets a second copy instead of the whole wait; the
+    // shared idempotency key keeps that to one charge
+    request.hedged = true;
+    request.maxRetries = 2;
+    DBG("Sending POST request to /generate-parameters-stream with JSON data: " + request.jsonBody);
 
-        auto options = juce::URL::InputStreamOptions(juce::URL::ParameterHandling::inAddress)
-            .withExtraHeaders("Content-Type: application/json\nAuthorization: Bearer " + accessToken)
-            .withConnectionTimeoutMs(50000);
+    // Parameters are applied as their lines arrive; the full set becomes the response at the end
+    streamedParameters.clear();
+    processor.keepStreamedParameters();
+    streamFinished = false;
+    streamPrompt = userPrompt;
+    reportedCredits = -1;
 
-        std::unique_ptr<juce::InputStream> stream(urlWithPostData.createInputStream(options));
+    // Callbacks from a prompt that already finished must not touch the one that replaced it
+    const auto ticket = scheduler.getActiveTicket();
+    promptRequest = api->sendStreaming(request,
+        [this, ticket](const juce::StringArray& lines) {
+            if (ticket == scheduler.getActiveTicket())
+                handleStreamedLines(lines);
+        },
+        [this, request, ticket](const ApiClient::Response& apiResponse) mutable {
+            if (ticket != scheduler.getActiveTicket())
+                return;
+            promptRequest = 0;
+            if (streamFinished)
+                return;
+            if (apiResponse.connected)
+                reportedCredits = apiResponse.getCreditsRemaining();
 
-        if (stream != nullptr)
-        {
-            juce::String response = stream->readEntireStreamAsString();
-            DBG("Raw response from /generate-parameters endpoint: " + response);
-            juce::var result = juce::JSON::parse(response);
+            if (!apiResponse.connected)
+            {
+                processor.revertStreamedParameters();
+                showConnectionError();
+                return;
+            }
 
-            if (result.isObject())
+            // A backend without the streaming route: ask again the buffered way (nothing was charged)
+            if ((apiResponse.statusCode == 403 || apiResponse.statusCode == 404) && streamedParameters.empty())
             {
-                auto* obj = result.getDynamicObject();
-                
-                // Check if this is an error response with "detail" field
-                if (obj->hasProperty("detail"))
-                {
-                    juce::String detail = obj->getProperty("detail").toString();
-                    
-                    if (detail == "Invalid token")
-                    {
-                        juce::MessageManager::callAsync([this]() {
-                            DBG("Invalid token response - attempting to refresh token");
-                            
-                            // Try to refresh the token
-                            if (onRefreshTokenRequested)
-                            {
-                                onRefreshTokenRequested();
-                            }
-                            if (onLoadingStateChanged)
-                            {
-                                onLoadingStateChanged(false);
-                            }
-                            
-                            juce::AlertWindow::showMessageBoxAsync(
-                                juce::AlertWindow::WarningIcon,
-                                "Authentication Error",
-                                "Your session has expired. Please try again or log in again if the issue persists.");
-                            
-                            requestInProgress = false;
-                        });
-                        return;
-                    }
-                    else
-                    {
-                        // Handle other error details
-                        juce::MessageManager::callAsync([this, detail]() {
-                            if (auto* parent = getParentComponent())
-                            {
-                                if (auto* grandParent = parent->getParentComponent())
-                                {
-                                    if (auto* editor = dynamic_cast<SummonerXSerum2AudioProcessorEditor*>(grandParent))
-                                    {
-                                        editor->showLoadingScreen(false);
-                                    }
-                                }
-                            }
-                            
-                            DBG("API error response: " + detail);
-                            juce::AlertWindow::showMessageBoxAsync(
-                                juce::AlertWindow::WarningIcon,
-                                "Error",
-                                "Server error: " + detail);
-                            requestInProgress = false;
-                        });
+                DBG("Streaming endpoint unavailable (" << apiResponse.statusCode << "), falling back to /generate-parameters");
+                request.path = "/generate-parameters";
+                request.streaming = false;
+                promptRequest = api->send(request, [this, ticket](const ApiClient::Response& fallbackResponse) {
+                    if (ticket != scheduler.getActiveTicket())
                         return;
-                    }
-                }
-                
-                // If we get here, it's a successful response with parameters
-                std::map<std::string, std::string> parameterMap;
-                for (const auto& property : obj->getProperties())
-                {
-                    juce::String key = property.name.toString();
-                    juce::String value = property.value.toString();
-                    parameterMap[key.toStdString()] = value.toStdString();
-                }
-
-                juce::MessageManager::callAsync([this, parameterMap]() {
-                    std::vector<std::map<std::string, std::string>> responses = { parameterMap };
-                    processor.setResponses(responses);
-                    if (auto* serumInterface = dynamic_cast<SerumInterfaceComponent*>(&processor.getSerumInterface()))
-                    {
-                        serumInterface->updateResponseCounter();
-                    }
-
-                    // Update credits after successful response
-                    int credits = fetchUserCredits();
-                    setCredits(credits);
-                    
-                    // Notify editor to update other components
-                    if (onCreditsUpdated && credits >= 0) {
-                        onCreditsUpdated(credits);
-                    }
-
-                    if (onLoadingStateChanged)
-                    {
-                        onLoadingStateChanged(false);
-                    }
-                    requestInProgress = false;
-                    });
+                    promptRequest = 0;
+                    handleGeneratedParameters(fallbackResponse, streamPrompt);
+                });
+                return;
             }
-            else
+
+            // The stream ended without its terminator; keep whatever arrived
+            if (!streamedParameters.empty())
             {
-                juce::MessageManager::callAsync([this, response]() {
-                    DBG("Failed to parse response from /generate-parameters: " + response);
-                    juce::AlertWindow::showMessageBoxAsync(
-                        juce::AlertWindow::WarningIcon,
-                        "Error",
-                        "Failed to generate parameters: " + response);
-                    if (onLoadingStateChanged)
-                    {
-                        onLoadingStateChanged(false);
-                    }
-                    requestInProgress = false;
-                    });
+                finishStreamedPrompt(false);
+                return;
             }
+
+            // The server answered with a single JSON object after all
+            handleGeneratedParameters(apiResponse, streamPrompt);
+        });
+}
+
+void ChatBarComponent::handleStreamedLines(const juce::StringArray& lines)
+{
+    if (streamFinished)
+        return;
+
+    std::map<std::string, std::string> batch;
+    bool done = false;
+    for (const auto& line : lines)
+    {
+        // Views only live for the callback, so the members are copied out straight away
+        bool hasName = false, hasDone = false, hasDetail = false;
+        streamValue.clear();
+        const bool parsed = decoder.forEachMember(ResponseDecoder::viewOf(line), [&](std::string_view key, std::string_view member) {
+            if (key == "name") { hasName = true; streamName.assign(member); }
+            else if (key == "value") streamValue.assign(member);
+            else if (key == "detail") { hasDetail = true; streamValue.assign(member); }
+            else if (key == "done") hasDone = true;
+            else if (key == "credits") reportedCredits = juce::String::fromUTF8(member.data(), (int)member.size()).getIntValue();
+            });
+        if (!parsed)
+        {
+            DBG("Ignoring unparseable stream line: " + line);
+            continue;
         }
-        else
+
+        if (hasDetail)
         {
-            juce::MessageManager::callAsync([this]() {
-                DBG("Failed to connect to /generate-parameters endpoint");
-                juce::AlertWindow::showMessageBoxAsync(
-                    juce::AlertWindow::WarningIcon,
-                    "Connection Error",
-                    "Failed to connect to the server. Please try again.");
-                if (onLoadingStateChanged)
-                {
-                    onLoadingStateChanged(false);
-                }
-                requestInProgress = false;
-                });
+            streamFinished = true;
+            // The failed generation shouldn't leave half a preset behind
+            processor.revertStreamedParameters();
+            streamedParameters.clear();
+            handleErrorDetail(juce::String::fromUTF8(streamValue.data(), (int)streamValue.size()));
+            return;
         }
-        }).detach();
+        if (hasName)
+            batch[streamName] = streamValue;
+        else if (hasDone)
+            done = true;
+    }
+
+    if (!batch.empty())
+    {
+        const bool first = streamedParameters.empty();
+        for (const auto& parameter : batch)
+            streamedParameters[parameter.first] = parameter.second;
+        processor.applyStreamedParameters(batch);
+        if (first)
+            DBG("First streamed parameters applied");
+    }
+
+    if (done)
+        finishStreamedPrompt(true);
+}
+
+void ChatBarComponent::finishStreamedPrompt(bool complete)
+{
+    streamFinished = true;
+    processor.keepStreamedParameters();
+    DBG("Stream " << (complete ? "complete" : "cut short") << " with " << (int)streamedParameters.size() << " parameters");
+    auto plan = processor.getApplyPlan(streamedParameters);
+    commitGeneratedParameters(std::move(streamedParameters), std::move(plan), streamPrompt, complete);
+    streamedParameters.clear();
+}
+
+void ChatBarComponent::handleGeneratedParameters(const ApiClient::Response& apiResponse, const juce::String& userPrompt)
+{
+    if (!apiResponse.connected)
+    {
+        showConnectionError();
+        return;
+    }
+
+    const juce::String& response = apiResponse.body;
+    DBG("Raw response from /generate-parameters endpoint: " + response);
+    reportedCredits = apiResponse.getCreditsRemaining();
+
+    // One pass over the body: members are normalized and planned as they are read
+    ResponseDecoder::Result decoded;
+    if (!decoder.decode(ResponseDecoder::viewOf(response), processor.getParameterIndices(), decoded))
+    {
+        DBG("Failed to parse response from /generate-parameters: " + response);
+        juce::AlertWindow::showMessageBoxAsync(
+            juce::AlertWindow::WarningIcon,
+            "Error",
+            "Failed to generate parameters: " + response);
+        finishPrompt();
+        return;
+    }
+
+    // Check if this is an error response with "detail" field
+    if (decoded.detail.isNotEmpty())
+    {
+        handleErrorDetail(decoded.detail);
+        return;
+    }
+
+    commitGeneratedParameters(std::move(decoded.response), std::move(decoded.plan), userPrompt);
+}
+
+void ChatBarComponent::commitGeneratedParameters(std::map<std::string, std::string>&& parameterMap,
+    std::vector<PresetSwitchScheduler::ParameterChange>&& plan, const juce::String& userPrompt, bool cacheable)
+{
+    // Cached first, from the same data, so the response can then be moved into the processor
+    const int parameterCount = processor.getSerumParameterCount();
+    if (cacheable && promptCache.store(userPrompt, parameterMap, plan, parameterCount))
+    {
+        const auto canonical = PromptCache::canonicalize(userPrompt);
+        promptIndex.add(PromptCache::keyFor(canonical), canonical);
+    }
+    processor.setResponseWithPlan(std::move(parameterMap), std::move(plan), parameterCount);
+    if (auto* serumInterface = dynamic_cast<SerumInterfaceComponent*>(&processor.getSerumInterface()))
+    {
+        serumInterface->updateResponseCounter();
+    }
+
+    // The response reports the balance after its own charge; only a backend
+    // that doesn't yet needs the extra round-trip
+    if (reportedCredits >= 0)
+        updateCredits(reportedCredits);
+    else
+        fetchUserCredits([this](int credits) {
+            if (credits >= 0)
+                updateCredits(credits);
+        });
+
+    finishPrompt();
+}
+
+void ChatBarComponent::handleErrorDetail(const juce::String& detail)
+{
+    if (detail == "Invalid token")
+    {
+        DBG("Invalid token response - attempting to refresh token");
+
+        // Try to refresh the token
+        if (onRefreshTokenRequested)
+        {
+            onRefreshTokenRequested();
+        }
+
+        juce::AlertWindow::showMessageBoxAsync(
+            juce::AlertWindow::WarningIcon,
+            "Authentication Error",
+            "Your session has expired. Please try again or log in again if the issue persists.");
+
+        finishPrompt();
+        return;
+    }
+
+    DBG("API error response: " + detail);
+    juce::AlertWindow::showMessageBoxAsync(
+        juce::AlertWindow::WarningIcon,
+        "Error",
+        "Server error: " + detail);
+    finishPrompt();
+}
+
+void ChatBarComponent::showConnectionError()
+{
+    DBG("Failed to connect to /generate-parameters endpoint");
+    juce::AlertWindow::showMessageBoxAsync(
+        juce::AlertWindow::WarningIcon,
+        "Connection Error",
+        draftIndex >= 0 ? "Failed to connect to the server. The offline draft is still loaded; please try again."
+                   : "Failed to connect to the server. Please try again.");
+    finishPrompt();
+}
+
+int ChatBarComponent::showLocalDraft(const juce::String& userPrompt)
+{
+    // Appended, so a failed request still leaves the earlier responses in place
+    std::map<std::string, std::string> draft;
+    if (!localEngine.compose(userPrompt, draft))
+        return -1;
+    return processor.addResponse(std::move(draft));
 }
 
 void ChatBarComponent::sendAIResponseToProcessor(const std::map<std::string, std::string>& aiResponse)
@@ -377,6 +663,16 @@ void ChatBarComponent::sendAIResponseToProcessor(const std::map<std::string, std
     processor.applyPresetToSerum(aiResponse);
 }
 
+void ChatBarComponent::updateCredits(int credits)
+{
+    setCredits(credits);
+
+    // Notify editor to update other components (and the stored balance)
+    if (onCreditsUpdated) {
+        onCreditsUpdated(credits);
+    }
+}
+
 void ChatBarComponent::setCredits(int credits)
 {
     creditsLabel.setText("Credits: " + juce::String(credits), juce::dontSendNotification);
@@ -389,26 +685,35 @@ void ChatBarComponent::setCredits(int credits)
     }
 }
 
-int ChatBarComponent::fetchUserCredits()
+void ChatBarComponent::fetchUserCredits(std::function<void(int)> onFetched)
 {
     juce::String accessToken = appProps.getUserSettings()->getValue("accessToken", "");
     if (accessToken.isEmpty())
     {
         DBG("No access token available to fetch credits");
-        return -1; // Return -1 to indicate error, not legitimate 0 credits
+        onFetched(-1); // -1 indicates an error, not legitimate 0 credits
+        return;
     }
 
-    juce::URL url("https://ydr97n8vxe.execute-api.us-east-2.amazonaws.com/prod/get-credits");
-
-    auto options = juce::URL::InputStreamOptions(juce::URL::ParameterHandling::inPostData)
-        .withExtraHeaders("Authorization: Bearer " + accessToken)
-        .withConnectionTimeoutMs(50000);
+    ApiClient::Request request;
+    request.path = "/get-credits";
+    request.accessToken = accessToken;
+    request.timeoutMs = 50000;
+    request.maxRetries = 2;
 
-    std::unique_ptr<juce::InputStream> stream(url.createInputStream(options));
+    auto id = std::make_shared<ApiClient::RequestId>(0);
+    *id = api->send(std::move(request), [this, id, onFetched](const ApiClient::Response& response) {
+        creditsRequests.removeFirstMatchingValue(*id);
+        onFetched(parseCredits(response));
+    });
+    creditsRequests.add(*id);
+}
 
-    if (stream != nullptr)
+int ChatBarComponent::parseCredits(const ApiClient::Response& apiResponse)
+{
+    if (apiResponse.connected)
     {
-        juce::String response = stream->readEntireStreamAsString();
+        juce::String response = apiResponse.body;
         DBG("Received response from /get-credits endpoint: " + response);
         juce::var result = juce::JSON::parse(response);
         
@@ -506,31 +811,24 @@ void ChatBarComponent::showCreditsModal()
 
 void ChatBarComponent::refreshCreditsFromModal()
 {
-    // Use the existing fetchUserCredits method but with improved error handling
-    std::thread([this]() {
-        DBG("Modal credit refresh - starting background fetch");
-        
-        int newCredits = fetchUserCredits();
-        
-        // Update the UI on the main thread
-        juce::MessageManager::callAsync([this, newCredits]() {
-            if (newCredits >= 0) // Only update if we got a valid response (0 or positive credits)
-            {
-                DBG("Modal credit refresh - updating to: " << newCredits);
-                setCredits(newCredits);
-                
-                // Update stored credits too
-                appProps.getUserSettings()->setValue("credits", newCredits);
-                appProps.getUserSettings()->save();
-                
-                DBG("Credits successfully refreshed from modal");
-            }
-            else
-            {
-                DBG("Modal credit refresh - failed to get valid credits, keeping current value");
-            }
-        });
-    }).detach();
+    DBG("Modal credit refresh - starting background fetch");
+    fetchUserCredits([this](int newCredits) {
+        if (newCredits >= 0) // Only update if we got a valid response (0 or positive credits)
+        {
+            DBG("Modal credit refresh - updating to: " << newCredits);
+            setCredits(newCredits);
+
+            // Update stored credits too
+            appProps.getUserSettings()->setValue("credits", newCredits);
+            appProps.getUserSettings()->save();
+
+            DBG("Credits successfully refreshed from modal");
+        }
+        else
+        {
+            DBG("Modal credit refresh - failed to get valid credits, keeping current value");
+        }
+    });
 }
 
 // CreditsModalWindow Implementation
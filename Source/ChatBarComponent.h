@@ -1,6 +1,13 @@
 #pragma once
 #include <JuceHeader.h>
 #include "PluginProcessor.h"  
+#include "ApiClient.h"
+#include "LocalPresetEngine.h"
+#include "RelativeEditEngine.h"
+#include "PromptCache.h"
+#include "PromptIndex.h"
+#include "PromptScheduler.h"
+#include "ResponseDecoder.h"
 #include <map>
 #include <string>
 #include <array>
@@ -14,6 +21,8 @@ public:
     void paint(juce::Graphics&) override;
     void resized() override;
     void setCredits(int credits);
+    // Shows a balance and hands it to the editor, which stores it as the cached balance
+    void updateCredits(int credits);
     void showCreditsModal();
     void showOutOfCreditsModal();
     void refreshCreditsFromModal();
@@ -23,7 +32,6 @@ public:
     void timerCallback() override;
     
     // Callbacks for editor communication
-    std::function<void(bool)> onLoadingStateChanged;
     std::function<void()> onRefreshTokenRequested;
     std::function<void(int)> onCreditsUpdated;
 
@@ -193,15 +201,50 @@ private:
     std::unique_ptr<CreditsModalWindow> creditsModal;
     std::unique_ptr<OutOfCreditsModalWindow> outOfCreditsModal;
     void sendPromptToGenerateParameters(const juce::String& userPrompt);
+    void finishPrompt();   // lets the scheduler start the next queued prompt
+    void updateQueueStatus();
+    void handleStreamedLines(const juce::StringArray& lines);
+    void finishStreamedPrompt(bool complete);
+    void handleGeneratedParameters(const ApiClient::Response& response, const juce::String& userPrompt);
+    // Only complete responses are cached; a stream cut short is applied but not remembered
+    void commitGeneratedParameters(std::map<std::string, std::string>&& parameterMap,
+        std::vector<PresetSwitchScheduler::ParameterChange>&& plan, const juce::String& userPrompt, bool cacheable = true);
+    void handleErrorDetail(const juce::String& detail);
+    void showConnectionError();
+    int showLocalDraft(const juce::String& userPrompt);   // the draft's response index, -1 when the prompt has no known words
+    void updateSuggestions();
+    void applySuggestion(int suggestion);
+    void clearSuggestions();
     void sendAIResponseToProcessor(const std::map<std::string, std::string>& aiResponse);
-    int fetchUserCredits();  // Add declaration here
+    void fetchUserCredits(std::function<void(int)> onFetched);  // -1 on any error
+    static int parseCredits(const ApiClient::Response& response);
 
     SummonerXSerum2AudioProcessor& processor;
     juce::TextEditor chatInput;
     juce::TextButton sendButton;
+    juce::TextButton freshButton;   // toggled on: skip the prompt cache and generate anew
+    juce::TextButton cancelButton;
+    juce::Label queueLabel;
     juce::Label creditsLabel;
     juce::ApplicationProperties appProps;
-    bool requestInProgress = false;
+    juce::SharedResourcePointer<ApiClient> api;
+    ApiClient::RequestId promptRequest = 0;
+    PromptCache promptCache;
+    PromptIndex promptIndex;
+    static constexpr int maxSuggestions = 3;
+    std::array<juce::TextButton, maxSuggestions> suggestionButtons;
+    std::vector<PromptIndex::Suggestion> suggestions;
+    PromptScheduler scheduler;
+    juce::Array<ApiClient::RequestId> creditsRequests;
+    ResponseDecoder decoder;
+    LocalPresetEngine localEngine;
+    RelativeEditEngine relativeEditor;
+    int draftIndex = -1;   // where the running prompt's local draft sits in the response list, -1 for none
+    std::string streamName, streamValue;   // scratch for streamed lines, reused
+    std::map<std::string, std::string> streamedParameters;
+    juce::String streamPrompt;
+    bool streamFinished = false;
+    int reportedCredits = -1;   // balance reported by the running generation, -1 until known
     bool creditsLabelHovered = false;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ChatBarComponent)
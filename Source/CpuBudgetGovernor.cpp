@@ -0,0 +1,186 @@
+#include "CpuBudgetGovernor.h"
+#include "ParameterNormalizer.h"
+#include <algorithm>
+#include <cmath>
+
+CpuBudgetGovernor::CpuBudgetGovernor()
+{
+    startTimer(checkIntervalMs);
+}
+
+CpuBudgetGovernor::~CpuBudgetGovernor()
+{
+    stopTimer();
+}
+
+void CpuBudgetGovernor::prepare(double sampleRate)
+{
+    if (sampleRate > 0.0)
+        currentSampleRate = sampleRate;
+    peakLoad = 0.0f;
+    blocksSinceCheck = 0;
+}
+
+void CpuBudgetGovernor::setEnabled(bool shouldBeEnabled)
+{
+    enabled = shouldBeEnabled;
+    if (!enabled && level > 0)
+        setLevel(0, lastPeakLoad);
+}
+
+void CpuBudgetGovernor::recordBlock(juce::int64 elapsedTicks, int numSamples) noexcept
+{
+    if (numSamples <= 0)
+        return;
+
+    const double deadlineSeconds = numSamples / currentSampleRate.load();
+    const auto load = (float)(juce::Time::highResolutionTicksToSeconds(elapsedTicks) / deadlineSeconds);
+
+    auto previous = peakLoad.load();
+    while (load > previous && !peakLoad.compare_exchange_weak(previous, load)) {}
+    blocksSinceCheck.fetch_add(1);
+}
+
+void CpuBudgetGovernor::timerCallback()
+{
+    const int blocks = blocksSinceCheck.exchange(0);
+    const float peak = peakLoad.exchange(0.0f);
+    if (blocks == 0 || !enabled)
+        return; // nothing rendered (gated or stopped), so nothing to judge
+
+    lastPeakLoad = peak;
+    const float currentBudget = budget.load();
+
+    if (peak > currentBudget)
+    {
+        headroomChecks = 0;
+        if (++overBudgetChecks >= checksBeforeEscalating && level < maxLevel)
+        {
+            overBudgetChecks = 0;
+            setLevel(level + 1, peak);
+        }
+    }
+    else if (peak < currentBudget * restoreThreshold)
+    {
+        overBudgetChecks = 0;
+        if (level > 0 && ++headroomChecks >= checksBeforeRestoring)
+        {
+            headroomChecks = 0;
+            setLevel(level - 1, peak);
+        }
+    }
+    else
+    {
+        overBudgetChecks = 0;
+        headroomChecks = 0;
+    }
+}
+
+void CpuBudgetGovernor::setLevel(int newLevel, float load)
+{
+    newLevel = juce::jlimit(0, maxLevel, newLevel);
+    if (newLevel == level)
+        return;
+
+    const int previousLevel = level;
+    captureParameters();
+    level = newLevel;
+    applyLevel();
+
+    logIntervention((newLevel > previousLevel ? "Reducing" : "Restoring")
+        + juce::String(" voice load: level ") + juce::String(previousLevel) + " -> " + juce::String(newLevel)
+        + " (peak load " + juce::String(load * 100.0f, 1) + "% of block, budget "
+        + juce::String(budget.load() * 100.0f, 1) + "%, " + juce::String((int)tracked.size()) + " parameters)");
+}
+
+void CpuBudgetGovernor::captureParameters()
+{
+    auto instances = getInstances ? getInstances() : juce::Array<juce::AudioPluginInstance*>();
+
+    // Forget instances that were swapped out or removed since the last capture
+    tracked.erase(std::remove_if(tracked.begin(), tracked.end(),
+        [&instances](const TrackedParameter& t) { return !instances.contains(t.instance); }),
+        tracked.end());
+
+    for (auto* instance : instances)
+    {
+        const auto& parameters = instance->getParameters();
+        for (int i = 0; i < parameters.size(); ++i)
+        {
+            auto* param = parameters[i];
+            if (param == nullptr || !isCostParameter(param->getName(128)))
+                continue;
+
+            const bool alreadyTracked = std::any_of(tracked.begin(), tracked.end(),
+                [instance, i](const TrackedParameter& t) { return t.instance == instance && t.parameterIndex == i; });
+            if (!alreadyTracked)
+                tracked.push_back({ instance, i, param->getName(128), param->getValue(), param->getValue() });
+        }
+    }
+}
+
+void CpuBudgetGovernor::applyLevel()
+{
+    for (auto& t : tracked)
+    {
+        auto* param = t.instance->getParameters()[t.parameterIndex];
+        if (param == nullptr)
+            continue;
+
+        // A preset applied since our last change becomes the new original
+        if (std::abs(param->getValue() - t.appliedValue) > 1.0e-4f)
+            t.originalValue = param->getValue();
+
+        const float target = level == 0 ? t.originalValue : scaledValue(t);
+        if (std::abs(param->getValue() - target) > 1.0e-4f)
+        {
+            param->setValueNotifyingHost(target);
+            DBG("Governor set " << t.name << " to " << target << " (original " << t.originalValue << ")");
+        }
+        t.appliedValue = target;
+    }
+
+    if (level == 0)
+        tracked.clear();
+}
+
+float CpuBudgetGovernor::scaledValue(const TrackedParameter& t) const
+{
+    const auto name = t.name.toStdString();
+    const bool isHyper = t.name.containsIgnoreCase("Hyp");
+    const int minVoices = isHyper ? 0 : 1;
+    const int maxVoices = isHyper ? 7 : 16;
+    auto toMacro = [&name, isHyper](int voices) {
+        return isHyper ? hypUnisonToMacro(name, std::to_string(voices)) : unisonToMacro(name, std::to_string(voices));
+    };
+
+    // Invert the normalizer's table by picking the nearest voice count
+    int originalVoices = minVoices;
+    float bestDistance = 2.0f;
+    for (int voices = minVoices; voices <= maxVoices; ++voices)
+    {
+        const float distance = std::abs(toMacro(voices) - t.originalValue);
+        if (distance < bestDistance)
+        {
+            bestDistance = distance;
+            originalVoices = voices;
+        }
+    }
+
+    const int scaledVoices = juce::jmax(minVoices, originalVoices >> level);
+    return juce::jmin(t.originalValue, toMacro(scaledVoices));
+}
+
+void CpuBudgetGovernor::logIntervention(const juce::String& message)
+{
+    const auto entry = juce::Time::getCurrentTime().toString(true, true, true, true) + " " + message;
+    juce::Logger::writeToLog("CpuBudgetGovernor: " + entry);
+    interventionLog.add(entry);
+    if (interventionLog.size() > maxLogEntries)
+        interventionLog.remove(0);
+}
+
+bool CpuBudgetGovernor::isCostParameter(const juce::String& name)
+{
+    return name == "A Unison" || name == "B Unison" || name == "C Unison" || name == "Hyp Unison";
+}
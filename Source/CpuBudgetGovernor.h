@@ -0,0 +1,74 @@
+#pragma once
+#include <JuceHeader.h>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <atomic>
+#include <functional>
+#include <vector>
+
+// Watches how much of each block's deadline the hosted instances take and,
+// when the configured budget is exceeded, steps down the parameters that drive
+// voice count (oscillator unison and hyper unison). Levels are restored one at
+// a time once there is headroom again. Measurement happens on the audio thread;
+// every decision and parameter change happens on the message thread.
+class CpuBudgetGovernor : private juce::Timer
+{
+public:
+    CpuBudgetGovernor();
+    ~CpuBudgetGovernor() override;
+
+    // Message thread
+    void prepare(double sampleRate);
+    void setBudget(float fractionOfBlock) { budget = juce::jlimit(0.05f, 1.0f, fractionOfBlock); }
+    void setEnabled(bool shouldBeEnabled);
+    int getLevel() const noexcept { return level; }
+    float getRecentPeakLoad() const noexcept { return lastPeakLoad; }
+    const juce::StringArray& getInterventionLog() const noexcept { return interventionLog; }
+
+    // Supplies every hosted instance the governor may act on
+    std::function<juce::Array<juce::AudioPluginInstance*>()> getInstances;
+
+    // Audio thread: wall time of one rendered block
+    void recordBlock(juce::int64 elapsedTicks, int numSamples) noexcept;
+
+    static constexpr int maxLevel = 3;
+
+private:
+    struct TrackedParameter
+    {
+        juce::AudioPluginInstance* instance = nullptr;
+        int parameterIndex = -1;
+        juce::String name;
+        float originalValue = 0.0f;
+        float appliedValue = 0.0f;
+    };
+
+    void timerCallback() override;
+    void setLevel(int newLevel, float peakLoad);
+    void applyLevel();
+    void captureParameters();
+    float scaledValue(const TrackedParameter& tracked) const;
+    void logIntervention(const juce::String& message);
+
+    static bool isCostParameter(const juce::String& name);
+
+    std::atomic<float> peakLoad{ 0.0f };
+    std::atomic<int> blocksSinceCheck{ 0 };
+    std::atomic<double> currentSampleRate{ 44100.0 };
+    std::atomic<float> budget{ 0.7f };
+    bool enabled = true;
+
+    int level = 0;
+    int overBudgetChecks = 0;
+    int headroomChecks = 0;
+    float lastPeakLoad = 0.0f;
+    std::vector<TrackedParameter> tracked;
+    juce::StringArray interventionLog;
+
+    static constexpr int checkIntervalMs = 500;
+    static constexpr int checksBeforeEscalating = 2;
+    static constexpr int checksBeforeRestoring = 6;
+    static constexpr float restoreThreshold = 0.5f; // fraction of the budget
+    static constexpr int maxLogEntries = 200;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CpuBudgetGovernor)
+};
@@ -0,0 +1,95 @@
+#include "HostedInstanceSlot.h"
+
+HostedInstanceSlot::~HostedInstanceSlot()
+{
+    stopTimer();
+    // The host has stopped calling processBlock by the time the processor is
+    // destroyed, so everything can be released immediately.
+    published.store(nullptr);
+    outgoing.store(nullptr);
+    retired.clear();
+    owned.reset();
+}
+
+void HostedInstanceSlot::publish(std::unique_ptr<juce::AudioPluginInstance> newInstance, int crossfadeSamples)
+{
+    if (newInstance != nullptr && newInstance.get() == owned.get())
+        return;
+
+    auto oldInstance = std::move(owned);
+    const bool fadeOut = oldInstance != nullptr && newInstance != nullptr && crossfadeSamples > 0;
+
+    // Outgoing must be visible before the new instance so the audio thread never
+    // sees the new instance without the one it is fading from.
+    crossfadeLength.store(fadeOut ? crossfadeSamples : 0);
+    outgoing.store(fadeOut ? oldInstance.get() : nullptr);
+    published.store(newInstance.get());
+    owned = std::move(newInstance);
+
+    if (oldInstance != nullptr)
+        retire(std::move(oldInstance), fadeOut);
+
+    DBG("HostedInstanceSlot published: " << (owned != nullptr ? owned->getName() : juce::String("nullptr"))
+        << (fadeOut ? " (crossfading " + juce::String(crossfadeSamples) + " samples)" : juce::String()));
+}
+
+void HostedInstanceSlot::retire(std::unique_ptr<juce::AudioPluginInstance> oldInstance, bool awaitingCrossfade)
+{
+    // Read the epoch only after the new pointer is visible: if the audio thread
+    // is outside a block now, its next block can only see the new instance.
+    retired.push_back({ std::move(oldInstance), audioEpoch.load(), awaitingCrossfade, juce::Time::getMillisecondCounter() });
+    collectGarbage();
+
+    if (!retired.empty() && !isTimerRunning())
+        startTimer(50);
+}
+
+bool HostedInstanceSlot::isSafeToReclaim(RetiredInstance& entry)
+{
+    if (entry.awaitingCrossfade)
+    {
+        if (outgoing.load() == entry.instance.get())
+        {
+            if (juce::Time::getMillisecondCounter() - entry.retiredAtMs < crossfadeTimeoutMs)
+                return false;
+
+            auto* expected = entry.instance.get();
+            outgoing.compare_exchange_strong(expected, nullptr);
+        }
+
+        // The fade is over; from here the usual epoch rule applies
+        entry.awaitingCrossfade = false;
+        entry.retireEpoch = audioEpoch.load();
+    }
+
+    if ((entry.retireEpoch & 1) == 0)
+        return true;
+
+    return audioEpoch.load() > entry.retireEpoch;
+}
+
+void HostedInstanceSlot::collectGarbage()
+{
+    for (auto it = retired.begin(); it != retired.end();)
+    {
+        if (isSafeToReclaim(*it))
+        {
+            DBG("Releasing retired plugin instance: " << it->instance->getName());
+            auto instance = std::move(it->instance);
+            it = retired.erase(it);
+            if (onReclaimed)
+                onReclaimed(std::move(instance));
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+void HostedInstanceSlot::timerCallback()
+{
+    collectGarbage();
+    if (retired.empty())
+        stopTimer();
+}
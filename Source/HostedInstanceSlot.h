@@ -0,0 +1,90 @@
+#pragma once
+#include <JuceHeader.h>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <atomic>
+#include <functional>
+#include <vector>
+
+// Publishes the hosted plugin instance to the audio thread without a lock.
+// The message thread owns the instance and swaps an atomic pointer; the audio
+// thread bumps an epoch counter on entry and exit of every block, so a retired
+// instance is only destroyed (on the message thread) once the audio thread has
+// provably left any block that could still be using it.
+class HostedInstanceSlot : private juce::Timer
+{
+public:
+    HostedInstanceSlot() = default;
+    ~HostedInstanceSlot() override;
+
+    // Message thread only. With crossfadeSamples > 0 the previous instance stays
+    // visible to the audio thread as the outgoing instance until the fade ends.
+    void publish(std::unique_ptr<juce::AudioPluginInstance> newInstance, int crossfadeSamples = 0);
+    void clear() { publish(nullptr); }
+    juce::AudioPluginInstance* get() const noexcept { return owned.get(); }
+    void collectGarbage();
+
+    // Receives instances once the audio thread can no longer see them; when not
+    // set, reclaimed instances are simply deleted.
+    std::function<void(std::unique_ptr<juce::AudioPluginInstance>)> onReclaimed;
+
+    // Audio thread: holds the epoch open for the lifetime of the scope
+    class ReadScope
+    {
+    public:
+        explicit ReadScope(HostedInstanceSlot& s) noexcept
+            : slot(s)
+        {
+            slot.audioEpoch.fetch_add(1);
+            instance = slot.published.load();
+            outgoing = slot.outgoing.load();
+        }
+
+        ~ReadScope() noexcept
+        {
+            slot.audioEpoch.fetch_add(1);
+        }
+
+        juce::AudioPluginInstance* get() const noexcept { return instance; }
+        juce::AudioPluginInstance* getOutgoing() const noexcept { return outgoing != instance ? outgoing : nullptr; }
+        int getCrossfadeLength() const noexcept { return slot.crossfadeLength.load(); }
+
+        // Called once the fade has completed so the outgoing instance can be reclaimed
+        void finishCrossfade() noexcept
+        {
+            auto* expected = outgoing;
+            slot.outgoing.compare_exchange_strong(expected, nullptr);
+            outgoing = nullptr;
+        }
+
+    private:
+        HostedInstanceSlot& slot;
+        juce::AudioPluginInstance* instance = nullptr;
+        juce::AudioPluginInstance* outgoing = nullptr;
+
+        JUCE_DECLARE_NON_COPYABLE(ReadScope)
+    };
+
+private:
+    struct RetiredInstance
+    {
+        std::unique_ptr<juce::AudioPluginInstance> instance;
+        uint64_t retireEpoch = 0;
+        bool awaitingCrossfade = false;
+        juce::uint32 retiredAtMs = 0;
+    };
+
+    void retire(std::unique_ptr<juce::AudioPluginInstance> oldInstance, bool awaitingCrossfade);
+    bool isSafeToReclaim(RetiredInstance& entry);
+    void timerCallback() override;
+
+    static constexpr juce::uint32 crossfadeTimeoutMs = 2000; // host stopped processing mid-fade
+
+    std::unique_ptr<juce::AudioPluginInstance> owned;
+    std::atomic<juce::AudioPluginInstance*> published{ nullptr };
+    std::atomic<juce::AudioPluginInstance*> outgoing{ nullptr };
+    std::atomic<int> crossfadeLength{ 0 };
+    std::atomic<uint64_t> audioEpoch{ 0 }; // odd while the audio thread is inside a block
+    std::vector<RetiredInstance> retired;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(HostedInstanceSlot)
+};
@@ -0,0 +1,300 @@
+#include "LayerGraph.h"
+
+LayerGraph::LayerGraph()
+{
+}
+
+LayerGraph::~LayerGraph()
+{
+    publishedPool.store(nullptr);
+    workerPool.reset();
+    for (auto& layer : layers)
+        layer.slot.onReclaimed = nullptr;
+}
+
+void LayerGraph::prepareToPlay(double sampleRate, int samplesPerBlock)
+{
+    currentSampleRate = sampleRate;
+    currentBlockSize = samplesPerBlock;
+
+    for (auto& layer : layers)
+    {
+        layer.buffer.setSize(2, samplesPerBlock, false, true, true);
+        layer.midi.ensureSize(2048);
+        layer.carriedMidi.ensureSize(2048);
+        if (auto* instance = layer.slot.get())
+            instance->prepareToPlay(sampleRate, samplesPerBlock);
+    }
+}
+
+int LayerGraph::addLayer(std::unique_ptr<juce::AudioPluginInstance> instance)
+{
+    if (instance == nullptr)
+        return -1;
+
+    for (int i = 0; i < maxLayers; ++i)
+    {
+        auto& layer = layers[(size_t)i];
+        if (layer.slot.get() != nullptr)
+            continue;
+
+        if (workerPool == nullptr)
+        {
+            // The audio thread renders the primary instance itself
+            const int numWorkers = juce::jlimit(0, maxLayers, juce::SystemStats::getNumCpus() - 1);
+            workerPool = std::make_unique<RealtimeWorkerPool>(numWorkers);
+            publishedPool.store(workerPool.get());
+        }
+
+        if (currentSampleRate > 0.0 && currentBlockSize > 0)
+            instance->prepareToPlay(currentSampleRate, currentBlockSize);
+
+        layer.lowestNote = 0;
+        layer.highestNote = 127;
+        layer.midiChannel = 0;
+        layer.gain = 1.0f;
+        layer.slot.publish(std::move(instance));
+        DBG("Added layer " << i);
+        return i;
+    }
+
+    DBG("All " << maxLayers << " layers are in use");
+    return -1;
+}
+
+void LayerGraph::removeLayer(int layerIndex)
+{
+    if (juce::isPositiveAndBelow(layerIndex, maxLayers))
+        layers[(size_t)layerIndex].slot.clear();
+}
+
+void LayerGraph::clear()
+{
+    for (auto& layer : layers)
+        layer.slot.clear();
+}
+
+void LayerGraph::setKeyRange(int layerIndex, int lowestNote, int highestNote)
+{
+    if (!juce::isPositiveAndBelow(layerIndex, maxLayers))
+        return;
+
+    auto& layer = layers[(size_t)layerIndex];
+    layer.lowestNote = juce::jlimit(0, 127, juce::jmin(lowestNote, highestNote));
+    layer.highestNote = juce::jlimit(0, 127, juce::jmax(lowestNote, highestNote));
+}
+
+void LayerGraph::setMidiChannel(int layerIndex, int midiChannel)
+{
+    if (juce::isPositiveAndBelow(layerIndex, maxLayers))
+        layers[(size_t)layerIndex].midiChannel = juce::jlimit(0, 16, midiChannel);
+}
+
+void LayerGraph::setGain(int layerIndex, float gain)
+{
+    if (juce::isPositiveAndBelow(layerIndex, maxLayers))
+        layers[(size_t)layerIndex].gain = juce::jmax(0.0f, gain);
+}
+
+juce::Range<int> LayerGraph::getKeyRange(int layerIndex) const
+{
+    if (!juce::isPositiveAndBelow(layerIndex, maxLayers))
+        return { 0, 127 };
+    const auto& layer = layers[(size_t)layerIndex];
+    return { layer.lowestNote.load(), layer.highestNote.load() };
+}
+
+int LayerGraph::getMidiChannel(int layerIndex) const
+{
+    return juce::isPositiveAndBelow(layerIndex, maxLayers) ? layers[(size_t)layerIndex].midiChannel.load() : 0;
+}
+
+float LayerGraph::getGain(int layerIndex) const
+{
+    return juce::isPositiveAndBelow(layerIndex, maxLayers) ? layers[(size_t)layerIndex].gain.load() : 1.0f;
+}
+
+juce::AudioPluginInstance* LayerGraph::getLayerInstance(int layerIndex) const
+{
+    return juce::isPositiveAndBelow(layerIndex, maxLayers) ? layers[(size_t)layerIndex].slot.get() : nullptr;
+}
+
+int LayerGraph::getNumLayers() const
+{
+    int count = 0;
+    for (auto& layer : layers)
+        if (layer.slot.get() != nullptr)
+            ++count;
+    return count;
+}
+
+void LayerGraph::setReclaimHandler(std::function<void(std::unique_ptr<juce::AudioPluginInstance>)> handler)
+{
+    for (auto& layer : layers)
+        layer.slot.onReclaimed = handler;
+}
+
+bool LayerGraph::beginRender(const juce::MidiBuffer& midiMessages, int numChannels, int numSamples)
+{
+    auto* pool = publishedPool.load();
+    if (pool == nullptr)
+        return false;
+
+    // The late layers still own their buffers and instances
+    if (renderRunningLate)
+    {
+        if (pool->isBusy())
+        {
+            for (auto& layer : layers)
+                carryMidi(layer, midiMessages);
+            return false;
+        }
+        releaseActiveLayers();
+        renderRunningLate = false;
+    }
+    numActiveLayers = 0;
+    numLateLayers = 0;
+
+    renderChannels = numChannels;
+    renderSamples = numSamples;
+    if (currentSampleRate > 0.0)
+        renderDeadlineTicks = juce::Time::getHighResolutionTicks()
+            + juce::Time::secondsToHighResolutionTicks(deadlineFraction * numSamples / currentSampleRate);
+
+    for (int i = 0; i < maxLayers; ++i)
+    {
+        auto& layer = layers[(size_t)i];
+        layer.readScope.emplace(layer.slot);
+        layer.instance = layer.readScope->get();
+        if (layer.instance == nullptr
+            || numChannels > layer.buffer.getNumChannels()
+            || numSamples > layer.buffer.getNumSamples())
+        {
+            layer.readScope.reset();
+            layer.instance = nullptr;
+            layer.carriedMidi.clear();
+            layer.lateSamples = 0;
+            continue;
+        }
+
+        // A late block plays now in place of this one, whose MIDI waits for the next render
+        if (layer.lateSamples > 0)
+        {
+            carryMidi(layer, midiMessages);
+            layer.readScope.reset();
+            layer.instance = nullptr;
+            lateLayers[(size_t)numLateLayers++] = i;
+            continue;
+        }
+
+        // Work on the raw bytes so no MidiMessage is constructed per event
+        const int lowestNote = layer.lowestNote.load();
+        const int highestNote = layer.highestNote.load();
+        const int midiChannel = layer.midiChannel.load();
+        layer.midi.clear();
+        for (const auto metadata : layer.carriedMidi)
+            layer.midi.addEvent(metadata.data, metadata.numBytes, 0);
+        layer.carriedMidi.clear();
+        for (const auto metadata : midiMessages)
+            if (passesFilter(metadata.data, metadata.numBytes, lowestNote, highestNote, midiChannel))
+                layer.midi.addEvent(metadata.data, metadata.numBytes, metadata.samplePosition);
+
+        layer.rendered.store(false);
+        activeLayers[(size_t)numActiveLayers++] = i;
+    }
+
+    if (numActiveLayers > 0)
+        pool->dispatch(&LayerGraph::renderLayerJob, this, numActiveLayers);
+    return numActiveLayers > 0 || numLateLayers > 0;
+}
+
+void LayerGraph::finishAndMix(juce::AudioBuffer<float>& output)
+{
+    auto* pool = publishedPool.load();
+    const bool finished = numActiveLayers == 0 || pool == nullptr || currentSampleRate <= 0.0
+        || pool->helpAndWait(renderDeadlineTicks);
+
+    const int numChannels = juce::jmin(renderChannels, output.getNumChannels());
+    const auto mix = [&output, numChannels](const Layer& layer, int numSamples)
+    {
+        const float gain = layer.gain.load();
+        for (int channel = 0; channel < numChannels; ++channel)
+            juce::FloatVectorOperations::addWithMultiply(output.getWritePointer(channel),
+                layer.buffer.getReadPointer(channel), gain, juce::jmin(numSamples, output.getNumSamples()));
+    };
+
+    for (int i = 0; i < numLateLayers; ++i)
+    {
+        auto& layer = layers[(size_t)lateLayers[(size_t)i]];
+        mix(layer, layer.lateSamples);
+        layer.lateSamples = 0;
+    }
+    numLateLayers = 0;
+
+    for (int job = 0; job < numActiveLayers; ++job)
+    {
+        auto& layer = layers[(size_t)activeLayers[(size_t)job]];
+        if (layer.rendered.load())
+            mix(layer, renderSamples);
+        else
+            layer.lateSamples = renderSamples;   // mixed once it is done
+    }
+
+    if (finished)
+    {
+        releaseActiveLayers();
+        return;
+    }
+    renderRunningLate = true;
+}
+
+void LayerGraph::releaseActiveLayers() noexcept
+{
+    for (int job = 0; job < numActiveLayers; ++job)
+    {
+        auto& layer = layers[(size_t)activeLayers[(size_t)job]];
+        layer.instance = nullptr;
+        layer.readScope.reset();
+    }
+    numActiveLayers = 0;
+}
+
+void LayerGraph::carryMidi(Layer& layer, const juce::MidiBuffer& midiMessages) noexcept
+{
+    // The timing within a skipped block is gone; what matters is that every event arrives
+    const int lowestNote = layer.lowestNote.load();
+    const int highestNote = layer.highestNote.load();
+    const int midiChannel = layer.midiChannel.load();
+    for (const auto metadata : midiMessages)
+        if (passesFilter(metadata.data, metadata.numBytes, lowestNote, highestNote, midiChannel))
+            layer.carriedMidi.addEvent(metadata.data, metadata.numBytes, 0);
+}
+
+void LayerGraph::renderLayerJob(void* context, int jobIndex)
+{
+    auto& graph = *static_cast<LayerGraph*>(context);
+    auto& layer = graph.layers[(size_t)graph.activeLayers[(size_t)jobIndex]];
+
+    juce::ScopedNoDenormals noDenormals;
+    juce::AudioBuffer<float> view(layer.buffer.getArrayOfWritePointers(), graph.renderChannels, graph.renderSamples);
+    view.clear();
+    layer.instance->processBlock(view, layer.midi);
+    layer.rendered.store(true);
+}
+
+bool LayerGraph::passesFilter(const juce::uint8* data, int numBytes, int lowestNote, int highestNote, int midiChannel) noexcept
+{
+    if (numBytes < 1 || data[0] >= 0xf0)
+        return true; // system messages go to every layer
+
+    const int channel = (data[0] & 0x0f) + 1;
+    if (midiChannel != 0 && channel != midiChannel)
+        return false;
+
+    const int type = data[0] & 0xf0;
+    const bool isNoteMessage = type == 0x80 || type == 0x90 || type == 0xa0;
+    if (isNoteMessage && numBytes >= 2)
+        return data[1] >= lowestNote && data[1] <= highestNote;
+
+    return true;
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <optional>
+#include "HostedInstanceSlot.h"
+#include "RealtimeWorkerPool.h"
+
+// Extra hosted Serum instances stacked on top of the primary one. Each layer has
+// its own instance (published through a HostedInstanceSlot), a key range and a
+// MIDI channel filter. Layers render in parallel on a RealtimeWorkerPool while
+// the audio thread renders the primary instance, and are summed into the output
+// with vectorised adds.
+class LayerGraph
+{
+public:
+    static constexpr int maxLayers = 8;
+
+    LayerGraph();
+    ~LayerGraph();
+
+    // Message thread
+    void prepareToPlay(double sampleRate, int samplesPerBlock);
+    int addLayer(std::unique_ptr<juce::AudioPluginInstance> instance);
+    void removeLayer(int layerIndex);
+    void clear();
+    void setKeyRange(int layerIndex, int lowestNote, int highestNote);
+    void setMidiChannel(int layerIndex, int midiChannel); // 0 = omni
+    void setGain(int layerIndex, float gain);
+    juce::Range<int> getKeyRange(int layerIndex) const;   // inclusive
+    int getMidiChannel(int layerIndex) const;
+    float getGain(int layerIndex) const;
+    juce::AudioPluginInstance* getLayerInstance(int layerIndex) const;
+    int getNumLayers() const;
+    void setReclaimHandler(std::function<void(std::unique_ptr<juce::AudioPluginInstance>)> handler);
+
+    // Audio thread. beginRender must see the MIDI before the primary instance
+    // consumes it; finishAndMix waits for the workers, up to most of the block's
+    // length, and sums every layer that finished. A layer that overruns is mixed a
+    // block late instead of holding up the whole output, and the layers sit out
+    // until it is done. MIDI of a block a layer sits out is carried into its next
+    // render, so no note-off is lost.
+    bool beginRender(const juce::MidiBuffer& midiMessages, int numChannels, int numSamples);
+    void finishAndMix(juce::AudioBuffer<float>& output);
+
+private:
+    struct Layer
+    {
+        HostedInstanceSlot slot;
+        std::atomic<int> lowestNote{ 0 };
+        std::atomic<int> highestNote{ 127 };
+        std::atomic<int> midiChannel{ 0 };
+        std::atomic<float> gain{ 1.0f };
+
+        std::atomic<bool> rendered{ false };   // set by the worker once buffer holds this block
+
+        // Audio thread only
+        juce::AudioBuffer<float> buffer;
+        juce::MidiBuffer midi;
+        juce::MidiBuffer carriedMidi;   // from blocks the layer sat out, played at the start of its next render
+        int lateSamples = 0;            // > 0 while buffer holds a late block that is still to be mixed
+        std::optional<HostedInstanceSlot::ReadScope> readScope;
+        juce::AudioPluginInstance* instance = nullptr;
+    };
+
+    static void renderLayerJob(void* context, int jobIndex);
+    void releaseActiveLayers() noexcept;
+    void carryMidi(Layer& layer, const juce::MidiBuffer& midiMessages) noexcept;
+    static bool passesFilter(const juce::uint8* data, int numBytes, int lowestNote, int highestNote, int midiChannel) noexcept;
+
+    std::array<Layer, maxLayers> layers;
+    std::array<int, maxLayers> activeLayers{};
+    int numActiveLayers = 0;
+    std::array<int, maxLayers> lateLayers{};   // late blocks to mix in this callback
+    int numLateLayers = 0;
+    int renderChannels = 0;
+    int renderSamples = 0;
+    juce::int64 renderDeadlineTicks = 0;
+    bool renderRunningLate = false;   // a layer missed the last deadline and is still rendering
+    static constexpr double deadlineFraction = 0.75;   // of the block's length, left for the rest of the callback
+
+    // Created on the first addLayer so sessions without layers start no threads
+    std::unique_ptr<RealtimeWorkerPool> workerPool;
+    std::atomic<RealtimeWorkerPool*> publishedPool{ nullptr };
+    double currentSampleRate = 0.0;
+    int currentBlockSize = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LayerGraph)
+};
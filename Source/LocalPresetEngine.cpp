@@ -0,0 +1,321 @@
+#include "LocalPresetEngine.h"
+#include "PromptCache.h"
+#include <algorithm>
+#include <set>
+
+namespace
+{
+    enum class Modifier
+    {
+        none,
+        stronger,
+        weaker,
+        less,
+        negate
+    };
+
+    Modifier modifierFor(const juce::String& word)
+    {
+        if (word == "very" || word == "super" || word == "extra" || word == "really" || word == "more" || word == "ultra")
+            return Modifier::stronger;
+        if (word == "slightly" || word == "bit" || word == "little" || word == "subtle" || word == "touch" || word == "hint")
+            return Modifier::weaker;
+        if (word == "less")
+            return Modifier::less;
+        if (word == "no" || word == "without" || word == "non")
+            return Modifier::negate;
+        return Modifier::none;
+    }
+
+    // The setting that says how much of a switchable effect is heard, by its enable parameter
+    const char* amountFor(const std::string& toggle)
+    {
+        static const std::map<std::string, const char*> amounts = {
+            { "Rev Enable", "Verb Wet" }, { "Dly Enable", "Dly_Wet" }, { "Cho Enable", "Cho_Wet" },
+            { "Phs Enable", "Phs_Wet" }, { "Flg Enable", "Flg_Wet" }, { "Dist Enable", "Dist_Wet" },
+            { "Comp Enable", "Comp_Wet" }, { "Osc N On", "Noise Level" }
+        };
+        auto it = amounts.find(toggle);
+        return it == amounts.end() ? nullptr : it->second;
+    }
+
+    // "40%" -> "20%" for a scale of 0.5; the unit is kept
+    void scaleAmount(std::string& value, float scale)
+    {
+        const juce::String text(value);
+        const auto number = text.initialSectionContainingOnly("0123456789.-");
+        if (number.isEmpty())
+            return;
+        value = (juce::String(juce::roundToInt(number.getFloatValue() * scale)) + text.substring(number.length())).toStdString();
+    }
+}
+
+LocalPresetEngine::LocalPresetEngine()
+{
+    const auto& rules = getRules();
+    for (int i = 0; i < (int)rules.size(); ++i)
+        for (const auto* keyword : rules[(size_t)i].keywords)
+            keywordIndex.emplace(keyword, i);
+}
+
+bool LocalPresetEngine::compose(const juce::String& prompt, std::map<std::string, std::string>& response) const
+{
+    const auto words = juce::StringArray::fromTokens(PromptCache::canonicalize(prompt), " ", "");
+    const auto& rules = getRules();
+
+    const auto find = [this](const juce::String& word)
+    {
+        auto it = keywordIndex.find(word.toStdString());
+        if (it == keywordIndex.end() && word.length() > 3 && word.endsWithChar('s'))
+            it = keywordIndex.find(word.dropLastCharacters(1).toStdString());   // "plucks", "pads"
+        return it == keywordIndex.end() ? -1 : it->second;
+    };
+
+    // Strongest mention of each rule, in order of first mention
+    std::vector<std::pair<int, float>> matched;
+    std::vector<const char*> switchedOff;
+    std::set<std::string> turnedDown;   // effects asked for "slightly" or "less"
+    Modifier modifier = Modifier::none;
+    for (int i = 0; i < words.size(); ++i)
+    {
+        if (const auto next = modifierFor(words[i]); next != Modifier::none)
+        {
+            // "super saw" is a sound, not an intensity
+            if (!(i + 1 < words.size() && find(words[i] + words[i + 1]) >= 0))
+            {
+                modifier = next;
+                continue;
+            }
+        }
+
+        int rule = i + 1 < words.size() ? find(words[i] + words[i + 1]) : -1;
+        if (rule >= 0)
+            ++i;
+        else
+            rule = find(words[i]);
+        if (rule < 0)
+        {
+            // A modifier reaches past filler words ("a bit of reverb") but not past a second match
+            if (words[i].length() > 4)
+                modifier = Modifier::none;
+            continue;
+        }
+
+        const auto* toggle = rules[(size_t)rule].toggle;
+        if (modifier == Modifier::negate)
+        {
+            if (toggle != nullptr)
+                switchedOff.push_back(toggle);
+        }
+        else if (modifier == Modifier::less && toggle != nullptr)
+        {
+            // "less reverb" turns down reverb another rule brought in, and never switches it on
+            turnedDown.insert(toggle);
+        }
+        else
+        {
+            if (toggle != nullptr && modifier != Modifier::none && modifier != Modifier::stronger)
+                turnedDown.insert(toggle);
+            const float scale = modifier == Modifier::stronger ? 1.5f : modifier == Modifier::none ? 1.0f : 0.6f;
+            const float score = rules[(size_t)rule].weight * scale;
+            auto it = std::find_if(matched.begin(), matched.end(), [rule](const auto& m) { return m.first == rule; });
+            if (it == matched.end())
+                matched.emplace_back(rule, score);
+            else
+                it->second = std::max(it->second, score);
+        }
+        modifier = Modifier::none;
+    }
+
+    if (matched.empty() && switchedOff.empty() && turnedDown.empty())
+        return false;
+
+    // Weakest first so stronger rules overwrite; on a tie the earlier mention is applied last and wins
+    std::reverse(matched.begin(), matched.end());
+    std::stable_sort(matched.begin(), matched.end(), [](const auto& a, const auto& b) { return a.second < b.second; });
+
+    response = getInitPatch();
+    for (const auto& [rule, score] : matched)
+        for (const auto& setting : rules[(size_t)rule].settings)
+            response.insert_or_assign(setting.name, setting.value);
+    for (const auto& toggle : turnedDown)
+    {
+        const auto* amountName = amountFor(toggle);
+        auto enabled = response.find(toggle);
+        auto amount = amountName != nullptr ? response.find(amountName) : response.end();
+        if (enabled != response.end() && enabled->second == "on" && amount != response.end())
+            scaleAmount(amount->second, 0.5f);
+    }
+    for (const auto* toggle : switchedOff)
+        response.insert_or_assign(toggle, "off");
+
+    DBG("Local draft: " << (int)matched.size() << " rules matched, " << (int)switchedOff.size() << " effects switched off");
+    return true;
+}
+
+const std::map<std::string, std::string>& LocalPresetEngine::getInitPatch()
+{
+    // Every parameter the server sends, at its defaults except for a filtered saw,
+    // so rules only name what they change
+    static const std::map<std::string, std::string> init = {
+        { "Env1 Atk", "0.5 ms" }, { "Env1 Hold", "0.0 ms" }, { "Env1 Dec", "1.00 s" }, { "Env1 Sus", "0.0 dB" },
+        { "Env1 Rel", "80 ms" }, { "Osc A On", "on" }, { "A UniDet", "0.25" }, { "A UniBlend", "75" },
+        { "A WTPos", "Saw" }, { "A Pan", "0" }, { "A Vol", "75%" }, { "A Unison", "1" }, { "A Octave", "0 Oct" },
+        { "A Semi", "0 semitones" }, { "A Fine", "0 cents" }, { "Fil Type", "MG Low 24" },
+        { "Fil Cutoff", "2500 Hz" }, { "Fil Reso", "10%" }, { "Filter On", "on" }, { "Fil Driv", "0%" },
+        { "Fil Var", "0%" }, { "Fil Mix", "100%" }, { "OscA>Fil", "on" }, { "OscB>Fil", "off" },
+        { "OscN>Fil", "off" }, { "OscS>Fil", "off" }, { "Osc N On", "off" }, { "Noise Pitch", "50%" },
+        { "Noise Level", "25%" }, { "Osc S On", "off" }, { "Sub Osc Level", "75%" }, { "SubOscOctave", "0 Oct" },
+        { "SubOscShape", "Sine" }, { "Osc B On", "off" }, { "B UniDet", "0.25" }, { "B UniBlend", "75" },
+        { "B WTPos", "1" }, { "B Pan", "0" }, { "B Vol", "75%" }, { "B Unison", "1" }, { "B Octave", "0 Oct" },
+        { "B Semi", "0 semitones" }, { "B Fine", "0 cents" }, { "Hyp Enable", "off" }, { "Hyp_Rate", "40%" },
+        { "Hyp_Detune", "25%" }, { "Hyp_Retrig", "off" }, { "Hyp_Wet", "50%" }, { "Hyp_Unision", "4" },
+        { "HypDim_Size", "50%" }, { "HypDim_Mix", "0%" }, { "Dist Enable", "off" }, { "Dist_Mode", "Tube" },
+        { "Dist_PrePost", "Off" }, { "Dist_Freq", "330 Hz" }, { "Dist_BW", "1.9" }, { "Dist_L/B/H", "0%" },
+        { "Dist_Drv", "25%" }, { "Dist_Wet", "100%" }, { "Flg Enable", "off" }, { "Flg_Rate", "0.08 Hz" },
+        { "Flg_BPM_Sync", "off" }, { "Flg_Dep", "100%" }, { "Flg_Feed", "50%" }, { "Flg_Stereo", "180deg." },
+        { "Flg_Wet", "100%" }, { "Phs Enable", "off" }, { "Phs_Rate", "0.08 Hz" }, { "Phs_BPM_Sync", "off" },
+        { "Phs_Dpth", "50%" }, { "Phs_Frq", "600 Hz" }, { "Phs_Feed", "80%" }, { "Phs_Stereo", "180deg." },
+        { "Phs_Wet", "100%" }, { "Cho Enable", "off" }, { "Cho_Rate", "0.08 Hz" }, { "Cho_BPM_Sync", "off" },
+        { "Cho_Dly", "5.0 ms" }, { "Cho_Dly2", "0.0 ms" }, { "Cho_Dep", "26.0 ms" }, { "Cho_Feed", "10%" },
+        { "Cho_Filt", "1000 Hz" }, { "Cho_Wet", "50%" }, { "Dly Enable", "off" }, { "Dly_Feed", "40%" },
+        { "Dly_BPM_Sync", "on" }, { "Dly_Link", "Unlink" }, { "Dly_TimL", "1/4" }, { "Dly_TimR", "1/4" },
+        { "Dly_BW", "6.8" }, { "Dly_Freq", "849 Hz" }, { "Dly_Mode", "Normal" }, { "Dly_Wet", "30%" },
+        { "Comp Enable", "off" }, { "Cmp_Thr", "-18.1 dB" }, { "Cmp_Att", "90.1 ms" }, { "Cmp_Rel", "90 ms" },
+        { "CmpGain", "0.0 dB" }, { "CmpMBnd", "Normal" }, { "Comp_Wet", "100" }, { "Rev Enable", "off" },
+        { "VerbSize", "35%" }, { "Decay", "4.7 s" }, { "VerbLoCt", "0%" }, { "VerbHiCt", "35%" },
+        { "Spin Rate", "25%" }, { "Verb Wet", "20%" }, { "EQ Enable", "off" }, { "EQ FrqL", "210 Hz" },
+        { "EQ Q L", "60%" }, { "EQ VolL", "0.0 dB" }, { "EQ TypL", "Shelf" }, { "EQ TypeH", "Shelf" },
+        { "EQ FrqH", "2041 Hz" }, { "EQ Q H", "60%" }, { "EQ VolH", "0.0" }, { "FX Fil Enable", "off" },
+        { "FX Fil Type", "MG Low 6" }, { "FX Fil Freq", "330 Hz" }, { "FX Fil Reso", "0%" },
+        { "FX Fil Drive", "0%" }, { "FX Fil Pan", "50%" }, { "FX Fil Wet", "100%" }
+    };
+    return init;
+}
+
+const std::vector<LocalPresetEngine::Rule>& LocalPresetEngine::getRules()
+{
+    // Weights: 1.0 for what the sound is (bass, pad, 808), 0.8 for how it sounds
+    // (dark, wide), 0.6 for effects, so "dark supersaw pad with reverb" keeps the
+    // pad's envelope, the dark filter and the supersaw oscillators together
+    static const std::vector<Rule> rules = {
+        // Instruments
+        { { "pluck", "plucky", "plucked", "pizzicato" }, 1.0f, nullptr, {
+            { "Env1 Atk", "0.0 ms" }, { "Env1 Dec", "180 ms" }, { "Env1 Sus", "-inf dB" }, { "Env1 Rel", "120 ms" },
+            { "Filter On", "on" }, { "Fil Type", "MG Low 24" }, { "Fil Cutoff", "1800 Hz" }, { "Fil Reso", "25%" } } },
+        { { "bass", "bassline", "basses" }, 1.0f, nullptr, {
+            { "Env1 Atk", "0.0 ms" }, { "Env1 Dec", "600 ms" }, { "Env1 Sus", "-6.0 dB" }, { "Env1 Rel", "40 ms" },
+            { "A Octave", "-1 Oct" }, { "Osc S On", "on" }, { "Sub Osc Level", "60%" }, { "SubOscOctave", "-1 Oct" },
+            { "SubOscShape", "Sine" }, { "Fil Cutoff", "900 Hz" } } },
+        { { "808", "boom", "trap" }, 1.0f, nullptr, {
+            { "A WTPos", "Sine" }, { "A Unison", "1" }, { "A Octave", "-2 Oct" },
+            { "Env1 Atk", "0.0 ms" }, { "Env1 Dec", "1.40 s" }, { "Env1 Sus", "-inf dB" }, { "Env1 Rel", "300 ms" },
+            { "Filter On", "off" }, { "Osc S On", "on" }, { "Sub Osc Level", "50%" }, { "SubOscOctave", "-2 Oct" },
+            { "Dist Enable", "on" }, { "Dist_Mode", "Tube" }, { "Dist_Drv", "30%" }, { "Dist_Wet", "60%" } } },
+        { { "supersaw", "trance", "hoover" }, 1.0f, nullptr, {
+            { "A WTPos", "Saw" }, { "A Unison", "9" }, { "A UniDet", "0.35" }, { "A UniBlend", "85" },
+            { "Osc B On", "on" }, { "B WTPos", "Saw" }, { "B Unison", "7" }, { "B UniDet", "0.30" }, { "B Fine", "7 cents" },
+            { "Filter On", "on" }, { "Fil Type", "MG Low 12" }, { "Fil Cutoff", "6000 Hz" } } },
+        { { "lead", "solo", "melody" }, 1.0f, nullptr, {
+            { "Env1 Atk", "2.0 ms" }, { "Env1 Sus", "-3.0 dB" }, { "Env1 Rel", "180 ms" },
+            { "A Unison", "3" }, { "A UniDet", "0.15" }, { "Fil Cutoff", "4500 Hz" }, { "Fil Reso", "20%" },
+            { "Dly Enable", "on" }, { "Dly_Wet", "18%" } } },
+        { { "pad", "atmosphere", "atmospheric", "strings" }, 1.0f, nullptr, {
+            { "Env1 Atk", "800 ms" }, { "Env1 Dec", "2.00 s" }, { "Env1 Sus", "-3.0 dB" }, { "Env1 Rel", "2.50 s" },
+            { "A Unison", "7" }, { "A UniDet", "0.30" }, { "Osc B On", "on" }, { "B WTPos", "Triangle" }, { "B Unison", "5" },
+            { "Fil Cutoff", "2200 Hz" }, { "Rev Enable", "on" }, { "Verb Wet", "35%" }, { "VerbSize", "70%" },
+            { "Decay", "6.0 s" }, { "Cho Enable", "on" }, { "Cho_Wet", "40%" } } },
+        { { "keys", "piano", "ep", "rhodes", "organ" }, 1.0f, nullptr, {
+            { "Env1 Atk", "1.0 ms" }, { "Env1 Dec", "1.20 s" }, { "Env1 Sus", "-12.0 dB" }, { "Env1 Rel", "350 ms" },
+            { "A WTPos", "Triangle" }, { "Osc B On", "on" }, { "B WTPos", "Sine" }, { "B Octave", "+1 Oct" },
+            { "B Vol", "35%" }, { "Fil Cutoff", "3000 Hz" } } },
+        { { "stab", "chord", "chords", "house" }, 1.0f, nullptr, {
+            { "Env1 Atk", "0.0 ms" }, { "Env1 Dec", "350 ms" }, { "Env1 Sus", "-inf dB" }, { "Env1 Rel", "200 ms" },
+            { "A Unison", "5" }, { "A UniDet", "0.20" }, { "Rev Enable", "on" }, { "Verb Wet", "18%" } } },
+        { { "arp", "arpeggio", "arpeggiated", "sequence" }, 1.0f, nullptr, {
+            { "Env1 Atk", "0.0 ms" }, { "Env1 Dec", "250 ms" }, { "Env1 Sus", "-18.0 dB" }, { "Env1 Rel", "150 ms" },
+            { "Dly Enable", "on" }, { "Dly_BPM_Sync", "on" }, { "Dly_TimL", "1/8" }, { "Dly_TimR", "1/8" },
+            { "Dly_Wet", "25%" }, { "Dly_Mode", "Ping-Pong" } } },
+        { { "drone", "texture", "soundscape", "cinematic" }, 1.0f, nullptr, {
+            { "Env1 Atk", "2.00 s" }, { "Env1 Sus", "0.0 dB" }, { "Env1 Rel", "4.00 s" },
+            { "Osc N On", "on" }, { "Noise Level", "20%" }, { "OscN>Fil", "on" }, { "Phs Enable", "on" },
+            { "Rev Enable", "on" }, { "Verb Wet", "45%" }, { "Decay", "10.0 s" } } },
+        { { "bell", "bells", "metallic", "glassy", "fm" }, 1.0f, nullptr, {
+            { "A WTPos", "Sine" }, { "A Unison", "1" }, { "Osc B On", "on" }, { "B WTPos", "Sine" }, { "B Semi", "+7 semitones" },
+            { "Env1 Atk", "0.0 ms" }, { "Env1 Dec", "1.50 s" }, { "Env1 Sus", "-inf dB" }, { "Env1 Rel", "1.20 s" },
+            { "Filter On", "on" }, { "Fil Type", "Ring Mod" }, { "Fil Mix", "50%" } } },
+        { { "chiptune", "8bit", "lofi", "bitcrushed", "retro" }, 1.0f, "Dist Enable", {
+            { "A WTPos", "Square" }, { "A Unison", "1" }, { "Filter On", "off" },
+            { "Dist Enable", "on" }, { "Dist_Mode", "Downsample" }, { "Dist_Drv", "40%" }, { "Dist_Wet", "100%" } } },
+
+        // Character
+        { { "sub", "subby", "deep" }, 0.8f, nullptr, {
+            { "Osc S On", "on" }, { "Sub Osc Level", "80%" }, { "SubOscShape", "Sine" }, { "SubOscOctave", "-1 Oct" },
+            { "A Octave", "-1 Oct" } } },
+        { { "dark", "darker", "moody", "muffled", "murky" }, 0.8f, nullptr, {
+            { "Filter On", "on" }, { "Fil Type", "MG Low 24" }, { "Fil Cutoff", "450 Hz" }, { "Fil Reso", "10%" },
+            { "VerbHiCt", "70%" } } },
+        { { "bright", "brighter", "crisp", "shiny", "sparkly" }, 0.8f, nullptr, {
+            { "Filter On", "on" }, { "Fil Type", "MG Low 12" }, { "Fil Cutoff", "9000 Hz" },
+            { "EQ Enable", "on" }, { "EQ VolH", "4.0 dB" } } },
+        { { "warm", "analog", "vintage", "mellow" }, 0.8f, nullptr, {
+            { "Fil Type", "MG Low 24" }, { "Fil Cutoff", "1200 Hz" }, { "Fil Driv", "20%" }, { "A UniDet", "0.12" },
+            { "Dist Enable", "on" }, { "Dist_Mode", "Tube" }, { "Dist_Drv", "12%" }, { "Dist_Wet", "50%" } } },
+        { { "wide", "stereo", "huge", "big", "massive" }, 0.8f, nullptr, {
+            { "A Unison", "7" }, { "A UniDet", "0.30" }, { "A UniBlend", "90" },
+            { "Hyp Enable", "on" }, { "HypDim_Size", "60%" }, { "HypDim_Mix", "40%" },
+            { "Cho Enable", "on" }, { "Cho_Wet", "35%" } } },
+        { { "detuned", "detune", "thick", "fat" }, 0.8f, nullptr, {
+            { "A Unison", "5" }, { "A UniDet", "0.40" }, { "Osc B On", "on" }, { "B WTPos", "Saw" }, { "B Fine", "12 cents" } } },
+        { { "distorted", "distortion", "dirty", "gritty", "grit", "aggressive", "growl", "crunchy", "saturated" },
+            0.8f, "Dist Enable", {
+            { "Dist Enable", "on" }, { "Dist_Mode", "HardClip" }, { "Dist_Drv", "55%" }, { "Dist_Wet", "80%" },
+            { "Fil Driv", "40%" } } },
+        // There is no LFO in the response format, so the wobble is a fast, deep phaser over a resonant low-pass
+        { { "wobble", "wobbly", "dubstep", "wub" }, 0.8f, nullptr, {
+            { "A Octave", "-1 Oct" }, { "Filter On", "on" }, { "Fil Type", "MG Low 24" }, { "Fil Cutoff", "600 Hz" },
+            { "Fil Reso", "45%" }, { "Phs Enable", "on" }, { "Phs_Rate", "2.00 Hz" }, { "Phs_Dpth", "90%" },
+            { "Phs_Feed", "70%" }, { "Phs_Wet", "100%" }, { "Dist Enable", "on" }, { "Dist_Drv", "45%" } } },
+        { { "acid", "303", "squelchy", "resonant" }, 0.8f, nullptr, {
+            { "A WTPos", "Saw" }, { "Filter On", "on" }, { "Fil Type", "MG Low 24" }, { "Fil Cutoff", "800 Hz" },
+            { "Fil Reso", "70%" }, { "Fil Driv", "30%" }, { "Env1 Dec", "300 ms" }, { "Env1 Sus", "-12.0 dB" } } },
+        { { "soft", "gentle", "smooth", "calm" }, 0.8f, nullptr, {
+            { "Env1 Atk", "60 ms" }, { "Env1 Rel", "600 ms" }, { "Fil Cutoff", "1500 Hz" }, { "Fil Reso", "5%" } } },
+        { { "punchy", "tight", "snappy", "percussive" }, 0.8f, nullptr, {
+            { "Env1 Atk", "0.0 ms" }, { "Env1 Dec", "220 ms" }, { "Env1 Sus", "-12.0 dB" }, { "Env1 Rel", "60 ms" },
+            { "Comp Enable", "on" }, { "Cmp_Thr", "-20.0 dB" }, { "Comp_Wet", "100" } } },
+        { { "airy", "breathy", "noise", "noisy", "wind" }, 0.8f, "Osc N On", {
+            { "Osc N On", "on" }, { "Noise Level", "30%" }, { "OscN>Fil", "on" }, { "Fil Cutoff", "7000 Hz" } } },
+        { { "short", "staccato" }, 0.8f, nullptr, {
+            { "Env1 Dec", "150 ms" }, { "Env1 Sus", "-inf dB" }, { "Env1 Rel", "50 ms" } } },
+        { { "long", "sustained", "evolving" }, 0.8f, nullptr, {
+            { "Env1 Sus", "0.0 dB" }, { "Env1 Rel", "1.50 s" } } },
+        { { "swell", "swelling", "slow" }, 0.8f, nullptr, {
+            { "Env1 Atk", "1.20 s" }, { "Env1 Rel", "1.00 s" } } },
+        { { "high", "higher" }, 0.8f, nullptr, { { "A Octave", "+1 Oct" } } },
+        { { "low", "lower" }, 0.8f, nullptr, { { "A Octave", "-1 Oct" } } },
+        { { "saw", "sawtooth" }, 0.8f, nullptr, { { "A WTPos", "Saw" } } },
+        { { "sine", "pure" }, 0.8f, nullptr, { { "A WTPos", "Sine" }, { "A Unison", "1" } } },
+        { { "triangle", "flute" }, 0.8f, nullptr, { { "A WTPos", "Triangle" } } },
+        { { "square", "hollow" }, 0.8f, nullptr, { { "A WTPos", "Square" } } },
+        { { "pulse", "reedy", "nasal" }, 0.8f, nullptr, { { "A WTPos", "Pulse" } } },
+
+        // Effects
+        { { "reverb", "verb", "spacey", "spacious", "ambient", "hall", "ethereal" }, 0.6f, "Rev Enable", {
+            { "Rev Enable", "on" }, { "Verb Wet", "40%" }, { "VerbSize", "75%" }, { "Decay", "7.0 s" } } },
+        { { "delay", "echo", "echoes", "dub" }, 0.6f, "Dly Enable", {
+            { "Dly Enable", "on" }, { "Dly_Wet", "30%" }, { "Dly_Feed", "45%" }, { "Dly_BPM_Sync", "on" },
+            { "Dly_TimL", "1/4" }, { "Dly_TimR", "1/8" } } },
+        { { "chorus", "lush", "shimmer" }, 0.6f, "Cho Enable", {
+            { "Cho Enable", "on" }, { "Cho_Wet", "50%" }, { "Cho_Rate", "0.40 Hz" } } },
+        { { "phaser", "phased", "swirly" }, 0.6f, "Phs Enable", {
+            { "Phs Enable", "on" }, { "Phs_Rate", "0.30 Hz" }, { "Phs_Wet", "60%" } } },
+        { { "flanger", "flanged", "jet" }, 0.6f, "Flg Enable", {
+            { "Flg Enable", "on" }, { "Flg_Rate", "0.20 Hz" }, { "Flg_Feed", "60%" }, { "Flg_Wet", "60%" } } },
+        { { "compressed", "compression", "glued" }, 0.6f, "Comp Enable", {
+            { "Comp Enable", "on" }, { "Cmp_Thr", "-24.0 dB" }, { "CmpGain", "6.0 dB" } } },
+        { { "dry", "clean" }, 0.6f, nullptr, {
+            { "Rev Enable", "off" }, { "Dly Enable", "off" }, { "Cho Enable", "off" }, { "Dist Enable", "off" } } },
+    };
+    return rules;
+}
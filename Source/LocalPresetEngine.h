@@ -0,0 +1,47 @@
+#pragma once
+#include <JuceHeader.h>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Offline prompt-to-patch generation. The prompt is tokenized and each word (or
+// word pair, so "super saw" reads as "supersaw") is looked up in a curated,
+// weighted rule library; the matched rules are layered over an init patch,
+// strongest last, so where two rules set the same parameter the stronger one
+// wins. "very"/"slightly" scale the weight of the word that follows, and
+// "no"/"without" switch the named effect off instead.
+// The result uses the same names and text values the server returns ("Env1 Atk":
+// "0.0 ms"), so it goes through the normalizer and the response list unchanged.
+// Lookup is a hash per token and composition one map copy, well under a millisecond.
+class LocalPresetEngine
+{
+public:
+    LocalPresetEngine();
+
+    // Fills response with a complete patch; returns false (and leaves it alone)
+    // when no word of the prompt is in the library
+    bool compose(const juce::String& prompt, std::map<std::string, std::string>& response) const;
+
+private:
+    struct Setting
+    {
+        const char* name;
+        const char* value;
+    };
+
+    struct Rule
+    {
+        std::vector<const char*> keywords;
+        float weight;
+        const char* toggle;   // the effect's enable parameter, switched off by "no <keyword>"; may be null
+        std::vector<Setting> settings;
+    };
+
+    static const std::vector<Rule>& getRules();
+    static const std::map<std::string, std::string>& getInitPatch();
+
+    std::unordered_map<std::string, int> keywordIndex;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LocalPresetEngine)
+};
@@ -1,5 +1,6 @@
 #pragma once
 #include <JuceHeader.h>
+#include "ApiClient.h"
 
 class LoginComponent : public juce::Component, public juce::Thread, public juce::Timer
 {
@@ -45,6 +46,7 @@ public:
 
     ~LoginComponent() override
     {
+        api->cancel(pendingRequest);
         stopTimer();
         cancelButton.setLookAndFeel(nullptr);
         signalThreadShouldExit();
@@ -261,6 +263,8 @@ private:
     juce::URL cognitoUrl;
     std::unique_ptr<juce::StreamingSocket> serverSocket;
     juce::ApplicationProperties appProps;
+    juce::SharedResourcePointer<ApiClient> api;
+    ApiClient::RequestId pendingRequest = 0;
 
     juce::String urlEncode(const juce::String& input)
     {
@@ -283,27 +287,30 @@ private:
     void handleAuthCode(const juce::String& code)
     {
         DBG("Handling auth code: " + code);
-        juce::URL loginUrl("https://ydr97n8vxe.execute-api.us-east-2.amazonaws.com/prod/login");
 
         // Create JSON body
         juce::DynamicObject::Ptr jsonObject = new juce::DynamicObject();
         jsonObject->setProperty("code", code);
         jsonObject->setProperty("redirect_uri", "http://localhost:8000/callback");
-        juce::String postData = juce::JSON::toString(jsonObject.get());
-        DBG("Sending POST request to /login with JSON data: " + postData);
 
-        // Set POST data and headers directly on the URL
-        juce::URL urlWithPostData = loginUrl.withPOSTData(postData);
-
-        auto options = juce::URL::InputStreamOptions(juce::URL::ParameterHandling::inAddress)
-            .withExtraHeaders("Content-Type: application/json")
-            .withConnectionTimeoutMs(50000);
-
-        std::unique_ptr<juce::InputStream> stream(urlWithPostData.createInputStream(options));
+        ApiClient::Request request;
+        request.path = "/login";
+        request.jsonBody = juce::JSON::toString(jsonObject.get());
+        request.timeoutMs = 50000;
+        DBG("Sending POST request to /login with JSON data: " + request.jsonBody);
+
+        api->cancel(pendingRequest);
+        pendingRequest = api->send(std::move(request), [this](const ApiClient::Response& response) {
+            pendingRequest = 0;
+            handleLoginResponse(response);
+        });
+    }
 
-        if (stream != nullptr)
+    void handleLoginResponse(const ApiClient::Response& apiResponse)
+    {
+        if (apiResponse.connected)
         {
-            juce::String response = stream->readEntireStreamAsString();
+            juce::String response = apiResponse.body;
             DBG("Raw response from /login endpoint: " + response);
             juce::var result = juce::JSON::parse(response);
             DBG("Parsed JSON response: " + juce::JSON::toString(result));
@@ -314,36 +321,10 @@ private:
 
             if (accessToken.isNotEmpty() && idToken.isNotEmpty())
             {
-                int credits = fetchUserCredits(accessToken);
-                DBG("Credits fetched: " + juce::String(credits));
-                
-                // Save with explicit save operations
-                appProps.getUserSettings()->setValue("isLoggedIn", true);
-                appProps.getUserSettings()->setValue("accessToken", accessToken);
-                appProps.getUserSettings()->setValue("idToken", idToken);
-                appProps.getUserSettings()->setValue("credits", credits);
-                appProps.getUserSettings()->saveIfNeeded();
-                appProps.getUserSettings()->save();  // Force save
-                
-                // Validate save was successful
-                juce::String savedToken = appProps.getUserSettings()->getValue("accessToken", "");
-                juce::String savedIdToken = appProps.getUserSettings()->getValue("idToken", "");
-                bool savedLoginState = appProps.getUserSettings()->getBoolValue("isLoggedIn", false);
-                DBG("LoginComponent validation - saved access token length: " << savedToken.length()
-                    << ", saved ID token length: " << savedIdToken.length()
-                    << ", isLoggedIn: " << (savedLoginState ? "true" : "false"));
-                
-                if (onLoginSuccess)
-                {
-                    DBG("Triggering onLoginSuccess with token length: " << accessToken.length());
-                    onLoginSuccess(accessToken, credits);
-                    setVisible(false);
-                    if (getParentComponent())
-                    {
-                        getParentComponent()->repaint();
-                        getParentComponent()->resized();
-                    }
-                }
+                fetchUserCredits(accessToken, [this, accessToken, idToken](int credits) {
+                    DBG("Credits fetched: " + juce::String(credits));
+                    completeLogin(accessToken, idToken, credits);
+                });
             }
             else
             {
@@ -364,20 +345,57 @@ private:
         }
     }
 
-    int fetchUserCredits(const juce::String& accessToken)
+    void completeLogin(const juce::String& accessToken, const juce::String& idToken, int credits)
+    {
+        // Save with explicit save operations
+        appProps.getUserSettings()->setValue("isLoggedIn", true);
+        appProps.getUserSettings()->setValue("accessToken", accessToken);
+        appProps.getUserSettings()->setValue("idToken", idToken);
+        appProps.getUserSettings()->setValue("credits", credits);
+        appProps.getUserSettings()->saveIfNeeded();
+        appProps.getUserSettings()->save();  // Force save
+
+        // Validate save was successful
+        juce::String savedToken = appProps.getUserSettings()->getValue("accessToken", "");
+        juce::String savedIdToken = appProps.getUserSettings()->getValue("idToken", "");
+        bool savedLoginState = appProps.getUserSettings()->getBoolValue("isLoggedIn", false);
+        DBG("LoginComponent validation - saved access token length: " << savedToken.length()
+            << ", saved ID token length: " << savedIdToken.length()
+            << ", isLoggedIn: " << (savedLoginState ? "true" : "false"));
+
+        if (onLoginSuccess)
+        {
+            DBG("Triggering onLoginSuccess with token length: " << accessToken.length());
+            onLoginSuccess(accessToken, credits);
+            setVisible(false);
+            if (getParentComponent())
+            {
+                getParentComponent()->repaint();
+                getParentComponent()->resized();
+            }
+        }
+    }
+
+    void fetchUserCredits(const juce::String& accessToken, std::function<void(int)> onFetched)
     {
         DBG("Fetching user credits with access token: " + accessToken);
-        juce::URL url("https://ydr97n8vxe.execute-api.us-east-2.amazonaws.com/prod/get-credits");
 
-        auto options = juce::URL::InputStreamOptions(juce::URL::ParameterHandling::inPostData)
-            .withExtraHeaders("Authorization: Bearer " + accessToken)
-            .withConnectionTimeoutMs(5000);
+        ApiClient::Request request;
+        request.path = "/get-credits";
+        request.accessToken = accessToken;
+        request.timeoutMs = 5000;
 
-        std::unique_ptr<juce::InputStream> stream(url.createInputStream(options));
+        pendingRequest = api->send(std::move(request), [this, onFetched](const ApiClient::Response& response) {
+            pendingRequest = 0;
+            onFetched(parseCredits(response));
+        });
+    }
 
-        if (stream != nullptr)
+    static int parseCredits(const ApiClient::Response& apiResponse)
+    {
+        if (apiResponse.connected)
         {
-            juce::String response = stream->readEntireStreamAsString();
+            juce::String response = apiResponse.body;
             DBG("Received response from /get-credits endpoint: " + response);
             juce::var result = juce::JSON::parse(response);
             
@@ -0,0 +1,149 @@
+#include "MorphEngine.h"
+#include <algorithm>
+#include <cmath>
+
+MorphEngine::MorphEngine()
+{
+    startTimer(100);
+}
+
+MorphEngine::~MorphEngine()
+{
+    stopTimer();
+    // processBlock is no longer called, so every plan can be freed here
+    delete pendingPlan.exchange(nullptr);
+    delete retiredPlan.exchange(nullptr);
+    delete activePlan;
+    activePlan = nullptr;
+}
+
+void MorphEngine::createParameters(juce::AudioProcessor& processor)
+{
+    processor.addParameter(morphX = new juce::AudioParameterFloat(juce::ParameterID{ "morphX", 1 }, "Morph X", 0.0f, 1.0f, 0.0f));
+    processor.addParameter(morphY = new juce::AudioParameterFloat(juce::ParameterID{ "morphY", 1 }, "Morph Y", 0.0f, 1.0f, 0.0f));
+    processor.addParameter(morphEnabled = new juce::AudioParameterBool(juce::ParameterID{ "morphOn", 1 }, "Morph On", false));
+}
+
+void MorphEngine::setSources(std::vector<int> parameterIndices, std::vector<std::vector<float>> sources)
+{
+    const size_t numSources = sources.size();
+    if (numSources < 2 || numSources > (size_t)maxSources)
+    {
+        DBG("MorphEngine needs 2-" << maxSources << " sources, got " << (int)numSources);
+        return;
+    }
+
+    const size_t numParameters = parameterIndices.size();
+    for (const auto& source : sources)
+        if (source.size() != numParameters)
+            return;
+
+    auto plan = std::make_unique<Plan>();
+    plan->parameterIndices = std::move(parameterIndices);
+
+    // Fewer than four sources reuse corners: two blend along X, a third sits along the top edge
+    static constexpr std::array<std::array<size_t, maxSources>, maxSources + 1> cornerSource{ {
+        { 0, 0, 0, 0 }, { 0, 0, 0, 0 }, { 0, 1, 0, 1 }, { 0, 1, 2, 2 }, { 0, 1, 2, 3 } } };
+    for (size_t corner = 0; corner < (size_t)maxSources; ++corner)
+        plan->cornerValues[corner] = sources[cornerSource[numSources][corner]];
+
+    plan->mixed.resize(numParameters);
+    plan->lastPushed.resize(numParameters);
+    plan->changedIndices.resize(numParameters);
+    plan->changedValues.resize(numParameters);
+
+    DBG("MorphEngine plan: " << (int)numSources << " sources over " << (int)numParameters << " parameters");
+    clearRequested = false;
+    // The audio thread only takes a plan by exchanging the pointer, so a plan
+    // still waiting here has never been read and can be replaced
+    delete pendingPlan.exchange(plan.release());
+    planLoaded = true;
+}
+
+void MorphEngine::clear()
+{
+    delete pendingPlan.exchange(nullptr);
+    clearRequested = true;
+    planLoaded = false;
+}
+
+void MorphEngine::setEnabled(bool shouldBeEnabled)
+{
+    if (morphEnabled != nullptr)
+        morphEnabled->setValueNotifyingHost(shouldBeEnabled ? 1.0f : 0.0f);
+}
+
+void MorphEngine::computeWeights(float x, float y, std::array<float, maxSources>& weights) const noexcept
+{
+    weights[0] = (1.0f - x) * (1.0f - y);
+    weights[1] = x * (1.0f - y);
+    weights[2] = (1.0f - x) * y;
+    weights[3] = x * y;
+}
+
+int MorphEngine::process() noexcept
+{
+    // Hand-overs wait until the message thread has freed the previous plan
+    if (retiredPlan.load() == nullptr)
+    {
+        if (clearRequested.exchange(false))
+        {
+            retiredPlan.store(activePlan);
+            activePlan = nullptr;
+        }
+        else if (pendingPlan.load() != nullptr)
+        {
+            if (auto* next = pendingPlan.exchange(nullptr))
+            {
+                retiredPlan.store(activePlan);
+                activePlan = next;
+                planChanged = true;
+            }
+        }
+    }
+
+    if (activePlan == nullptr || morphEnabled == nullptr || !morphEnabled->get())
+    {
+        planChanged = true; // push everything again when the morph is switched back on
+        return 0;
+    }
+
+    const float x = morphX->get();
+    const float y = morphY->get();
+    if (!planChanged && x == lastX && y == lastY)
+        return 0;
+
+    auto& plan = *activePlan;
+    if (planChanged)
+        std::fill(plan.lastPushed.begin(), plan.lastPushed.end(), -1.0f);
+    planChanged = false;
+    lastX = x;
+    lastY = y;
+
+    const int numParameters = (int)plan.parameterIndices.size();
+    std::array<float, maxSources> weights;
+    computeWeights(x, y, weights);
+
+    juce::FloatVectorOperations::copyWithMultiply(plan.mixed.data(), plan.cornerValues[0].data(), weights[0], numParameters);
+    for (size_t corner = 1; corner < (size_t)maxSources; ++corner)
+        if (weights[corner] > 0.0f)
+            juce::FloatVectorOperations::addWithMultiply(plan.mixed.data(), plan.cornerValues[corner].data(), weights[corner], numParameters);
+
+    int numChanged = 0;
+    for (int i = 0; i < numParameters; ++i)
+    {
+        if (std::abs(plan.mixed[(size_t)i] - plan.lastPushed[(size_t)i]) > pushThreshold)
+        {
+            plan.lastPushed[(size_t)i] = plan.mixed[(size_t)i];
+            plan.changedIndices[(size_t)numChanged] = plan.parameterIndices[(size_t)i];
+            plan.changedValues[(size_t)numChanged] = plan.mixed[(size_t)i];
+            ++numChanged;
+        }
+    }
+    return numChanged;
+}
+
+void MorphEngine::timerCallback()
+{
+    delete retiredPlan.exchange(nullptr);
+}
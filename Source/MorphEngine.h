@@ -0,0 +1,69 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+// Blends 2-4 stored responses from host-automatable XY parameters. Each
+// response is flattened on the message thread into a dense value array over the
+// union of the parameters they touch; the audio thread mixes those arrays with
+// vectorised multiply-adds once per block, only when the XY position or the
+// plan has changed, and hands back just the values that actually moved.
+class MorphEngine : private juce::Timer
+{
+public:
+    static constexpr int maxSources = 4;
+
+    struct Plan
+    {
+        std::vector<int> parameterIndices;
+        // Corners in XY order: (0,0), (1,0), (0,1), (1,1)
+        std::array<std::vector<float>, maxSources> cornerValues;
+
+        // Audio thread scratch, allocated with the plan
+        std::vector<float> mixed;
+        std::vector<float> lastPushed;
+        std::vector<int> changedIndices;
+        std::vector<float> changedValues;
+    };
+
+    MorphEngine();
+    ~MorphEngine() override;
+
+    // Message thread
+    void createParameters(juce::AudioProcessor& processor);
+    // sources holds one flat value array per response, aligned with parameterIndices
+    void setSources(std::vector<int> parameterIndices, std::vector<std::vector<float>> sources);
+    void clear();
+    void setEnabled(bool shouldBeEnabled);
+    bool hasPlan() const noexcept { return planLoaded.load(); }
+
+    // Audio thread: returns the number of parameters to push this block
+    int process() noexcept;
+    const int* getChangedIndices() const noexcept { return activePlan->changedIndices.data(); }
+    const float* getChangedValues() const noexcept { return activePlan->changedValues.data(); }
+
+private:
+    void timerCallback() override;
+    void computeWeights(float x, float y, std::array<float, maxSources>& weights) const noexcept;
+
+    juce::AudioParameterFloat* morphX = nullptr;
+    juce::AudioParameterFloat* morphY = nullptr;
+    juce::AudioParameterBool* morphEnabled = nullptr;
+
+    std::atomic<Plan*> pendingPlan{ nullptr };
+    std::atomic<Plan*> retiredPlan{ nullptr };
+    std::atomic<bool> clearRequested{ false };
+    std::atomic<bool> planLoaded{ false };
+
+    // Audio thread only
+    Plan* activePlan = nullptr;
+    float lastX = -1.0f;
+    float lastY = -1.0f;
+    bool planChanged = false;
+
+    static constexpr float pushThreshold = 1.0e-5f;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MorphEngine)
+};
@@ -0,0 +1,195 @@
+#include "OutputMeter.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+OutputMeter::OutputMeter()
+{
+    bandLevels.fill(floorDb);
+    setInterceptsMouseClicks(false, false);
+    fifoBuffer.clear();
+}
+
+OutputMeter::~OutputMeter()
+{
+    stopTimer();
+}
+
+void OutputMeter::prepare(double sampleRate)
+{
+    currentSampleRate = sampleRate;
+}
+
+void OutputMeter::push(const juce::AudioBuffer<float>& block) noexcept
+{
+    if (!active.load(std::memory_order_relaxed))
+        return;
+
+    const int numSamples = block.getNumSamples();
+    const int numChannels = block.getNumChannels();
+    if (numSamples == 0 || numChannels == 0 || fifo.getFreeSpace() < numSamples)
+        return;
+
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+    for (int channel = 0; channel < 2; ++channel)
+    {
+        const auto* source = block.getReadPointer(juce::jmin(channel, numChannels - 1));
+        if (size1 > 0)
+            fifoBuffer.copyFrom(channel, start1, source, size1);
+        if (size2 > 0)
+            fifoBuffer.copyFrom(channel, start2, source + size1, size2);
+    }
+    fifo.finishedWrite(size1 + size2);
+}
+
+void OutputMeter::visibilityChanged()
+{
+    updateActive();
+}
+
+void OutputMeter::parentHierarchyChanged()
+{
+    updateActive();
+}
+
+void OutputMeter::updateActive()
+{
+    // Visibility of an ancestor raises no callback here, so the timer keeps polling
+    // while the meter sits in a window and this catches up on its next tick
+    const bool showing = isShowing();
+    if (showing && !active.load())
+    {
+        fifo.finishedRead(fifo.getNumReady());   // drop whatever was left from before it was hidden
+        std::fill(history.begin(), history.end(), 0.0f);
+    }
+    active = showing;
+
+    if (getPeer() != nullptr && !isTimerRunning())
+        startTimerHz(frameRateHz);
+    else if (getPeer() == nullptr)
+        stopTimer();
+}
+
+void OutputMeter::readFifo(int numReady, float& blockPeak, double& sumSquares)
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(numReady, start1, size1, start2, size2);
+    for (auto [start, size] : { std::pair<int, int>{ start1, size1 }, std::pair<int, int>{ start2, size2 } })
+    {
+        if (size == 0)
+            continue;
+        const auto* left = fifoBuffer.getReadPointer(0, start);
+        const auto* right = fifoBuffer.getReadPointer(1, start);
+        for (int i = 0; i < size; ++i)
+        {
+            blockPeak = juce::jmax(blockPeak, std::abs(left[i]), std::abs(right[i]));
+            sumSquares += 0.5 * ((double)left[i] * left[i] + (double)right[i] * right[i]);
+            history[(size_t)historyPosition] = 0.5f * (left[i] + right[i]);
+            historyPosition = (historyPosition + 1) % fftSize;
+        }
+    }
+    fifo.finishedRead(size1 + size2);
+}
+
+void OutputMeter::timerCallback()
+{
+    updateActive();
+    if (!active.load())
+        return;
+
+    float blockPeak = 0.0f;
+    double sumSquares = 0.0;
+    const int numReady = fifo.getNumReady();
+    if (numReady > 0)
+        readFifo(numReady, blockPeak, sumSquares);
+
+    // Levels fall back smoothly and jump up immediately
+    const float newPeakDb = juce::Decibels::gainToDecibels(blockPeak, floorDb);
+    const float newRmsDb = numReady > 0 ? juce::Decibels::gainToDecibels((float)std::sqrt(sumSquares / numReady), floorDb) : floorDb;
+    peakDb = juce::jmax(newPeakDb, peakDb - decayDbPerFrame);
+    rmsDb = juce::jmax(newRmsDb, rmsDb - decayDbPerFrame);
+
+    if (numReady > 0)
+    {
+        analyseSpectrum();
+    }
+    else
+    {
+        for (auto& level : bandLevels)
+            level = juce::jmax(floorDb, level - decayDbPerFrame);
+    }
+
+    const bool anythingVisible = peakDb > floorDb || std::any_of(bandLevels.begin(), bandLevels.end(), [](float level) { return level > floorDb; });
+    if (numReady > 0 || anythingVisible)
+        repaint();
+}
+
+void OutputMeter::analyseSpectrum()
+{
+    // Unroll the circular history so the newest sample is last
+    for (int i = 0; i < fftSize; ++i)
+        fftData[(size_t)i] = history[(size_t)((historyPosition + i) % fftSize)];
+    std::fill(fftData.begin() + fftSize, fftData.end(), 0.0f);
+    window.multiplyWithWindowingTable(fftData.data(), (size_t)fftSize);
+    fft.performFrequencyOnlyForwardTransform(fftData.data(), true);
+
+    // Hann window halves the amplitude; one-sided spectrum doubles it
+    const float scale = 4.0f / (float)fftSize;
+    const double sampleRate = currentSampleRate.load();
+    const double binWidth = sampleRate / fftSize;
+    const double lowHz = 20.0;
+    const double highHz = juce::jmin(20000.0, sampleRate * 0.5);
+
+    for (int band = 0; band < numBands; ++band)
+    {
+        const double fromHz = lowHz * std::pow(highHz / lowHz, (double)band / numBands);
+        const double toHz = lowHz * std::pow(highHz / lowHz, (double)(band + 1) / numBands);
+        const int fromBin = juce::jlimit(1, fftSize / 2 - 1, (int)(fromHz / binWidth));
+        const int toBin = juce::jlimit(fromBin, fftSize / 2 - 1, (int)(toHz / binWidth));
+
+        float magnitude = 0.0f;
+        for (int bin = fromBin; bin <= toBin; ++bin)
+            magnitude = juce::jmax(magnitude, fftData[(size_t)bin]);
+
+        const float levelDb = juce::Decibels::gainToDecibels(magnitude * scale, floorDb);
+        bandLevels[(size_t)band] = juce::jmax(levelDb, bandLevels[(size_t)band] - decayDbPerFrame);
+    }
+}
+
+void OutputMeter::paint(juce::Graphics& g)
+{
+    auto bounds = getLocalBounds().toFloat();
+    g.setColour(juce::Colours::black.withAlpha(0.8f));
+    g.fillRect(bounds);
+
+    auto meterArea = bounds.reduced(4.0f);
+    auto levelArea = meterArea.removeFromBottom(12.0f);
+    meterArea.removeFromBottom(4.0f);
+
+    // Spectrum
+    const float bandWidth = meterArea.getWidth() / (float)numBands;
+    g.setColour(juce::Colours::white);
+    for (int band = 0; band < numBands; ++band)
+    {
+        const float proportion = juce::jmap(bandLevels[(size_t)band], floorDb, 0.0f, 0.0f, 1.0f);
+        const float height = meterArea.getHeight() * juce::jlimit(0.0f, 1.0f, proportion);
+        g.fillRect(meterArea.getX() + band * bandWidth, meterArea.getBottom() - height, juce::jmax(1.0f, bandWidth - 1.0f), height);
+    }
+
+    // RMS bar with the peak as a tick, plus the peak readout
+    auto textArea = levelArea.removeFromRight(56.0f);
+    const auto toX = [&levelArea](float decibels) {
+        return levelArea.getX() + levelArea.getWidth() * juce::jlimit(0.0f, 1.0f, juce::jmap(decibels, floorDb, 0.0f, 0.0f, 1.0f));
+        };
+    g.setColour(juce::Colours::darkgrey);
+    g.fillRect(levelArea);
+    g.setColour(juce::Colours::white);
+    g.fillRect(levelArea.withRight(toX(rmsDb)));
+    g.setColour(peakDb > -0.1f ? juce::Colours::red : juce::Colours::lightgrey);
+    g.fillRect(toX(peakDb) - 1.0f, levelArea.getY(), 2.0f, levelArea.getHeight());
+
+    g.setColour(juce::Colours::white);
+    g.setFont(juce::Font("Press Start 2P", 8.0f, juce::Font::plain));
+    g.drawText(peakDb <= floorDb ? juce::String("-inf") : juce::String(peakDb, 1), textArea, juce::Justification::centredRight, false);
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <vector>
+
+// Peak, RMS and a log-frequency spectrum of the hosted output. The audio thread
+// only copies each rendered block into a wait-free single-producer FIFO (dropping
+// it if the UI has fallen behind); levels and the spectrum are worked out in the
+// component's timer. The timer polls isShowing(), so hiding an ancestor (another
+// tab, say) stops the copying too.
+class OutputMeter : public juce::Component, private juce::Timer
+{
+public:
+    OutputMeter();
+    ~OutputMeter() override;
+
+    // Message thread
+    void prepare(double sampleRate);
+
+    // Audio thread: copies the block's first two channels for the timer
+    void push(const juce::AudioBuffer<float>& block) noexcept;
+
+    void paint(juce::Graphics& g) override;
+    void visibilityChanged() override;
+    void parentHierarchyChanged() override;
+
+private:
+    void timerCallback() override;
+    void updateActive();
+    void analyseSpectrum();
+    void readFifo(int numReady, float& blockPeak, double& sumSquares);
+
+    static constexpr int fifoSize = 16384;
+    static constexpr int fftOrder = 11;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int numBands = 48;
+    static constexpr int frameRateHz = 30;
+    static constexpr float floorDb = -72.0f;
+    static constexpr float decayDbPerFrame = 1.5f;
+
+    // Audio thread writes, timer reads
+    juce::AbstractFifo fifo{ fifoSize };
+    juce::AudioBuffer<float> fifoBuffer{ 2, fifoSize };
+    std::atomic<bool> active{ false };
+    std::atomic<double> currentSampleRate{ 44100.0 };
+
+    // Timer only
+    juce::dsp::FFT fft{ fftOrder };
+    juce::dsp::WindowingFunction<float> window{ (size_t)fftSize, juce::dsp::WindowingFunction<float>::hann };
+    std::vector<float> history = std::vector<float>((size_t)fftSize, 0.0f);  // circular
+    std::vector<float> fftData = std::vector<float>((size_t)fftSize * 2, 0.0f);
+    int historyPosition = 0;
+    std::array<float, numBands> bandLevels;
+    float peakDb = floorDb;
+    float rmsDb = floorDb;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OutputMeter)
+};
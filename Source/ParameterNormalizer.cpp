@@ -83,7 +83,9 @@ std::pair<std::string, float> normalizeValue(const std::string& name, const std:
     
     try {
         // Use the mapped Serum 2 name for comparisons
-        if (serum2Name == "Env 1 Attack" || serum2Name == "Env 1 Hold" || serum2Name == "Env 1 Decay" || serum2Name == "Env 1 Release")
+        if (!value.empty() && value[0] == '=')
+            normalizedValue = std::clamp(std::stof(value.substr(1)), 0.0f, 1.0f);
+        else if (serum2Name == "Env 1 Attack" || serum2Name == "Env 1 Hold" || serum2Name == "Env 1 Decay" || serum2Name == "Env 1 Release")
             normalizedValue = normalizeMsS(serum2Name, value);
         else if (serum2Name == "Env 1 Sustain")
             normalizedValue = normalizeDbToF(serum2Name, value);
@@ -191,6 +193,21 @@ std::pair<std::string, float> normalizeValue(const std::string& name, const std:
     }
     return { serum2Name, normalizedValue };
 }
+std::string rawNormalizedValue(float normalizedValue) {
+    std::ostringstream stream;
+    stream << '=' << std::clamp(normalizedValue, 0.0f, 1.0f);
+    return stream.str();
+}
+// Continuous sound-shaping parameters, as used by the local reference matcher
+const std::vector<std::string>& searchableSerum2Parameters() {
+    static const std::vector<std::string> names = {
+        "Env 1 Attack", "Env 1 Decay", "Env 1 Sustain", "Env 1 Release",
+        "A Level", "B Level", "Sub Level", "A WT Pos", "B WT Pos",
+        "A Uni Detune", "B Uni Detune", "A Uni Blend", "B Uni Blend",
+        "A Pan", "B Pan", "Filter 1 Freq", "Dist BW", "Cho Dep", "Comp Wet"
+    };
+    return names;
+}
 const std::vector<float> serum_ms_values = {
     0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.1, 0.1, 0.2, 0.2, 0.4, 0.5, 0.7, 1.0, 1.4, 1.8, 2.4, 3.1, 4.0,
     5.0, 6.2, 7.7, 9.5, 12, 14, 17, 20, 24, 28, 32, 38, 44, 51, 59, 67, 77, 87, 99, 112, 127, 142, 160, 179, 199,
@@ -4,7 +4,11 @@
 #include <string>
 #include <unordered_map>
 #include <functional>
+#include <vector>
 std::pair<std::string, float> normalizeValue(const std::string& paramName, const std::string& rawValue);
+// Values written as "=0.42" are already normalized and pass through unchanged
+std::string rawNormalizedValue(float normalizedValue);
+const std::vector<std::string>& searchableSerum2Parameters();
 float normalizeMsS(const std::string& name, const std::string& value);
 float normalizeDbToF(const std::string& name, const std::string& value);
 float normalizePanToF(const std::string& name, const std::string& value);
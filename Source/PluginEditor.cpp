@@ -32,9 +32,6 @@ SummonerXSerum2AudioProcessorEditor::SummonerXSerum2AudioProcessorEditor(Summone
     tabs.setVisible(false);
     
     // Setup ChatBar callbacks
-    chatBar.onLoadingStateChanged = [this](bool show) {
-        showLoadingScreen(show);
-    };
     chatBar.onRefreshTokenRequested = [this]() {
         refreshAccessToken();
     };
@@ -89,9 +86,6 @@ SummonerXSerum2AudioProcessorEditor::SummonerXSerum2AudioProcessorEditor(Summone
         chatBar.setCredits(credits);
         settings.setCredits(credits);
         
-        // Start token refresh timer after successful login
-        startTimer(900000); // 15 minutes = 900000 ms (frequent credit refresh)
-        
         // Mark as not first time user
         appProps.getUserSettings()->setValue("hasLoggedInBefore", true);
         appProps.getUserSettings()->save();
@@ -150,11 +144,9 @@ SummonerXSerum2AudioProcessorEditor::SummonerXSerum2AudioProcessorEditor(Summone
         chatBar.setCredits(credits);
         settings.setCredits(credits);
         
-        // Validate token and fetch current credits on plugin instantiation if logged in
+        // Validate token and fetch current credits on plugin instantiation if logged in;
+        // after that every generation response carries the balance, so there is no polling
         refreshAccessToken();
-        
-        // Start token refresh timer (900000 ms = 15 minutes)
-        startTimer(900000); // 15 minutes = 900000 ms (frequent credit refresh)
     } else if (isFirstTimeUser()) {
         currentUIState = UIState::FirstTime;
     } else {
@@ -162,11 +154,16 @@ SummonerXSerum2AudioProcessorEditor::SummonerXSerum2AudioProcessorEditor(Summone
     }
     
     updateUIState();
+
+    // Warm the API connection now so the first prompt doesn't pay for the handshake
+    api->beginKeepWarm();
 }
 
 SummonerXSerum2AudioProcessorEditor::~SummonerXSerum2AudioProcessorEditor()
 {
-    stopTimer();
+    // Cancelled rather than waited for, so closing the editor never blocks on the network
+    api->cancel(creditsRequest);
+    api->endKeepWarm();
     welcomeLoginButton.setLookAndFeel(nullptr);
     loggedOutLoginButton.setLookAndFeel(nullptr);
 }
@@ -238,9 +235,6 @@ void SummonerXSerum2AudioProcessorEditor::showLoadingScreen(bool show)
 
 void SummonerXSerum2AudioProcessorEditor::handleLogout()
 {
-    // Stop token refresh timer
-    stopTimer();
-    
     appProps.getUserSettings()->setValue("isLoggedIn", false);
     appProps.getUserSettings()->setValue("accessToken", "");
     appProps.getUserSettings()->setValue("idToken", "");
@@ -278,13 +272,6 @@ void SummonerXSerum2AudioProcessorEditor::handleLoginCancel()
     DBG("Login cancelled - returned to previous state: " + juce::String((int)currentUIState));
 }
 
-void SummonerXSerum2AudioProcessorEditor::timerCallback()
-{
-    // Called every 15 minutes to validate token and update credits
-    DBG("Timer callback triggered - validating token and updating credits");
-    refreshAccessToken();
-}
-
 
 void SummonerXSerum2AudioProcessorEditor::refreshAccessToken()
 {
@@ -311,118 +298,88 @@ void SummonerXSerum2AudioProcessorEditor::refreshAccessToken()
         return;
     }
     
-    // Fetch current credits to verify token is still valid
-    std::thread([this, accessToken]() {
-        DBG("Background thread started for credit refresh");
-        fetchAndUpdateCredits(accessToken);
-        creditsFetchInProgress = false;
-        DBG("Background thread completed for credit refresh");
-    }).detach();
+    fetchAndUpdateCredits(accessToken);
 }
 
 void SummonerXSerum2AudioProcessorEditor::fetchAndUpdateCredits(const juce::String& accessToken)
 {
-    // Temporarily disable credits fetching to avoid component lifecycle issues
-    DBG("Credits fetching disabled to prevent component exceptions");
-    return;
     if (accessToken.isEmpty()) {
         DBG("No access token available for credits fetch");
+        creditsFetchInProgress = false;
         return;
     }
     
     DBG("Making request to get-credits endpoint");
     
-    juce::URL creditsUrl("https://ydr97n8vxe.execute-api.us-east-2.amazonaws.com/prod/get-credits");
-    
-    auto options = juce::URL::InputStreamOptions(juce::URL::ParameterHandling::inPostData)
-        .withExtraHeaders("Authorization: Bearer " + accessToken)
-        .withConnectionTimeoutMs(30000);
-    
-    std::unique_ptr<juce::InputStream> stream(creditsUrl.createInputStream(options));
-    
-    if (stream != nullptr)
+    ApiClient::Request request;
+    request.path = "/get-credits";
+    request.accessToken = accessToken;
+    request.timeoutMs = 30000;
+
+    creditsRequest = api->send(std::move(request), [this](const ApiClient::Response& creditsResponse) {
+        creditsRequest = 0;
+        creditsFetchInProgress = false;
+        applyCreditsResponse(creditsResponse);
+        });
+}
+
+void SummonerXSerum2AudioProcessorEditor::applyCreditsResponse(const ApiClient::Response& creditsResponse)
+{
+    if (!creditsResponse.connected)
     {
-        juce::String response = stream->readEntireStreamAsString();
-        DBG("Credits fetch response: " + response);
-        
-        juce::var result = juce::JSON::parse(response);
-        
-        if (result.isObject())
+        DBG("Credits fetch failed: Unable to connect to credits endpoint");
+        // Network error - don't log out, just skip this update
+        return;
+    }
+
+    const juce::String& response = creditsResponse.body;
+    DBG("Credits fetch response: " + response);
+
+    juce::var result = juce::JSON::parse(response);
+    if (!result.isObject())
+    {
+        DBG("Credits fetch failed: Invalid response format - likely network issue, not logging out");
+        // Don't log out for parsing errors - could be temporary network/server issues
+        return;
+    }
+
+    auto* obj = result.getDynamicObject();
+
+    // Check if this is an error response with "detail" field
+    if (obj->hasProperty("detail"))
+    {
+        juce::String detail = obj->getProperty("detail").toString();
+        DBG("Credits fetch error: " + detail);
+
+        if (detail == "Invalid token")
         {
-            auto* obj = result.getDynamicObject();
-            
-            // Check if this is an error response with "detail" field
-            if (obj->hasProperty("detail"))
-            {
-                juce::String detail = obj->getProperty("detail").toString();
-                DBG("Credits fetch error: " + detail);
-                
-                if (detail == "Invalid token")
-                {
-                    DBG("Token is invalid - logging out user");
-                    juce::MessageManager::callAsync([this]() {
-                        handleLogout();
-                    });
-                }
-                else
-                {
-                    DBG("Other API error during credits fetch: " + detail);
-                    // Don't log out for other errors, just skip this update
-                }
-            }
-            else if (obj->hasProperty("credits"))
-            {
-                // Successful response with credits
-                int newCredits = obj->getProperty("credits").toString().getIntValue();
-                
-                // Update stored credits and display
-                if (juce::MessageManager::getInstance()->isThisTheMessageThread())
-                {
-                    // We're already on the message thread, update directly
-                    chatBar.setCredits(newCredits);
-                    settings.setCredits(newCredits);
-                    
-                    // Save to settings safely
-                    if (auto* userSettings = appProps.getUserSettings()) {
-                        userSettings->setValue("credits", newCredits);
-                        userSettings->saveIfNeeded();
-                    }
-                    
-                    DBG("Credits updated successfully: " + juce::String(newCredits));
-                }
-                else
-                {
-                    // We're on a background thread, defer to message thread
-                    juce::MessageManager::callAsync([this, newCredits]() {
-                        chatBar.setCredits(newCredits);
-                        settings.setCredits(newCredits);
-                        
-                        // Save to settings safely
-                        if (auto* userSettings = appProps.getUserSettings()) {
-                            userSettings->setValue("credits", newCredits);
-                            userSettings->saveIfNeeded();
-                        }
-                        
-                        DBG("Credits updated successfully: " + juce::String(newCredits));
-                    });
-                }
-            }
-            else
-            {
-                DBG("Credits fetch failed: No credits field in response");
-                // Unknown response format - don't log out, just skip
-            }
+            DBG("Token is invalid - logging out user");
+            handleLogout();
         }
         else
         {
-            DBG("Credits fetch failed: Invalid response format - likely network issue, not logging out");
-            // Don't log out for parsing errors - could be temporary network/server issues
+            DBG("Other API error during credits fetch: " + detail);
+            // Don't log out for other errors, just skip this update
+        }
+    }
+    else if (obj->hasProperty("credits"))
+    {
+        int newCredits = obj->getProperty("credits").toString().getIntValue();
+        chatBar.setCredits(newCredits);
+        settings.setCredits(newCredits);
+
+        // Save to settings safely
+        if (auto* userSettings = appProps.getUserSettings()) {
+            userSettings->setValue("credits", newCredits);
+            userSettings->saveIfNeeded();
         }
+
+        DBG("Credits updated successfully: " + juce::String(newCredits));
     }
     else
     {
-        DBG("Credits fetch failed: Unable to connect to credits endpoint");
-        // Network error - don't log out, just skip this update
+        DBG("Credits fetch failed: No credits field in response");
+        // Unknown response format - don't log out, just skip
     }
 }
 
@@ -8,8 +8,9 @@
 #include "LoadingComponent.h"
 #include "LoginComponent.h"
 #include "LoginState.h"
+#include "ApiClient.h"
 
-class SummonerXSerum2AudioProcessorEditor : public juce::AudioProcessorEditor, public juce::Timer
+class SummonerXSerum2AudioProcessorEditor : public juce::AudioProcessorEditor
 {
 public:
     SummonerXSerum2AudioProcessorEditor(SummonerXSerum2AudioProcessor&);
@@ -18,7 +19,6 @@ public:
     void paint(juce::Graphics&) override;
     void resized() override;
     void showLoadingScreen(bool show);
-    void timerCallback() override;
     void refreshAccessToken();
 
 private:
@@ -49,6 +49,8 @@ private:
 
     LoginComponent login;
     juce::ApplicationProperties appProps;
+    juce::SharedResourcePointer<ApiClient> api;
+    ApiClient::RequestId creditsRequest = 0;
     
     // UI State Management
     enum class UIState {
@@ -297,6 +299,7 @@ private:
     void handleLogout();
     void handleLoginCancel();
     void fetchAndUpdateCredits(const juce::String& accessToken);
+    void applyCreditsResponse(const ApiClient::Response& creditsResponse);
     void updateUIState();
     void setupWelcomeScreen();
     void setupLoggedOutScreen();
@@ -6,6 +6,7 @@
 #include <juce_core/juce_core.h>
 #include <regex>
 #include "ParameterNormalizer.h"
+#include "CandidateRanker.h"
 
 SummonerXSerum2AudioProcessor::SummonerXSerum2AudioProcessor()
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -21,6 +22,21 @@ SummonerXSerum2AudioProcessor::SummonerXSerum2AudioProcessor()
     settingsComponent(*this),
     serumInterface(*this)
 {
+    morphEngine.createParameters(*this);
+
+    serumInterface.onInstanceSwapped = [this]() {
+        enumerateParameters();
+        };
+
+    presetScheduler.applyOnMessageThread = [this](const PresetSwitchScheduler::StagedChange& change) {
+        auto* instance = change.target == PresetSwitchScheduler::Target::audition
+            ? serumInterface.getAuditionInstance() : serumInterface.getSerumInstance();
+        if (instance == nullptr)
+            return;
+        for (const auto& parameter : change.parameters)
+            if (auto* param = instance->getParameters()[parameter.parameterIndex])
+                param->setValueNotifyingHost(parameter.value);
+        };
 }
 
 SummonerXSerum2AudioProcessor::~SummonerXSerum2AudioProcessor()
@@ -92,17 +108,14 @@ void SummonerXSerum2AudioProcessor::prepareToPlay(double sampleRate, int samples
     DBG("prepareToPlay called: SampleRate = " << sampleRate << ", BlockSize = " << samplesPerBlock);
     if (serumInterface.getSerumInstance() == nullptr)
     {
-        serumInterface.loadSerum(juce::File(serumPluginPath));
-    }
-    if (serumInterface.getSerumInstance() != nullptr)
-    {
-        DBG("Serum loaded successfully from stored path!");
-        serumInterface.prepareToPlay(sampleRate, samplesPerBlock);
-    }
-    else
-    {
-        DBG("Failed to load Serum from stored path.");
+        // Loaded through the slot's swap path on the message thread, prepared for these
+        // settings; parameters are enumerated once it lands
+        DBG("Loading Serum from stored path");
+        serumInterface.hotSwapSerum(juce::File(serumPluginPath));
     }
+    serumInterface.prepareToPlay(sampleRate, samplesPerBlock);
+    headMidi.ensureSize(4096);
+    tailMidi.ensureSize(4096);
     enumerateParameters();
 }
 
@@ -118,6 +131,9 @@ void SummonerXSerum2AudioProcessor::enumerateParameters()
     // Clear the existing parameter map
     parameterMap.clear();
 
+    // Previews render on private instances of whatever plugin is live
+    previewRenderer.setPluginDescription(serum->getPluginDescription());
+
     // Get the list of parameters using the non-deprecated method
     const auto& parameters = serum->getParameters();
     int paramIndex = 0;
@@ -134,22 +150,16 @@ void SummonerXSerum2AudioProcessor::enumerateParameters()
     DBG("Enumerated " << parameters.size() << " parameters from Serum.");
 }
 
-void SummonerXSerum2AudioProcessor::setParameterByName(const std::pair<std::string, float>& paramData)
+void SummonerXSerum2AudioProcessor::setParameterByName(juce::AudioPluginInstance& instance, const std::pair<std::string, float>& paramData)
 {
     const std::string& paramName = paramData.first;
     float value = paramData.second;
-    auto* serum = getSerumInstance();
-    if (!serum)
-    {
-        DBG("Serum instance not available for setting parameter.");
-        return;
-    }
 
     auto it = parameterMap.find(paramName);
     if (it != parameterMap.end())
     {
         int paramIndex = it->second;
-        const auto& parameters = serum->getParameters();
+        const auto& parameters = instance.getParameters();
         if (paramIndex >= 0 && paramIndex < parameters.size())
         {
             auto* param = parameters[paramIndex];
@@ -191,17 +201,159 @@ float SummonerXSerum2AudioProcessor::parseValue(const std::string& value)
 void SummonerXSerum2AudioProcessor::applyPresetToSerum(const std::map<std::string, std::string>& ChatResponse)
 {
     auto* serum = getSerumInstance();
-    if (!serum) return;
+    if (!serum)
+    {
+        DBG("Serum instance not available for setting parameter.");
+        return;
+    }
+    applyOrStagePreset(PresetSwitchScheduler::Target::primary, *serum, ChatResponse, true);
+}
+
+void SummonerXSerum2AudioProcessor::applyPresetToInstance(juce::AudioPluginInstance& instance, const std::map<std::string, std::string>& ChatResponse)
+{
     for (const auto& param : ChatResponse)
     {
         const std::string& paramName = param.first;
         const std::string& textValue = param.second;
-        setParameterByName(normalizeValue(paramName, textValue));
+        setParameterByName(instance, normalizeValue(paramName, textValue));
     }
-    if (onPresetApplied)
+}
+
+void SummonerXSerum2AudioProcessor::applyOrStagePreset(PresetSwitchScheduler::Target target, juce::AudioPluginInstance& instance,
+    const std::map<std::string, std::string>& ChatResponse, bool announce)
+{
+    const auto mode = presetScheduler.getMode();
+    // Offline renders always go through the audio thread so the switch lands on a block boundary
+    if (mode == PresetSwitchScheduler::Mode::immediate && !isNonRealtime())
+    {
+        applyPresetToInstance(instance, ChatResponse);
+        if (announce && onPresetApplied)
+            onPresetApplied();
+        return;
+    }
+
+    applyOrStagePlan(target, instance, buildApplyPlan(ChatResponse), announce);
+}
+
+void SummonerXSerum2AudioProcessor::applyOrStagePlan(PresetSwitchScheduler::Target target, juce::AudioPluginInstance& instance,
+    std::vector<PresetSwitchScheduler::ParameterChange> plan, bool announce)
+{
+    // While a morph drives the primary nothing is staged for it: the morph and a
+    // committing switch would write the same parameters in the same block
+    const bool morphing = target == PresetSwitchScheduler::Target::primary && morphEngine.hasPlan();
+    const auto mode = presetScheduler.getMode();
+    if (morphing || (mode == PresetSwitchScheduler::Mode::immediate && !isNonRealtime()))
+    {
+        const auto& parameters = instance.getParameters();
+        for (const auto& change : plan)
+            if (change.parameterIndex >= 0 && change.parameterIndex < parameters.size())
+                parameters[change.parameterIndex]->setValueNotifyingHost(change.value);
+        if (announce && onPresetApplied)
+            onPresetApplied();
+        return;
+    }
+
+    auto change = std::make_unique<PresetSwitchScheduler::StagedChange>();
+    change->target = target;
+    change->mode = mode;
+    change->parameters = std::move(plan);
+    // A superseded or cancelled change never commits, so it is never announced
+    change->onCommitted = [this, mode, announce]() {
+        DBG("Staged preset committed (" << PresetSwitchScheduler::getModeName(mode) << ")");
+        if (announce && onPresetApplied)
+            onPresetApplied();
+        };
+    DBG("Staging preset with " << (int)change->parameters.size() << " parameters, switching on: " << PresetSwitchScheduler::getModeName(mode));
+    presetScheduler.stage(std::move(change));
+}
+
+std::vector<PresetSwitchScheduler::ParameterChange> SummonerXSerum2AudioProcessor::buildApplyPlan(const std::map<std::string, std::string>& ChatResponse) const
+{
+    std::vector<PresetSwitchScheduler::ParameterChange> plan;
+    plan.reserve(ChatResponse.size());
+    for (const auto& param : ChatResponse)
+    {
+        const auto normalized = normalizeValue(param.first, param.second);
+        auto it = parameterMap.find(normalized.first);
+        if (it != parameterMap.end())
+            plan.push_back({ it->second, std::clamp(normalized.second, 0.0f, 1.0f) });
+        else
+            DBG("Parameter " << normalized.first << " not found in parameter map.");
+    }
+    return plan;
+}
+
+bool SummonerXSerum2AudioProcessor::renderPreview(int responseIndex, PreviewRenderer::Callback onRendered)
+{
+    juce::ScopedLock lock(responseLock);
+    if (responseIndex < 0 || responseIndex >= (int)responses.size())
+        return false;
+
+    previewRenderer.render(responseIndex, buildApplyPlan(responses[(size_t)responseIndex]), std::move(onRendered));
+    return true;
+}
+
+bool SummonerXSerum2AudioProcessor::matchReference(const juce::File& referenceFile, std::function<void(int, int)> onProgress)
+{
+    if (soundMatcher.isRunning() || !soundMatcher.loadReference(referenceFile))
+        return false;
+
+    std::vector<SoundMatcher::Dimension> dimensions;
+    for (const auto& name : searchableSerum2Parameters())
     {
-        onPresetApplied();
+        auto it = parameterMap.find(name);
+        if (it != parameterMap.end())
+            dimensions.push_back({ name, it->second });
     }
+
+    soundMatcher.onProgress = [onProgress](int generation, int numGenerations, float) {
+        if (onProgress)
+            onProgress(generation, numGenerations);
+        };
+    soundMatcher.onFinished = [this, name = referenceFile.getFileNameWithoutExtension()](std::map<std::string, std::string> response, float loss) {
+        DBG("Reference match for " << name << " finished with loss " << loss);
+        addResponse(std::move(response));
+        };
+    return soundMatcher.start(std::move(dimensions));
+}
+
+int SummonerXSerum2AudioProcessor::addResponse(std::map<std::string, std::string>&& response)
+{
+    juce::ScopedLock lock(responseLock);
+    responses.push_back(std::move(response));
+    const int index = (int)responses.size() - 1;
+    applyResponseToActiveSide(index);
+    serumInterface.updateResponseCounter();
+    return index;
+}
+
+bool SummonerXSerum2AudioProcessor::applyRelativeEdit(const juce::String& prompt, const RelativeEditEngine& engine)
+{
+    juce::ScopedLock lock(responseLock);
+    auto* audition = serumInterface.getAuditionInstance();
+    const bool onAudition = serumInterface.isAuditionActive() && audition != nullptr;
+    auto* instance = onAudition ? audition : getSerumInstance();
+    if (instance == nullptr)
+        return false;
+
+    // The edited sound starts as the response it came from, if it came from one
+    const int index = onAudition ? auditionResponseIndex : currentResponseIndex;
+    std::map<std::string, std::string> edited;
+    if (index >= 0 && index < (int)responses.size())
+        edited = responses[(size_t)index];
+
+    std::vector<PresetSwitchScheduler::ParameterChange> plan;
+    if (!engine.interpret(prompt, *instance, parameterMap, plan, edited))
+        return false;
+    if (plan.empty())
+        return true;   // understood, but the sound is already there
+
+    responses.push_back(std::move(edited));
+    (onAudition ? auditionResponseIndex : currentResponseIndex) = (int)responses.size() - 1;
+    applyOrStagePlan(onAudition ? PresetSwitchScheduler::Target::audition : PresetSwitchScheduler::Target::primary,
+        *instance, std::move(plan));
+    serumInterface.updateResponseCounter();
+    return true;
 }
 
 void SummonerXSerum2AudioProcessor::setSerumPath(const juce::String& newPath)
@@ -210,9 +362,8 @@ void SummonerXSerum2AudioProcessor::setSerumPath(const juce::String& newPath)
     {
         DBG("Updating Serum Path: " << newPath);
         serumPluginPath = newPath;
-        serumInterface.loadSerum(juce::File(serumPluginPath));
-        serumInterface.prepareToPlay(getSampleRate(), getBlockSize());
-        enumerateParameters(); // Add this to refresh parameter list
+        // Loads in the background and crossfades; parameters are re-enumerated once it lands
+        serumInterface.hotSwapSerum(juce::File(serumPluginPath));
     }
 }
 
@@ -261,7 +412,46 @@ juce::AudioPluginInstance* SummonerXSerum2AudioProcessor::getSerumInstance()
 void SummonerXSerum2AudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
     juce::ScopedNoDenormals noDenormals;
-    serumInterface.processMidiAndAudio(buffer, midiMessages, getSampleRate());
+    // Control-rate morph: only parameters that moved since the last block are pushed
+    if (const int numMorphed = morphEngine.process())
+        serumInterface.applyParameterValues(morphEngine.getChangedIndices(), morphEngine.getChangedValues(), numMorphed);
+
+    const int numSamples = buffer.getNumSamples();
+    const int commitSample = presetScheduler.findCommitSample(getPlayHead(), midiMessages, numSamples, getSampleRate(),
+        isNonRealtime(), serumInterface.getSilenceGate().isQuiet());
+    if (commitSample <= 0)
+    {
+        if (commitSample == 0)
+            commitStagedChange();
+        serumInterface.processMidiAndAudio(buffer, midiMessages, getSampleRate());
+        return;
+    }
+
+    // Render up to the switch point with the old preset and the rest with the new one
+    headMidi.clear();
+    tailMidi.clear();
+    for (const auto metadata : midiMessages)
+    {
+        if (metadata.samplePosition < commitSample)
+            headMidi.addEvent(metadata.data, metadata.numBytes, metadata.samplePosition);
+        else
+            tailMidi.addEvent(metadata.data, metadata.numBytes, metadata.samplePosition - commitSample);
+    }
+
+    juce::AudioBuffer<float> head(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), 0, commitSample);
+    juce::AudioBuffer<float> tail(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), commitSample, numSamples - commitSample);
+    serumInterface.processMidiAndAudio(head, headMidi, getSampleRate());
+    commitStagedChange();
+    serumInterface.processMidiAndAudio(tail, tailMidi, getSampleRate());
+}
+
+void SummonerXSerum2AudioProcessor::commitStagedChange() noexcept
+{
+    if (auto* change = presetScheduler.getDueChange())
+    {
+        serumInterface.applyParameterChanges(change->target == PresetSwitchScheduler::Target::audition, change->parameters);
+        presetScheduler.markCommitted();
+    }
 }
 
 bool SummonerXSerum2AudioProcessor::hasEditor() const
@@ -278,43 +468,298 @@ void SummonerXSerum2AudioProcessor::getStateInformation(juce::MemoryBlock& destD
 {
 }
 
-void SummonerXSerum2AudioProcessor::setResponses(const std::vector<std::map<std::string, std::string>>& newResponses)
+void SummonerXSerum2AudioProcessor::setResponses(std::vector<std::map<std::string, std::string>>&& newResponses, const juce::String& prompt)
 {
     juce::ScopedLock lock(responseLock);
-    responses = newResponses;
+    ++rankingGeneration;
+    responses = std::move(newResponses);
     currentResponseIndex = 0;
-    if (!responses.empty())
-        applyPresetToSerum(responses[currentResponseIndex]);
+    auditionResponseIndex = juce::jmin(1, juce::jmax(0, (int)responses.size() - 1));
+
+    // Applying now and again once the ranking picks a different winner would switch
+    // the sound twice, so a ranked set is applied only when the ranking is done
+    applyAfterRanking = responses.size() > 1 && prompt.isNotEmpty();
+    if (applyAfterRanking)
+    {
+        rankResponses(prompt);
+        return;
+    }
+    applyFirstResponses();
 }
 
-void SummonerXSerum2AudioProcessor::applyResponseAtIndex(int index)
+void SummonerXSerum2AudioProcessor::applyFirstResponses()
+{
+    if (responses.empty())
+        return;
+    applyPresetToSerum(responses[(size_t)currentResponseIndex]);
+    if (auto* audition = serumInterface.getAuditionInstance())
+        applyPresetToInstance(*audition, responses[(size_t)auditionResponseIndex]);
+}
+
+void SummonerXSerum2AudioProcessor::setResponseWithPlan(std::map<std::string, std::string>&& response,
+    std::vector<PresetSwitchScheduler::ParameterChange>&& plan, int parameterCount)
 {
+    if (parameterCount != getSerumParameterCount())
+    {
+        DBG("Cached plan was built for " << parameterCount << " parameters, rebuilding");
+        addResponse(std::move(response));
+        return;
+    }
+
+    auto* serum = getSerumInstance();
+    if (serum == nullptr)
+    {
+        DBG("Serum instance not available for setting parameter.");
+        return;
+    }
+
+    // Like addResponse: joins the history after whatever is there (a local draft
+    // included) and plays on the side that is active
     juce::ScopedLock lock(responseLock);
-    if (index >= 0 && index < responses.size())
+    ++rankingGeneration;
+    applyAfterRanking = false;
+    responses.push_back(std::move(response));
+    const int index = (int)responses.size() - 1;
+    auto* audition = serumInterface.getAuditionInstance();
+    if (serumInterface.isAuditionActive() && audition != nullptr)
+    {
+        auditionResponseIndex = index;
+        applyOrStagePlan(PresetSwitchScheduler::Target::audition, *audition, std::move(plan), true);
+    }
+    else
     {
         currentResponseIndex = index;
-        applyPresetToSerum(responses[currentResponseIndex]);
+        applyOrStagePlan(PresetSwitchScheduler::Target::primary, *serum, std::move(plan), true);
     }
 }
 
-void SummonerXSerum2AudioProcessor::nextResponse()
+void SummonerXSerum2AudioProcessor::applyStreamedParameters(const std::map<std::string, std::string>& parameters)
+{
+    // A scheduled switch should land whole, so partial sets only play in immediate mode
+    auto* serum = getSerumInstance();
+    if (serum == nullptr || presetScheduler.getMode() != PresetSwitchScheduler::Mode::immediate)
+        return;
+
+    const auto& instanceParameters = serum->getParameters();
+    for (const auto& parameter : parameters)
+    {
+        auto it = parameterMap.find(parameter.first);
+        if (it != parameterMap.end() && it->second >= 0 && it->second < instanceParameters.size())
+            streamedOriginals.emplace(it->second, instanceParameters[it->second]->getValue());
+    }
+    applyPresetToInstance(*serum, parameters);
+}
+
+void SummonerXSerum2AudioProcessor::revertStreamedParameters()
+{
+    auto* serum = getSerumInstance();
+    if (serum != nullptr)
+    {
+        const auto& instanceParameters = serum->getParameters();
+        for (const auto& original : streamedOriginals)
+            if (original.first < instanceParameters.size())
+                instanceParameters[original.first]->setValueNotifyingHost(original.second);
+        DBG("Reverted " << (int)streamedOriginals.size() << " streamed parameters");
+    }
+    streamedOriginals.clear();
+}
+
+void SummonerXSerum2AudioProcessor::rankResponses(const juce::String& prompt)
+{
+    struct RankingRun
+    {
+        std::vector<AudioFeatures> features;
+        int remaining = 0;
+    };
+
+    const int generation = rankingGeneration;
+    auto run = std::make_shared<RankingRun>();
+    run->features.resize(responses.size());
+    run->remaining = (int)responses.size();
+
+    // Renders and analyses run on the preview workers; results arrive on the message thread
+    for (int index = 0; index < (int)responses.size(); ++index)
+    {
+        previewRenderer.render(index, buildApplyPlan(responses[(size_t)index]),
+            [this, run, generation, prompt](int candidateId, const juce::AudioBuffer<float>&, const AudioFeatures& features)
+            {
+                if (generation != rankingGeneration)
+                    return; // new responses arrived meanwhile
+                run->features[(size_t)candidateId] = features;
+                if (--run->remaining == 0)
+                    applyRanking(run->features, prompt);
+            });
+    }
+}
+
+void SummonerXSerum2AudioProcessor::applyRanking(const std::vector<AudioFeatures>& features, const juce::String& prompt)
 {
     juce::ScopedLock lock(responseLock);
-    if (currentResponseIndex < responses.size() - 1)
+    if (features.size() != responses.size())
+        return;
+
+    const auto order = CandidateRanker::rank(features, prompt);
+    if (!order.empty() && !std::is_sorted(order.begin(), order.end()))
     {
-        currentResponseIndex++;
-        applyPresetToSerum(responses[currentResponseIndex]);
+        std::vector<std::map<std::string, std::string>> ranked;
+        ranked.reserve(responses.size());
+        for (int index : order)
+            ranked.push_back(std::move(responses[(size_t)index]));
+
+        // Follow the responses the user is currently on to their new positions; what they hear stays put
+        const auto newPosition = [&order](int oldIndex) {
+            return (int)(std::find(order.begin(), order.end(), oldIndex) - order.begin());
+            };
+        responses = std::move(ranked);
+        currentResponseIndex = newPosition(currentResponseIndex);
+        auditionResponseIndex = newPosition(auditionResponseIndex);
+        DBG("Ranked responses for \"" << prompt << "\", best was #" << order.front() + 1);
     }
+
+    if (applyAfterRanking)
+    {
+        applyAfterRanking = false;
+        currentResponseIndex = 0;
+        auditionResponseIndex = juce::jmin(1, (int)responses.size() - 1);
+        applyFirstResponses();
+    }
+    serumInterface.updateResponseCounter();
+}
+
+void SummonerXSerum2AudioProcessor::applyResponseAtIndex(int index)
+{
+    juce::ScopedLock lock(responseLock);
+    if (index >= 0 && index < responses.size())
+        applyResponseToActiveSide(index);
+}
+
+void SummonerXSerum2AudioProcessor::nextResponse()
+{
+    juce::ScopedLock lock(responseLock);
+    int index = getCurrentResponseIndex();
+    if (index < (int)responses.size() - 1)
+        applyResponseToActiveSide(index + 1);
 }
 
 void SummonerXSerum2AudioProcessor::previousResponse()
 {
     juce::ScopedLock lock(responseLock);
-    if (currentResponseIndex > 0)
+    int index = getCurrentResponseIndex();
+    if (index > 0)
+        applyResponseToActiveSide(index - 1);
+}
+
+void SummonerXSerum2AudioProcessor::applyResponseToActiveSide(int index)
+{
+    applyAfterRanking = false;
+    auto* audition = serumInterface.getAuditionInstance();
+    if (serumInterface.isAuditionActive() && audition != nullptr)
     {
-        currentResponseIndex--;
-        applyPresetToSerum(responses[currentResponseIndex]);
+        auditionResponseIndex = index;
+        applyOrStagePreset(PresetSwitchScheduler::Target::audition, *audition, responses[auditionResponseIndex]);
+        return;
     }
+    currentResponseIndex = index;
+    applyPresetToSerum(responses[currentResponseIndex]);
+}
+
+void SummonerXSerum2AudioProcessor::setABMode(bool enabled)
+{
+    juce::ScopedLock lock(responseLock);
+    if (!serumInterface.setABModeEnabled(enabled) || !enabled)
+        return;
+
+    // B starts on the neighbouring response so there is something to compare
+    auditionResponseIndex = currentResponseIndex;
+    if (currentResponseIndex + 1 < (int)responses.size())
+        auditionResponseIndex = currentResponseIndex + 1;
+    if (auto* audition = serumInterface.getAuditionInstance())
+        if (auditionResponseIndex < (int)responses.size())
+            applyPresetToInstance(*audition, responses[auditionResponseIndex]);
+}
+
+int SummonerXSerum2AudioProcessor::addLayerFromResponse(int responseIndex, int lowestNote, int highestNote)
+{
+    juce::ScopedLock lock(responseLock);
+    if (responseIndex < 0 || responseIndex >= (int)responses.size())
+        return -1;
+
+    const int layerIndex = serumInterface.addLayer();
+    auto* instance = serumInterface.getLayerGraph().getLayerInstance(layerIndex);
+    if (instance == nullptr)
+        return -1;
+
+    serumInterface.getLayerGraph().setKeyRange(layerIndex, lowestNote, highestNote);
+    applyPresetToInstance(*instance, responses[responseIndex]);
+    DBG("Stacked response " << responseIndex << " as layer " << layerIndex);
+    return layerIndex;
+}
+
+void SummonerXSerum2AudioProcessor::clearLayers()
+{
+    serumInterface.getLayerGraph().clear();
+}
+
+bool SummonerXSerum2AudioProcessor::setMorphSources(const std::vector<int>& responseIndices)
+{
+    juce::ScopedLock lock(responseLock);
+    auto* serum = getSerumInstance();
+    if (serum == nullptr || responseIndices.size() < 2 || responseIndices.size() > (size_t)MorphEngine::maxSources)
+        return false;
+
+    // Union of every parameter the sources set, in Serum's own index order
+    std::map<int, std::vector<float>> valuesByParameter;
+    const auto& parameters = serum->getParameters();
+    for (size_t source = 0; source < responseIndices.size(); ++source)
+    {
+        const int responseIndex = responseIndices[source];
+        if (responseIndex < 0 || responseIndex >= (int)responses.size())
+            return false;
+
+        for (const auto& param : responses[(size_t)responseIndex])
+        {
+            const auto normalized = normalizeValue(param.first, param.second);
+            auto it = parameterMap.find(normalized.first);
+            if (it == parameterMap.end())
+                continue;
+
+            auto& values = valuesByParameter[it->second];
+            if (values.empty())
+            {
+                // A source that leaves the parameter alone keeps the current value
+                auto* hosted = parameters[it->second];
+                values.assign(responseIndices.size(), hosted != nullptr ? hosted->getValue() : 0.0f);
+            }
+            values[source] = std::clamp(normalized.second, 0.0f, 1.0f);
+        }
+    }
+
+    std::vector<int> parameterIndices;
+    std::vector<std::vector<float>> sources(responseIndices.size());
+    for (const auto& entry : valuesByParameter)
+    {
+        parameterIndices.push_back(entry.first);
+        for (size_t source = 0; source < sources.size(); ++source)
+            sources[source].push_back(entry.second[source]);
+    }
+
+    // The morph writes the primary's parameters every block from now on; a switch
+    // still waiting for its beat would land on top of it, so it is dropped
+    presetScheduler.cancel();
+    morphEngine.setSources(std::move(parameterIndices), std::move(sources));
+    morphEngine.setEnabled(true);
+    return true;
+}
+
+void SummonerXSerum2AudioProcessor::clearMorph()
+{
+    morphEngine.setEnabled(false);
+    morphEngine.clear();
+}
+
+void SummonerXSerum2AudioProcessor::toggleAudition()
+{
+    serumInterface.setAuditionActive(!serumInterface.isAuditionActive());
 }
 
 void SummonerXSerum2AudioProcessor::setStateInformation(const void* data, int sizeInBytes)
@@ -2,6 +2,11 @@
 #include <JuceHeader.h>
 #include "SerumInterfaceComponent.h"
 #include "SettingsComponent.h"
+#include "PresetSwitchScheduler.h"
+#include "MorphEngine.h"
+#include "PreviewRenderer.h"
+#include "SoundMatcher.h"
+#include "RelativeEditEngine.h"
 
 class SummonerXSerum2AudioProcessor : public juce::AudioProcessor
 {
@@ -41,12 +46,62 @@ public:
     SerumInterfaceComponent& getSerumInterface() { return serumInterface; }
     void setSerumPath(const juce::String& newPath);
     void applyPresetToSerum(const std::map<std::string, std::string>& ChatResponse);
-    void setResponses(const std::vector<std::map<std::string, std::string>>& newResponses);
+    // With a prompt, several responses are previewed in the background and
+    // reordered so the best match for the prompt's wording comes first
+    // Responses are handed over, never copied: callers move them in
+    void setResponses(std::vector<std::map<std::string, std::string>>&& newResponses, const juce::String& prompt = {});
+    // Streaming: a partial response applied as it arrives, ahead of setResponses with the whole one
+    void applyStreamedParameters(const std::map<std::string, std::string>& parameters);
+    // A stream that fails part way puts back what it had changed; one that finishes keeps it
+    void revertStreamedParameters();
+    void keepStreamedParameters() { streamedOriginals.clear(); }
+    // A single response whose plan is already built (decoded with it, or from the prompt cache)
+    // skips name lookup and value parsing. Appended to the responses like addResponse, which
+    // it falls back to when Serum's parameter list no longer matches the plan.
+    void setResponseWithPlan(std::map<std::string, std::string>&& response,
+        std::vector<PresetSwitchScheduler::ParameterChange>&& plan, int parameterCount);
+    std::vector<PresetSwitchScheduler::ParameterChange> getApplyPlan(const std::map<std::string, std::string>& response) const { return buildApplyPlan(response); }
+    int getSerumParameterCount() const { return (int)parameterMap.size(); }
+    const std::map<std::string, int>& getParameterIndices() const { return parameterMap; }
     void applyResponseAtIndex(int index);
     void nextResponse();
     void previousResponse();
 
-    int getCurrentResponseIndex() const { return currentResponseIndex; }
+    // A/B auditioning: B gets its own response; Next/Previous act on the audible side
+    void setABMode(bool enabled);
+    bool isABModeEnabled() const { return serumInterface.isABModeEnabled(); }
+    void toggleAudition();
+
+    // Layering: stack another instance carrying the given response
+    int addLayerFromResponse(int responseIndex, int lowestNote = 0, int highestNote = 127);
+    void clearLayers();
+
+    // Morph: blends 2-4 responses from the host-automatable Morph X/Y parameters
+    bool setMorphSources(const std::vector<int>& responseIndices);
+    void clearMorph();
+    bool isMorphActive() const { return morphEngine.hasPlan(); }
+
+    // When a new preset becomes audible: now, on the next beat/bar, before the next note or once quiet
+    void setSwitchMode(PresetSwitchScheduler::Mode mode) { presetScheduler.setMode(mode); }
+    PresetSwitchScheduler::Mode getSwitchMode() const { return presetScheduler.getMode(); }
+
+    // Renders a response on a private instance in the background; the live sound is untouched
+    bool renderPreview(int responseIndex, PreviewRenderer::Callback onRendered);
+    PreviewRenderer& getPreviewRenderer() { return previewRenderer; }
+
+    // Searches locally for settings that sound like a reference file; the result
+    // is appended to the responses and applied
+    bool matchReference(const juce::File& referenceFile, std::function<void(int generation, int numGenerations)> onProgress);
+    bool isMatchingReference() const { return soundMatcher.isRunning(); }
+    // Appends and applies to the audible side; returns the new response's index
+    int addResponse(std::map<std::string, std::string>&& response);
+    // Tweak prompts ("brighter", "more reverb") edit the audible sound in place: the
+    // changes go out through the usual apply path and the edited sound is appended,
+    // so the one before is a step back. An edit that changes nothing ("less reverb" with
+    // reverb off) adds no response. False when the engine doesn't understand the prompt.
+    bool applyRelativeEdit(const juce::String& prompt, const RelativeEditEngine& engine);
+
+    int getCurrentResponseIndex() const { return serumInterface.isAuditionActive() ? auditionResponseIndex : currentResponseIndex; }
     int getResponseCount() const { 
         juce::ScopedLock lock(responseLock); 
         return static_cast<int>(responses.size()); 
@@ -55,14 +110,36 @@ public:
 private:
     std::map<std::string, int> parameterMap;
     void enumerateParameters();
-    void setParameterByName(const std::pair<std::string, float>& paramData);
+    void setParameterByName(juce::AudioPluginInstance& instance, const std::pair<std::string, float>& paramData);
+    void applyPresetToInstance(juce::AudioPluginInstance& instance, const std::map<std::string, std::string>& ChatResponse);
+    void applyResponseToActiveSide(int index);
+    // With announce, onPresetApplied fires once the change is audible: at once, or when a staged switch commits
+    void applyOrStagePreset(PresetSwitchScheduler::Target target, juce::AudioPluginInstance& instance, const std::map<std::string, std::string>& ChatResponse,
+        bool announce = false);
+    void applyOrStagePlan(PresetSwitchScheduler::Target target, juce::AudioPluginInstance& instance, std::vector<PresetSwitchScheduler::ParameterChange> plan,
+        bool announce = false);
+    void commitStagedChange() noexcept;
+    void rankResponses(const juce::String& prompt);
+    void applyRanking(const std::vector<AudioFeatures>& features, const juce::String& prompt);
+    void applyFirstResponses();
+    std::vector<PresetSwitchScheduler::ParameterChange> buildApplyPlan(const std::map<std::string, std::string>& ChatResponse) const;
     float parseValue(const std::string& value);
 
     SerumInterfaceComponent serumInterface;
     SettingsComponent settingsComponent;
+    PresetSwitchScheduler presetScheduler;
+    MorphEngine morphEngine;
+    PreviewRenderer previewRenderer;
+    SoundMatcher soundMatcher{ previewRenderer };
+    juce::MidiBuffer headMidi;  // audio thread only: MIDI before a mid-block preset switch
+    juce::MidiBuffer tailMidi;  // audio thread only: MIDI from the switch onwards
     juce::String serumPluginPath = "C:/Program Files/Common Files/VST3/Serum2.vst3";
     std::vector<std::map<std::string, std::string>> responses;
     int currentResponseIndex = 0;
+    int auditionResponseIndex = 0;
+    int rankingGeneration = 0;
+    bool applyAfterRanking = false;   // new responses wait for their ranking, unless the user picks one first
+    std::map<int, float> streamedOriginals;   // parameter index -> value before the running stream touched it
     mutable juce::CriticalSection responseLock;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SummonerXSerum2AudioProcessor)
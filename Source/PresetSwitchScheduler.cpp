@@ -0,0 +1,239 @@
+#include "PresetSwitchScheduler.h"
+#include <cmath>
+
+PresetSwitchScheduler::PresetSwitchScheduler()
+{
+    startTimer(20);
+}
+
+PresetSwitchScheduler::~PresetSwitchScheduler()
+{
+    stopTimer();
+    // processBlock is no longer called, so everything can be freed here
+    delete pending.exchange(nullptr);
+    delete parked.exchange(nullptr);
+    delete inFlight;
+    inFlight = nullptr;
+
+    const auto scope = returnFifo.read(returnFifo.getNumReady());
+    for (int i = 0; i < scope.blockSize1; ++i)
+        delete returned[(size_t)(scope.startIndex1 + i)];
+    for (int i = 0; i < scope.blockSize2; ++i)
+        delete returned[(size_t)(scope.startIndex2 + i)];
+}
+
+juce::String PresetSwitchScheduler::getModeName(Mode modeToName)
+{
+    switch (modeToName)
+    {
+        case Mode::nextBeat:    return "Beat";
+        case Mode::nextBar:     return "Bar";
+        case Mode::nextNoteOn:  return "Note";
+        case Mode::nextSilence: return "Quiet";
+        case Mode::immediate:
+        default:                return "Now";
+    }
+}
+
+void PresetSwitchScheduler::stage(std::unique_ptr<StagedChange> change)
+{
+    if (change == nullptr)
+        return;
+
+    cancelRequested = false;
+    // The audio thread only ever takes a change by exchanging the pointer, so
+    // one still sitting in pending is not being read and can be replaced
+    delete pending.exchange(change.release());
+}
+
+int PresetSwitchScheduler::findCommitSample(juce::AudioPlayHead* playHead, const juce::MidiBuffer& midiMessages, int numSamples,
+    double sampleRate, bool isOffline, bool outputIsQuiet) noexcept
+{
+    // The change parked at the end of the last block comes back, unless the message
+    // thread took it while processBlock was not being called
+    if (inFlight == nullptr)
+        inFlight = parked.exchange(nullptr);
+
+    const int commitSample = resolveCommitSample(playHead, midiMessages, numSamples, sampleRate, isOffline, outputIsQuiet);
+    if (commitSample < 0 && inFlight != nullptr)
+    {
+        // Not due in this block: parked where the message thread can reach it if the next block never comes
+        parked.store(inFlight);
+        inFlight = nullptr;
+    }
+    return commitSample;
+}
+
+int PresetSwitchScheduler::resolveCommitSample(juce::AudioPlayHead* playHead, const juce::MidiBuffer& midiMessages, int numSamples,
+    double sampleRate, bool isOffline, bool outputIsQuiet) noexcept
+{
+    lastAudioCallbackMs = isOffline ? 0u : juce::Time::getMillisecondCounter();
+    offlineRender = isOffline;
+
+    juce::Optional<juce::AudioPlayHead::PositionInfo> position;
+    if (playHead != nullptr)
+        position = playHead->getPosition();
+
+    const juce::int64 blockStart = position.hasValue() && position->getTimeInSamples().hasValue()
+        ? *position->getTimeInSamples() : samplePosition;
+    const bool positionJumped = blockStart != expectedBlockStart;
+    blockStartSample = blockStart;
+    expectedBlockStart = blockStart + numSamples;
+    samplePosition += numSamples;
+
+    // Every hand-over below needs room to give a change back to the message thread
+    if (returnFifo.getFreeSpace() < 2)
+        return -1;
+
+    if (cancelRequested.exchange(false))
+    {
+        if (auto* cancelled = pending.exchange(nullptr))
+            retire(cancelled);
+        if (inFlight != nullptr)
+            retire(inFlight);
+        inFlight = nullptr;
+        inFlightFlag = false;
+    }
+
+    if (pending.load() != nullptr)
+    {
+        if (auto* next = pending.exchange(nullptr))
+        {
+            if (inFlight != nullptr)
+                retire(inFlight); // superseded before it became audible
+            inFlight = next;
+            inFlight->commitAtSample = -1;
+            inFlightFlag = true;
+        }
+    }
+
+    if (inFlight == nullptr || numSamples <= 0)
+        return -1;
+
+    switch (inFlight->mode)
+    {
+        case Mode::nextSilence:
+            return outputIsQuiet ? 0 : -1;
+
+        case Mode::nextNoteOn:
+            for (const auto metadata : midiMessages)
+                if (metadata.numBytes >= 3 && (metadata.data[0] & 0xf0) == 0x90 && metadata.data[2] > 0)
+                    return juce::jlimit(0, numSamples - 1, metadata.samplePosition);
+            return -1;
+
+        case Mode::nextBeat:
+        case Mode::nextBar:
+        {
+            // A stopped transport has no grid to wait for
+            if (!position.hasValue() || !position->getIsPlaying())
+                return 0;
+
+            if (positionJumped || inFlight->commitAtSample < 0)
+                inFlight->commitAtSample = resolveGridPosition(*position, inFlight->mode, sampleRate);
+            if (inFlight->commitAtSample < 0)
+                return 0;
+
+            const auto offset = inFlight->commitAtSample - blockStartSample;
+            if (offset >= numSamples)
+                return -1;
+            return (int)juce::jmax((juce::int64)0, offset);
+        }
+
+        case Mode::immediate:
+        default:
+            return 0;
+    }
+}
+
+juce::int64 PresetSwitchScheduler::resolveGridPosition(const juce::AudioPlayHead::PositionInfo& position, Mode gridMode, double sampleRate) const noexcept
+{
+    const auto ppq = position.getPpqPosition();
+    const auto bpm = position.getBpm();
+    if (!ppq.hasValue() || !bpm.hasValue() || *bpm <= 0.0 || sampleRate <= 0.0)
+        return -1;
+
+    const auto signature = position.getTimeSignature().orFallback(juce::AudioPlayHead::TimeSignature{});
+    const double quartersPerBeat = 4.0 / juce::jmax(1, signature.denominator);
+    constexpr double epsilon = 1.0e-9;
+
+    double targetPpq = 0.0;
+    if (gridMode == Mode::nextBeat)
+    {
+        targetPpq = std::ceil(*ppq / quartersPerBeat - epsilon) * quartersPerBeat;
+    }
+    else
+    {
+        const double barLength = juce::jmax(1, signature.numerator) * quartersPerBeat;
+        targetPpq = position.getPpqPositionOfLastBarStart().orFallback(std::floor(*ppq / barLength) * barLength);
+        while (targetPpq < *ppq - epsilon)
+            targetPpq += barLength;
+    }
+
+    const double samplesPerQuarter = sampleRate * 60.0 / *bpm;
+    return blockStartSample + (juce::int64)std::llround((targetPpq - *ppq) * samplesPerQuarter);
+}
+
+void PresetSwitchScheduler::markCommitted() noexcept
+{
+    if (inFlight == nullptr)
+        return;
+
+    inFlight->committed = true;
+    retire(inFlight);
+    inFlight = nullptr;
+    inFlightFlag = false;
+}
+
+void PresetSwitchScheduler::retire(StagedChange* change) noexcept
+{
+    const auto scope = returnFifo.write(1);
+    if (scope.blockSize1 > 0)
+        returned[(size_t)scope.startIndex1] = change;
+    else if (scope.blockSize2 > 0)
+        returned[(size_t)scope.startIndex2] = change;
+}
+
+void PresetSwitchScheduler::timerCallback()
+{
+    std::vector<std::unique_ptr<StagedChange>> finished;
+    {
+        const auto scope = returnFifo.read(returnFifo.getNumReady());
+        for (int i = 0; i < scope.blockSize1; ++i)
+            finished.emplace_back(returned[(size_t)(scope.startIndex1 + i)]);
+        for (int i = 0; i < scope.blockSize2; ++i)
+            finished.emplace_back(returned[(size_t)(scope.startIndex2 + i)]);
+    }
+
+    // Realtime host that has stopped calling processBlock: apply on this thread
+    // instead of leaving the change waiting, whether the audio thread never saw it
+    // or was holding it for a beat, bar, note or silence that now won't come. Both
+    // are claimed by exchange, so a processBlock that resumes meanwhile finds
+    // nothing. Offline renders never take this path.
+    const bool audioStalled = !offlineRender.load()
+        && juce::Time::getMillisecondCounter() - lastAudioCallbackMs.load() > audioStalledMs;
+    if (audioStalled && (pending.load() != nullptr || parked.load() != nullptr))
+    {
+        std::unique_ptr<StagedChange> waiting{ parked.exchange(nullptr) };
+        std::unique_ptr<StagedChange> staged{ pending.exchange(nullptr) };
+        if (waiting != nullptr)
+            inFlightFlag = false;
+
+        // The newest change wins, as it would on the audio thread
+        auto* latest = staged != nullptr ? staged.get() : waiting.get();
+        if (latest != nullptr && !cancelRequested.exchange(false))
+        {
+            DBG("Audio thread idle, applying staged preset change directly");
+            if (applyOnMessageThread)
+                applyOnMessageThread(*latest);
+            latest->committed = true;
+        }
+        if (waiting != nullptr)
+            finished.push_back(std::move(waiting));
+        if (staged != nullptr)
+            finished.push_back(std::move(staged));
+    }
+
+    for (auto& change : finished)
+        if (change->committed && change->onCommitted)
+            change->onCommitted();
+}
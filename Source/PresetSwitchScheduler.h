@@ -0,0 +1,103 @@
+#pragma once
+#include <JuceHeader.h>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// Stages preset changes on the message thread and commits them from the audio
+// thread at a musically meaningful sample: immediately, on the next beat or
+// bar of the host playhead, right before the next note-on, or once the output
+// has gone quiet. Grid positions are resolved to an absolute sample position
+// the first time the change is seen, so the commit point does not depend on
+// the host's block size and offline renders are repeatable.
+class PresetSwitchScheduler : private juce::Timer
+{
+public:
+    enum class Mode
+    {
+        immediate = 0,
+        nextBeat,
+        nextBar,
+        nextNoteOn,
+        nextSilence
+    };
+
+    struct ParameterChange
+    {
+        int parameterIndex = -1;
+        float value = 0.0f;
+    };
+
+    enum class Target
+    {
+        primary,
+        audition
+    };
+
+    struct StagedChange
+    {
+        Target target = Target::primary;
+        Mode mode = Mode::immediate;
+        std::vector<ParameterChange> parameters;
+        std::function<void()> onCommitted;  // message thread, after the change is audible
+
+        // Audio thread only
+        juce::int64 commitAtSample = -1;
+        bool committed = false;
+    };
+
+    PresetSwitchScheduler();
+    ~PresetSwitchScheduler() override;
+
+    // Message thread
+    void setMode(Mode newMode) { mode = newMode; }
+    Mode getMode() const noexcept { return mode.load(); }
+    void stage(std::unique_ptr<StagedChange> change);
+    void cancel() { cancelRequested = true; }
+    bool hasPendingChange() const noexcept { return pending.load() != nullptr || inFlightFlag.load(); }
+
+    // Applies a change whose audio thread never picked it up (host not processing)
+    std::function<void(const StagedChange&)> applyOnMessageThread;
+
+    static juce::String getModeName(Mode modeToName);
+
+    // Audio thread: returns the sample within this block at which the staged
+    // change must be applied, or -1 if it is not due yet
+    int findCommitSample(juce::AudioPlayHead* playHead, const juce::MidiBuffer& midiMessages, int numSamples,
+        double sampleRate, bool isOffline, bool outputIsQuiet) noexcept;
+    const StagedChange* getDueChange() const noexcept { return inFlight; }
+    void markCommitted() noexcept;
+
+private:
+    void timerCallback() override;
+    int resolveCommitSample(juce::AudioPlayHead* playHead, const juce::MidiBuffer& midiMessages, int numSamples,
+        double sampleRate, bool isOffline, bool outputIsQuiet) noexcept;
+    void retire(StagedChange* change) noexcept;
+    juce::int64 resolveGridPosition(const juce::AudioPlayHead::PositionInfo& position, Mode gridMode, double sampleRate) const noexcept;
+
+    std::atomic<Mode> mode{ Mode::immediate };
+    std::atomic<StagedChange*> pending{ nullptr };
+    std::atomic<StagedChange*> parked{ nullptr };   // taken but not yet due, between blocks
+    std::atomic<bool> cancelRequested{ false };
+    std::atomic<bool> inFlightFlag{ false };
+    std::atomic<juce::uint32> lastAudioCallbackMs{ 0 };
+    std::atomic<bool> offlineRender{ false };
+
+    // Audio thread only, within a block
+    StagedChange* inFlight = nullptr;
+    juce::int64 samplePosition = 0;     // free-running fallback when the host gives no sample time
+    juce::int64 blockStartSample = 0;
+    juce::int64 expectedBlockStart = 0;  // a mismatch means the transport jumped or looped
+
+    // Changes handed back to the message thread for callbacks and deletion
+    static constexpr int returnCapacity = 32;
+    juce::AbstractFifo returnFifo{ returnCapacity };
+    std::array<StagedChange*, returnCapacity> returned{};
+
+    static constexpr juce::uint32 audioStalledMs = 500;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PresetSwitchScheduler)
+};
@@ -0,0 +1,220 @@
+#include "PreviewCache.h"
+#include <algorithm>
+
+namespace
+{
+    constexpr juce::uint64 fnvOffset = 14695981039346656037ull;
+    constexpr juce::uint64 fnvPrime = 1099511628211ull;
+
+    void hashBytes(juce::uint64& hash, const void* data, size_t numBytes) noexcept
+    {
+        auto* bytes = static_cast<const juce::uint8*>(data);
+        for (size_t i = 0; i < numBytes; ++i)
+        {
+            hash ^= bytes[i];
+            hash *= fnvPrime;
+        }
+    }
+
+    template <typename Value>
+    void hashValue(juce::uint64& hash, Value value) noexcept
+    {
+        hashBytes(hash, &value, sizeof(value));
+    }
+}
+
+PreviewCache::PreviewCache(size_t maxMemoryBytes)
+    : maxBytes(maxMemoryBytes)
+{
+}
+
+PreviewCache::~PreviewCache()
+{
+    setSpillEnabled(false);
+}
+
+void PreviewCache::setSpillEnabled(bool shouldSpill, juce::int64 maxSpillBytes)
+{
+    const juce::ScopedLock sl(lock);
+    spillStream.reset();
+    spillIndex.clear();
+    stats.spillBytes = 0;
+    if (spillFile != juce::File())
+        spillFile.deleteFile();
+    spillFile = juce::File();
+
+    spillEnabled = shouldSpill;
+    maxSpill = maxSpillBytes;
+    if (!spillEnabled)
+        return;
+
+    spillFile = juce::File::getSpecialLocation(juce::File::tempDirectory)
+        .getNonexistentChildFile("SummonerXSerum2PreviewCache", ".bin");
+    spillStream = spillFile.createOutputStream();
+    if (spillStream == nullptr)
+    {
+        DBG("Preview cache could not create spill file " << spillFile.getFullPathName());
+        spillEnabled = false;
+    }
+}
+
+bool PreviewCache::isSpillEnabled() const
+{
+    const juce::ScopedLock sl(lock);
+    return spillEnabled;
+}
+
+void PreviewCache::clear()
+{
+    const juce::ScopedLock sl(lock);
+    entries.clear();
+    index.clear();
+    stats.memoryBytes = 0;
+    if (spillEnabled)
+        setSpillEnabled(true, maxSpill);
+}
+
+juce::uint64 PreviewCache::fingerprint(const juce::String& pluginIdentifier, double sampleRate, int blockSize,
+    const std::vector<int>& notes, int velocity, double holdSeconds, double tailSeconds,
+    const std::vector<PresetSwitchScheduler::ParameterChange>& plan)
+{
+    juce::uint64 hash = fnvOffset;
+    hashBytes(hash, pluginIdentifier.toRawUTF8(), pluginIdentifier.getNumBytesAsUTF8());
+    hashValue(hash, sampleRate);
+    hashValue(hash, blockSize);
+    for (int note : notes)
+        hashValue(hash, note);
+    hashValue(hash, velocity);
+    hashValue(hash, holdSeconds);
+    hashValue(hash, tailSeconds);
+
+    // The same settings in a different order are the same sound
+    auto sorted = plan;
+    std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) { return a.parameterIndex < b.parameterIndex; });
+    for (const auto& change : sorted)
+    {
+        hashValue(hash, change.parameterIndex);
+        hashValue(hash, change.value);
+    }
+    return hash;
+}
+
+bool PreviewCache::lookup(juce::uint64 key, juce::AudioBuffer<float>& audio, AudioFeatures& features)
+{
+    const juce::ScopedLock sl(lock);
+    logStatsIfDue();
+
+    auto it = index.find(key);
+    if (it != index.end())
+    {
+        entries.splice(entries.begin(), entries, it->second);
+        audio.makeCopyOf(it->second->audio);
+        features = it->second->features;
+        ++stats.memoryHits;
+        return true;
+    }
+
+    auto spilled = spillIndex.find(key);
+    if (spilled != spillIndex.end() && readSpilled(spilled->second, audio))
+    {
+        features = spilled->second.features;
+        ++stats.spillHits;
+        return true;
+    }
+
+    ++stats.misses;
+    return false;
+}
+
+void PreviewCache::store(juce::uint64 key, const juce::AudioBuffer<float>& audio, const AudioFeatures& features)
+{
+    if (audio.getNumSamples() == 0)
+        return;
+
+    const juce::ScopedLock sl(lock);
+    if (index.count(key) != 0)
+        return;
+
+    Entry entry;
+    entry.key = key;
+    entry.audio.makeCopyOf(audio);
+    entry.features = features;
+    entry.bytes = (size_t)audio.getNumChannels() * (size_t)audio.getNumSamples() * sizeof(float);
+    stats.memoryBytes += entry.bytes;
+    entries.push_front(std::move(entry));
+    index[key] = entries.begin();
+    evictIfNeeded();
+}
+
+void PreviewCache::evictIfNeeded()
+{
+    while (stats.memoryBytes > maxBytes && entries.size() > 1)
+    {
+        auto& oldest = entries.back();
+        if (spillEnabled)
+            spill(oldest);
+        stats.memoryBytes -= oldest.bytes;
+        index.erase(oldest.key);
+        entries.pop_back();
+    }
+}
+
+void PreviewCache::spill(const Entry& entry)
+{
+    if (spillStream == nullptr || spillIndex.count(entry.key) != 0)
+        return;
+
+    if (stats.spillBytes + (juce::int64)entry.bytes > maxSpill)
+    {
+        // Full: start the spill over rather than growing without bound
+        DBG("Preview cache spill full, resetting");
+        setSpillEnabled(true, maxSpill);
+        if (spillStream == nullptr)
+            return;
+    }
+
+    SpillRecord record;
+    record.offset = spillStream->getPosition();
+    record.numChannels = entry.audio.getNumChannels();
+    record.numSamples = entry.audio.getNumSamples();
+    record.features = entry.features;
+    for (int channel = 0; channel < record.numChannels; ++channel)
+        spillStream->write(entry.audio.getReadPointer(channel), (size_t)record.numSamples * sizeof(float));
+    spillStream->flush();
+
+    stats.spillBytes = spillStream->getPosition();
+    spillIndex[entry.key] = record;
+}
+
+bool PreviewCache::readSpilled(const SpillRecord& record, juce::AudioBuffer<float>& audio)
+{
+    // A plain read: the spill stream keeps appending, which a mapping of the same file can't follow everywhere
+    juce::FileInputStream in(spillFile);
+    if (!in.openedOk() || !in.setPosition(record.offset))
+        return false;
+
+    const auto bytesPerChannel = (int)((size_t)record.numSamples * sizeof(float));
+    audio.setSize(record.numChannels, record.numSamples, false, false, false);
+    for (int channel = 0; channel < record.numChannels; ++channel)
+        if (in.read(audio.getWritePointer(channel), bytesPerChannel) != bytesPerChannel)
+            return false;
+    return true;
+}
+
+PreviewCache::Stats PreviewCache::getStats() const
+{
+    const juce::ScopedLock sl(lock);
+    return stats;
+}
+
+void PreviewCache::logStatsIfDue()
+{
+    const auto lookups = stats.memoryHits + stats.spillHits + stats.misses;
+    if (lookups == 0 || lookups % logInterval != 0)
+        return;
+
+    juce::Logger::writeToLog("PreviewCache: " + juce::String(lookups) + " lookups, hit rate "
+        + juce::String(stats.getHitRate() * 100.0, 1) + "% (" + juce::String(stats.memoryHits) + " memory, "
+        + juce::String(stats.spillHits) + " spill), " + juce::String((juce::int64)stats.memoryBytes / 1024) + " KB in memory, "
+        + juce::String(stats.spillBytes / 1024) + " KB spilled");
+}
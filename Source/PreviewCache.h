@@ -0,0 +1,85 @@
+#pragma once
+#include <JuceHeader.h>
+#include <list>
+#include <unordered_map>
+#include <vector>
+#include "AudioFeatures.h"
+#include "PresetSwitchScheduler.h"
+
+// LRU cache of rendered previews and their features, keyed by a 64-bit FNV-1a
+// fingerprint of everything that determines the render (plugin, phrase and
+// apply plan). Entries evicted from memory can spill to a temporary file that
+// is read back at the entry's offset. Thread-safe.
+class PreviewCache
+{
+public:
+    struct Stats
+    {
+        juce::int64 memoryHits = 0;
+        juce::int64 spillHits = 0;
+        juce::int64 misses = 0;
+        size_t memoryBytes = 0;
+        juce::int64 spillBytes = 0;
+
+        double getHitRate() const noexcept
+        {
+            const auto lookups = memoryHits + spillHits + misses;
+            return lookups > 0 ? (double)(memoryHits + spillHits) / (double)lookups : 0.0;
+        }
+    };
+
+    explicit PreviewCache(size_t maxMemoryBytes = 64 * 1024 * 1024);
+    ~PreviewCache();
+
+    // Spill is off until enabled; the file lives in the temp folder and is deleted with the cache
+    void setSpillEnabled(bool shouldSpill, juce::int64 maxSpillBytes = 512 * 1024 * 1024);
+    bool isSpillEnabled() const;
+    void clear();
+
+    static juce::uint64 fingerprint(const juce::String& pluginIdentifier, double sampleRate, int blockSize,
+        const std::vector<int>& notes, int velocity, double holdSeconds, double tailSeconds,
+        const std::vector<PresetSwitchScheduler::ParameterChange>& plan);
+
+    bool lookup(juce::uint64 key, juce::AudioBuffer<float>& audio, AudioFeatures& features);
+    void store(juce::uint64 key, const juce::AudioBuffer<float>& audio, const AudioFeatures& features);
+
+    Stats getStats() const;
+
+private:
+    struct Entry
+    {
+        juce::uint64 key = 0;
+        juce::AudioBuffer<float> audio;
+        AudioFeatures features;
+        size_t bytes = 0;
+    };
+
+    struct SpillRecord
+    {
+        juce::int64 offset = 0;
+        int numChannels = 0;
+        int numSamples = 0;
+        AudioFeatures features;
+    };
+
+    void evictIfNeeded();
+    void spill(const Entry& entry);
+    bool readSpilled(const SpillRecord& record, juce::AudioBuffer<float>& audio);
+    void logStatsIfDue();
+
+    mutable juce::CriticalSection lock;
+    const size_t maxBytes;
+    std::list<Entry> entries;  // most recently used first
+    std::unordered_map<juce::uint64, std::list<Entry>::iterator> index;
+    Stats stats;
+
+    bool spillEnabled = false;
+    juce::int64 maxSpill = 0;
+    juce::File spillFile;
+    std::unique_ptr<juce::FileOutputStream> spillStream;
+    std::unordered_map<juce::uint64, SpillRecord> spillIndex;
+
+    static constexpr int logInterval = 50;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PreviewCache)
+};
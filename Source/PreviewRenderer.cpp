@@ -0,0 +1,258 @@
+#include "PreviewRenderer.h"
+#include <cmath>
+
+class PreviewRenderer::RenderJob : public juce::ThreadPoolJob
+{
+public:
+    RenderJob(PreviewRenderer& r, int id, juce::uint64 key, std::vector<ParameterChange> p, Phrase ph, Callback cb)
+        : juce::ThreadPoolJob("Preview render " + juce::String(id)),
+          renderer(r), candidateId(id), cacheKey(key), plan(std::move(p)), phraseToRender(std::move(ph)),
+          onRendered(std::move(cb))
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        juce::AudioBuffer<float> audio;
+        if (auto privateInstance = renderer.acquireInstance(*this))
+        {
+            auto& instance = *privateInstance->instance;
+            if (privateInstance->preparedSampleRate != phraseToRender.sampleRate
+                || privateInstance->preparedBlockSize != phraseToRender.blockSize)
+            {
+                instance.releaseResources();
+                instance.prepareToPlay(phraseToRender.sampleRate, phraseToRender.blockSize);
+                privateInstance->preparedSampleRate = phraseToRender.sampleRate;
+                privateInstance->preparedBlockSize = phraseToRender.blockSize;
+            }
+
+            // Every candidate starts from the instance's default patch
+            instance.setStateInformation(privateInstance->defaultState.getData(), (int)privateInstance->defaultState.getSize());
+            audio = renderPhrase(instance, phraseToRender, plan, this);
+            renderer.releaseInstance(std::move(privateInstance));
+        }
+
+        if (shouldExit())
+            audio.setSize(0, 0);
+
+        DBG("Preview " << candidateId << " rendered " << audio.getNumSamples() << " samples");
+        renderer.analyseAndDeliver(candidateId, cacheKey, std::move(audio), phraseToRender.sampleRate, std::move(onRendered));
+        return jobHasFinished;
+    }
+
+private:
+    PreviewRenderer& renderer;
+    const int candidateId;
+    const juce::uint64 cacheKey;
+    const std::vector<ParameterChange> plan;
+    const Phrase phraseToRender;
+    Callback onRendered;
+};
+
+PreviewRenderer::PreviewRenderer(int maxParallelRenders)
+    : maxInstances(maxParallelRenders > 0 ? maxParallelRenders
+        : juce::jlimit(1, 4, juce::SystemStats::getNumCpus() - 1)),
+      pool(maxInstances)
+{
+    formatManager.addDefaultFormats();
+}
+
+PreviewRenderer::~PreviewRenderer()
+{
+    alive->store(false);
+    pool.removeAllJobs(true, 5000);
+    analysisOwner.release();
+    idleInstances.clear();
+}
+
+void PreviewRenderer::setPluginDescription(const juce::PluginDescription& newDescription)
+{
+    if (hasDescription && description.isDuplicateOf(newDescription))
+        return;
+
+    // Instances of a previous plugin are dropped; busy ones are freed when returned
+    const juce::ScopedLock lock(instanceLock);
+    description = newDescription;
+    hasDescription = true;
+    numInstances -= (int)idleInstances.size();
+    idleInstances.clear();
+}
+
+void PreviewRenderer::render(int candidateId, std::vector<ParameterChange> plan, Callback onRendered)
+{
+    if (!hasDescription)
+    {
+        DBG("PreviewRenderer has no plugin to render with");
+        if (onRendered)
+            onRendered(candidateId, {}, {});
+        return;
+    }
+
+    const auto key = PreviewCache::fingerprint(description.createIdentifierString(), phrase.sampleRate, phrase.blockSize,
+        phrase.notes, phrase.velocity, phrase.holdSeconds, phrase.tailSeconds, plan);
+
+    // A cache hit skips both the render and the analysis; still delivered asynchronously like a render
+    juce::AudioBuffer<float> cached;
+    AudioFeatures features;
+    if (cache.lookup(key, cached, features))
+    {
+        juce::MessageManager::callAsync([alive = alive, candidateId, callback = std::move(onRendered), result = std::move(cached), features]()
+            {
+                if (alive->load() && callback)
+                    callback(candidateId, result, features);
+            });
+        return;
+    }
+
+    pool.addJob(new RenderJob(*this, candidateId, key, std::move(plan), phrase, std::move(onRendered)), true);
+    createInstancesIfNeeded();
+}
+
+void PreviewRenderer::analyseAndDeliver(int candidateId, juce::uint64 cacheKey, juce::AudioBuffer<float> audio,
+    double sampleRate, Callback onRendered)
+{
+    // Analysis goes to the CPU lane so the render worker can start on its next candidate
+    jobs->run(BackgroundJobs::Lane::cpu, analysisOwner,
+        [this, candidateId, cacheKey, audio = std::move(audio), sampleRate, onRendered = std::move(onRendered)]() mutable
+        {
+            AudioFeatures features;
+            if (audio.getNumSamples() > 0)
+            {
+                AudioFeatureExtractor extractor;
+                features = extractor.analyse(audio, sampleRate);
+                cache.store(cacheKey, audio, features);
+            }
+
+            juce::MessageManager::callAsync([alive = alive, candidateId, callback = std::move(onRendered), result = std::move(audio), features]()
+                {
+                    if (alive->load() && callback)
+                        callback(candidateId, result, features);
+                });
+        });
+}
+
+void PreviewRenderer::cancelAll()
+{
+    pool.removeAllJobs(true, 0);
+}
+
+void PreviewRenderer::createInstancesIfNeeded()
+{
+    int toCreate = 0;
+    {
+        const juce::ScopedLock lock(instanceLock);
+        const int wanted = juce::jmin(maxInstances, pool.getNumJobs());
+        toCreate = juce::jmax(0, wanted - numInstances - numCreating);
+        numCreating += toCreate;
+    }
+
+    for (int i = 0; i < toCreate; ++i)
+    {
+        const auto createdFor = description;
+        formatManager.createPluginInstanceAsync(description, phrase.sampleRate, phrase.blockSize,
+            [this, alive = alive, createdFor](std::unique_ptr<juce::AudioPluginInstance> instance, const juce::String& errorMessage)
+            {
+                if (!alive->load())
+                    return;
+
+                const juce::ScopedLock lock(instanceLock);
+                --numCreating;
+                if (instance == nullptr || !description.isDuplicateOf(createdFor))
+                {
+                    DBG("Preview instance not created: " << errorMessage);
+                    return;
+                }
+
+                // Hidden instance: no editor is ever created for it
+                auto privateInstance = std::make_unique<PrivateInstance>();
+                instance->enableAllBuses();
+                instance->prepareToPlay(phrase.sampleRate, phrase.blockSize);
+                instance->getStateInformation(privateInstance->defaultState);
+                privateInstance->preparedSampleRate = phrase.sampleRate;
+                privateInstance->preparedBlockSize = phrase.blockSize;
+                privateInstance->instance = std::move(instance);
+                idleInstances.push_back(std::move(privateInstance));
+                ++numInstances;
+                instanceAvailable.signal();
+            });
+    }
+}
+
+std::unique_ptr<PreviewRenderer::PrivateInstance> PreviewRenderer::acquireInstance(juce::ThreadPoolJob& job)
+{
+    const auto deadline = juce::Time::getMillisecondCounter() + (juce::uint32)instanceWaitMs;
+    while (!job.shouldExit() && juce::Time::getMillisecondCounter() < deadline)
+    {
+        {
+            const juce::ScopedLock lock(instanceLock);
+            if (!idleInstances.empty())
+            {
+                auto privateInstance = std::move(idleInstances.back());
+                idleInstances.pop_back();
+                return privateInstance;
+            }
+        }
+        instanceAvailable.wait(100);
+    }
+
+    DBG("Preview render gave up waiting for an instance");
+    return nullptr;
+}
+
+void PreviewRenderer::releaseInstance(std::unique_ptr<PrivateInstance> privateInstance)
+{
+    const juce::ScopedLock lock(instanceLock);
+    if (description.isDuplicateOf(privateInstance->instance->getPluginDescription()))
+    {
+        idleInstances.push_back(std::move(privateInstance));
+        instanceAvailable.signal();
+        return;
+    }
+
+    // The plugin changed while this render ran; the instance must die on the message thread
+    --numInstances;
+    juce::MessageManager::callAsync([stale = std::shared_ptr<PrivateInstance>(std::move(privateInstance))]() {});
+}
+
+juce::AudioBuffer<float> PreviewRenderer::renderPhrase(juce::AudioPluginInstance& instance, const Phrase& phraseToRender,
+    const std::vector<ParameterChange>& plan, juce::ThreadPoolJob* job)
+{
+    const auto& parameters = instance.getParameters();
+    for (const auto& change : plan)
+        if (auto* param = parameters[change.parameterIndex])
+            param->setValue(change.value);
+    instance.reset();
+
+    const int blockSize = juce::jmax(16, phraseToRender.blockSize);
+    const int totalSamples = (int)std::ceil((phraseToRender.holdSeconds + phraseToRender.tailSeconds) * phraseToRender.sampleRate);
+    const int noteOffSample = (int)std::round(phraseToRender.holdSeconds * phraseToRender.sampleRate);
+    const int numChannels = juce::jmax(2, instance.getTotalNumInputChannels(), instance.getTotalNumOutputChannels());
+
+    juce::AudioBuffer<float> output(2, totalSamples);
+    juce::AudioBuffer<float> block(numChannels, blockSize);
+    juce::MidiBuffer midi;
+
+    for (int position = 0; position < totalSamples; position += blockSize)
+    {
+        if (job != nullptr && job->shouldExit())
+            return {};
+
+        const int numSamples = juce::jmin(blockSize, totalSamples - position);
+        block.clear();
+        midi.clear();
+        if (position == 0)
+            for (int note : phraseToRender.notes)
+                midi.addEvent(juce::MidiMessage::noteOn(1, note, (juce::uint8)phraseToRender.velocity), 0);
+        if (noteOffSample >= position && noteOffSample < position + numSamples)
+            for (int note : phraseToRender.notes)
+                midi.addEvent(juce::MidiMessage::noteOff(1, note), noteOffSample - position);
+
+        juce::AudioBuffer<float> view(block.getArrayOfWritePointers(), numChannels, numSamples);
+        instance.processBlock(view, midi);
+
+        const int outputChannels = instance.getTotalNumOutputChannels();
+        for (int channel = 0; channel < 2; ++channel)
+            output.copyFrom(channel, position, view, juce::jmin(channel, juce::jmax(0, outputChannels - 1)), 0, numSamples);
+    }
+    return output;
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include <JuceHeader.h>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "PresetSwitchScheduler.h"
+#include "AudioFeatures.h"
+#include "PreviewCache.h"
+#include "BackgroundJobs.h"
+
+// Renders candidate presets faster than realtime on background threads. Each
+// render runs on its own private, hidden Serum instance (created once and
+// reused), so the live instance and the audio thread are never touched.
+// Several candidates render in parallel, one per instance; each render is then
+// analysed on the shared CPU lane so features arrive together with the audio.
+// Finished renders are cached by fingerprint, so repeat auditions are free.
+class PreviewRenderer
+{
+public:
+    // The audition phrase: a chord held for holdSeconds, then released
+    struct Phrase
+    {
+        double sampleRate = 44100.0;
+        int blockSize = 512;
+        std::vector<int> notes{ 48, 60, 64, 67 };
+        int velocity = 100;
+        double holdSeconds = 1.0;
+        double tailSeconds = 0.5;
+    };
+
+    using ParameterChange = PresetSwitchScheduler::ParameterChange;
+    // Called on the message thread; the buffer is empty if the render failed or was cancelled
+    using Callback = std::function<void(int candidateId, const juce::AudioBuffer<float>& audio, const AudioFeatures& features)>;
+
+    explicit PreviewRenderer(int maxParallelRenders = 0);
+    ~PreviewRenderer();
+
+    // Message thread
+    void setPluginDescription(const juce::PluginDescription& newDescription);
+    void setPhrase(const Phrase& newPhrase) { phrase = newPhrase; }
+    const Phrase& getPhrase() const noexcept { return phrase; }
+    void render(int candidateId, std::vector<ParameterChange> plan, Callback onRendered);
+    void cancelAll();
+    int getNumPending() const { return pool.getNumJobs(); }
+    PreviewCache& getCache() noexcept { return cache; }
+
+    // Worker thread: renders the phrase on an instance that nobody else is using
+    static juce::AudioBuffer<float> renderPhrase(juce::AudioPluginInstance& instance, const Phrase& phraseToRender,
+        const std::vector<ParameterChange>& plan, juce::ThreadPoolJob* job);
+
+private:
+    class RenderJob;
+
+    struct PrivateInstance
+    {
+        std::unique_ptr<juce::AudioPluginInstance> instance;
+        juce::MemoryBlock defaultState;
+        double preparedSampleRate = 0.0;
+        int preparedBlockSize = 0;
+    };
+
+    std::unique_ptr<PrivateInstance> acquireInstance(juce::ThreadPoolJob& job);
+    void releaseInstance(std::unique_ptr<PrivateInstance> instance);
+    void createInstancesIfNeeded();
+    void analyseAndDeliver(int candidateId, juce::uint64 cacheKey, juce::AudioBuffer<float> audio,
+        double sampleRate, Callback onRendered);
+
+    static constexpr int instanceWaitMs = 10000;
+
+    juce::AudioPluginFormatManager formatManager;
+    juce::PluginDescription description;
+    bool hasDescription = false;
+    Phrase phrase;
+    int maxInstances = 1;
+    std::shared_ptr<std::atomic<bool>> alive = std::make_shared<std::atomic<bool>>(true);
+    PreviewCache cache;
+
+    juce::CriticalSection instanceLock;
+    std::vector<std::unique_ptr<PrivateInstance>> idleInstances;
+    int numInstances = 0;
+    int numCreating = 0;
+    juce::WaitableEvent instanceAvailable;
+
+    juce::ThreadPool pool;
+    juce::SharedResourcePointer<BackgroundJobs> jobs;
+    BackgroundJobs::Owner analysisOwner;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PreviewRenderer)
+};
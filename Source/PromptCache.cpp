@@ -0,0 +1,268 @@
+#include "PromptCache.h"
+
+namespace
+{
+    constexpr int recordMagic = 0x53585052;   // "SXPR"
+}
+
+PromptCache::PromptCache(const juce::File& directory)
+    : dataFile(directory.getChildFile("prompts.dat")),
+      indexFile(directory.getChildFile("prompts.idx"))
+{
+    directory.createDirectory();
+    loadIndex();
+}
+
+juce::File PromptCache::getDefaultDirectory()
+{
+    // Next to the settings file the rest of the plugin uses
+#if JUCE_MAC
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("Application Support/SummonerXSerum2App/PromptCache");
+#else
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("SummonerXSerum2App/PromptCache");
+#endif
+}
+
+juce::String PromptCache::canonicalize(const juce::String& prompt)
+{
+    // "Bright, plucky   BASS!" and "bright plucky bass" are the same request
+    juce::String canonical;
+    bool pendingSpace = false;
+    for (auto character : prompt.toLowerCase())
+    {
+        if (juce::CharacterFunctions::isLetterOrDigit(character))
+        {
+            if (pendingSpace && canonical.isNotEmpty())
+                canonical << ' ';
+            canonical << juce::String::charToString(character);
+            pendingSpace = false;
+        }
+        else
+        {
+            pendingSpace = true;
+        }
+    }
+    return canonical;
+}
+
+juce::int64 PromptCache::keyFor(const juce::String& canonical)
+{
+    return ("v" + juce::String(schemaVersion) + ":" + canonical).hashCode64();
+}
+
+bool PromptCache::lookup(const juce::String& prompt, Entry& entry)
+{
+    const auto canonical = canonicalize(prompt);
+    if (canonical.isEmpty())
+        return false;
+
+    juce::String storedCanonical;
+    Entry stored;
+    if (!lookup(keyFor(canonical), storedCanonical, stored))
+        return false;
+    if (storedCanonical != canonical)
+    {
+        DBG("Prompt cache record for \"" << canonical << "\" collides");
+        return false;
+    }
+
+    DBG("Prompt cache hit for \"" << canonical << "\"");
+    entry = std::move(stored);
+    return true;
+}
+
+bool PromptCache::lookup(juce::int64 key, juce::String& canonical, Entry& entry)
+{
+    auto it = index.find(key);
+    if (it == index.end())
+        return false;
+
+    if (!readRecord(it->second, canonical, entry))
+    {
+        DBG("Prompt cache record " << key << " is unreadable");
+        return false;
+    }
+    return true;
+}
+
+bool PromptCache::store(const juce::String& prompt, const std::map<std::string, std::string>& response,
+    const std::vector<PresetSwitchScheduler::ParameterChange>& plan, int parameterCount)
+{
+    const auto canonical = canonicalize(prompt);
+    if (canonical.isEmpty() || response.empty())
+        return false;
+
+    juce::MemoryOutputStream payload;
+    payload.writeInt(schemaVersion);
+    payload.writeString(canonical);
+    payload.writeCompressedInt((int)response.size());
+    for (const auto& [name, value] : response)
+    {
+        payload.writeString(juce::String(name));
+        payload.writeString(juce::String(value));
+    }
+    payload.writeInt(parameterCount);
+    payload.writeCompressedInt((int)plan.size());
+    for (const auto& change : plan)
+    {
+        payload.writeCompressedInt(change.parameterIndex);
+        payload.writeFloat(change.value);
+    }
+
+    Location location;
+    {
+        juce::FileOutputStream data(dataFile);
+        if (!data.openedOk())
+        {
+            DBG("Prompt cache could not open " << dataFile.getFullPathName());
+            return false;
+        }
+        data.writeInt(recordMagic);
+        data.writeInt((int)payload.getDataSize());
+        location.offset = data.getPosition();
+        location.size = (int)payload.getDataSize();
+        data.write(payload.getData(), payload.getDataSize());
+    }
+
+    const auto key = keyFor(canonical);
+    {
+        juce::FileOutputStream indexStream(indexFile);
+        if (indexStream.getPosition() == 0)
+        {
+            indexStream.writeInt(indexMagic);
+            indexStream.writeInt(schemaVersion);
+        }
+        indexStream.writeInt64(key);
+        indexStream.writeInt64(location.offset);
+        indexStream.writeInt(location.size);
+    }
+    index[key] = location;
+    return true;
+}
+
+void PromptCache::clear()
+{
+    index.clear();
+    dataFile.deleteFile();
+    indexFile.deleteFile();
+}
+
+void PromptCache::forEachPrompt(const std::function<void(juce::int64 key, const juce::String& canonical)>& visit) const
+{
+    juce::FileInputStream data(dataFile);
+    if (!data.openedOk())
+        return;
+
+    // One stream for all of them; the prompt is the second field of every record
+    for (const auto& [key, location] : index)
+    {
+        if (!data.setPosition(location.offset) || data.readInt() != schemaVersion)
+            continue;
+        const auto canonical = data.readString();
+        if (canonical.isNotEmpty())
+            visit(key, canonical);
+    }
+}
+
+void PromptCache::loadIndex()
+{
+    index.clear();
+    if (!dataFile.existsAsFile())
+    {
+        indexFile.deleteFile();
+        return;
+    }
+
+    juce::FileInputStream indexStream(indexFile);
+    if (!indexStream.openedOk() || indexStream.readInt() != indexMagic || indexStream.readInt() != schemaVersion)
+    {
+        rebuildIndex();
+        return;
+    }
+
+    // Entries are appended, so a later one for the same key wins
+    const auto dataSize = dataFile.getSize();
+    while (indexStream.getNumBytesRemaining() >= 20)
+    {
+        const auto key = indexStream.readInt64();
+        Location location;
+        location.offset = indexStream.readInt64();
+        location.size = indexStream.readInt();
+        if (location.offset + location.size <= dataSize)
+            index[key] = location;
+    }
+    DBG("Prompt cache loaded " << (int)index.size() << " entries");
+}
+
+void PromptCache::rebuildIndex()
+{
+    DBG("Rebuilding prompt cache index");
+    indexRebuilt = true;
+    indexFile.deleteFile();
+
+    juce::FileInputStream data(dataFile);
+    if (!data.openedOk())
+        return;
+
+    juce::FileOutputStream indexStream(indexFile);
+    indexStream.writeInt(indexMagic);
+    indexStream.writeInt(schemaVersion);
+    while (data.getNumBytesRemaining() >= 8)
+    {
+        if (data.readInt() != recordMagic)
+            break;  // Torn write at the end; everything before it is still good
+        Location location;
+        location.size = data.readInt();
+        location.offset = data.getPosition();
+        if (location.size < 0 || data.getNumBytesRemaining() < location.size)
+            break;
+
+        juce::String canonical;
+        Entry entry;
+        if (readRecord(location, canonical, entry))
+        {
+            const auto key = keyFor(canonical);
+            index[key] = location;
+            indexStream.writeInt64(key);
+            indexStream.writeInt64(location.offset);
+            indexStream.writeInt(location.size);
+        }
+        data.setPosition(location.offset + location.size);
+    }
+}
+
+bool PromptCache::readRecord(const Location& location, juce::String& canonical, Entry& entry) const
+{
+    juce::FileInputStream data(dataFile);
+    if (!data.openedOk() || !data.setPosition(location.offset))
+        return false;
+
+    juce::MemoryBlock block;
+    if (data.readIntoMemoryBlock(block, location.size) != (size_t)location.size)
+        return false;
+
+    juce::MemoryInputStream payload(block, false);
+    if (payload.readInt() != schemaVersion)
+        return false;
+
+    canonical = payload.readString();
+    const int numParameters = payload.readCompressedInt();
+    for (int i = 0; i < numParameters && !payload.isExhausted(); ++i)
+    {
+        const auto name = payload.readString().toStdString();
+        entry.response[name] = payload.readString().toStdString();
+    }
+    entry.parameterCount = payload.readInt();
+    const int planSize = payload.readCompressedInt();
+    entry.plan.reserve((size_t)juce::jmax(0, planSize));
+    for (int i = 0; i < planSize && !payload.isExhausted(); ++i)
+    {
+        PresetSwitchScheduler::ParameterChange change;
+        change.parameterIndex = payload.readCompressedInt();
+        change.value = payload.readFloat();
+        entry.plan.push_back(change);
+    }
+    return (int)entry.response.size() == numParameters && (int)entry.plan.size() == planSize;
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <JuceHeader.h>
+#include <functional>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "PresetSwitchScheduler.h"
+
+// Remembers generated responses on disk so the same prompt never costs another
+// round-trip or credit. Prompts are addressed by a hash of their canonical form
+// (case, whitespace and punctuation folded) plus the schema version. Records are
+// appended to one compact data file; a small index file maps each key to its
+// record, and is rebuilt from the data file if it goes missing.
+class PromptCache
+{
+public:
+    // Bump when the response format or the normalizer changes meaning
+    static constexpr int schemaVersion = 1;
+
+    struct Entry
+    {
+        std::map<std::string, std::string> response;
+        std::vector<PresetSwitchScheduler::ParameterChange> plan;
+        int parameterCount = 0;   // Serum parameter count the plan was built against
+    };
+
+    explicit PromptCache(const juce::File& directory = getDefaultDirectory());
+
+    static juce::File getDefaultDirectory();
+    static juce::String canonicalize(const juce::String& prompt);
+    static juce::int64 keyFor(const juce::String& canonical);
+
+    // Message thread
+    bool lookup(const juce::String& prompt, Entry& entry);
+    bool lookup(juce::int64 key, juce::String& canonical, Entry& entry);
+    // Serializes straight from the caller's data, so the response can then be moved on.
+    // Returns false when nothing was written.
+    bool store(const juce::String& prompt, const std::map<std::string, std::string>& response,
+        const std::vector<PresetSwitchScheduler::ParameterChange>& plan, int parameterCount);
+    void clear();
+    // Reads only each record's prompt; for building indexes over the history
+    void forEachPrompt(const std::function<void(juce::int64 key, const juce::String& canonical)>& visit) const;
+    int getNumEntries() const { return (int)index.size(); }
+    // True when the index had to be rebuilt from the data file on load (damaged, or another
+    // schema version), so indexes built over the history may hold stale keys
+    bool wasIndexRebuilt() const { return indexRebuilt; }
+
+private:
+    struct Location
+    {
+        juce::int64 offset = 0;
+        int size = 0;
+    };
+
+    void loadIndex();
+    void rebuildIndex();
+    bool readRecord(const Location& location, juce::String& canonical, Entry& entry) const;
+
+    static constexpr int indexMagic = 0x53585043;   // "SXPC"
+
+    juce::File dataFile;
+    juce::File indexFile;
+    std::unordered_map<juce::int64, Location> index;
+    bool indexRebuilt = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PromptCache)
+};
@@ -0,0 +1,386 @@
+#include "PromptIndex.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+ #define SUMMONER_PROMPT_INDEX_SSE2 1
+ #include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+ #define SUMMONER_PROMPT_INDEX_NEON 1
+ #include <arm_neon.h>
+#endif
+
+namespace
+{
+    constexpr juce::uint64 fnvOffset = 14695981039346656037ull;
+    constexpr juce::uint64 fnvPrime = 1099511628211ull;
+    constexpr int formatVersion = 1;
+
+    juce::uint64 hashFeature(const char* bytes, size_t numBytes, juce::uint8 kind) noexcept
+    {
+        juce::uint64 hash = fnvOffset;
+        hash ^= kind;
+        hash *= fnvPrime;
+        for (size_t i = 0; i < numBytes; ++i)
+        {
+            hash ^= (juce::uint8)bytes[i];
+            hash *= fnvPrime;
+        }
+        return hash;
+    }
+
+    // The top bit signs the feature, so collisions cancel out on average instead of piling up
+    void addFeature(float* vector, juce::uint64 hash, float weight) noexcept
+    {
+        vector[hash % (juce::uint64)PromptIndex::dimensions] += (hash >> 63) != 0 ? -weight : weight;
+    }
+
+    // Bit p of entry d is the sign of sketch hyperplane p along dimension d. Fixed
+    // forever: changing it would make every stored sketch meaningless.
+    const std::array<juce::uint64, PromptIndex::dimensions>& getPlaneSigns()
+    {
+        static const auto signs = []
+        {
+            std::array<juce::uint64, PromptIndex::dimensions> table{};
+            juce::uint64 state = 0x5358505653585056ull;
+            for (auto& entry : table)
+            {
+                // splitmix64
+                state += 0x9e3779b97f4a7c15ull;
+                auto z = state;
+                z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+                z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+                entry = z ^ (z >> 31);
+            }
+            return table;
+        }();
+        return signs;
+    }
+}
+
+PromptIndex::PromptIndex(const juce::File& directory)
+    : file(directory.getChildFile("prompts.vec"))
+{
+    directory.createDirectory();
+    load();
+}
+
+void PromptIndex::add(juce::int64 key, const juce::String& canonical)
+{
+    if (canonical.isEmpty())
+        return;
+
+    Record record{};
+    record.key = key;
+    embed(canonical, record);
+    if (record.scale > 0.0f)
+        append(record);
+}
+
+void PromptIndex::remove(juce::int64 key)
+{
+    if (slotForKey.count(key) == 0)
+        return;
+
+    Record tombstone{};
+    tombstone.key = key;
+    append(tombstone);
+}
+
+void PromptIndex::clear()
+{
+    map.reset();
+    file.deleteFile();
+    numRecords = 0;
+    slots.clear();
+    sketches.clear();
+    slotKeys.clear();
+    slotForKey.clear();
+}
+
+void PromptIndex::append(const Record& record)
+{
+    // Let go of the mapping while the file grows; the next search maps it again
+    map.reset();
+    juce::FileOutputStream out(file);
+    if (!out.openedOk())
+    {
+        DBG("Prompt index could not open " << file.getFullPathName());
+        return;
+    }
+    if (out.getPosition() == 0)
+        writeHeader(out);
+    const int recordNumber = (int)((out.getPosition() - headerSize) / (juce::int64)sizeof(Record));
+    if (!out.write(&record, sizeof(record)))
+        return;
+
+    insert(record, recordNumber);
+    numRecords = recordNumber + 1;
+}
+
+void PromptIndex::writeHeader(juce::OutputStream& out)
+{
+    out.writeInt(headerMagic);
+    out.writeInt(formatVersion);
+    out.writeInt(dimensions);
+    out.writeInt((int)sizeof(Record));
+}
+
+std::vector<PromptIndex::Suggestion> PromptIndex::search(const juce::String& text, int maxResults) const
+{
+    const auto canonical = PromptCache::canonicalize(text);
+    if (canonical.length() < 3 || slots.empty() || maxResults <= 0)
+        return {};
+
+    Record query{};
+    embed(canonical, query);
+    const auto* records = getRecords();
+    if (query.scale <= 0.0f || records == nullptr)
+        return {};
+
+    // Large histories: rank only the prompts whose sketches are closest
+    std::vector<int> candidates((size_t)slots.size());
+    std::iota(candidates.begin(), candidates.end(), 0);
+    if ((int)candidates.size() > exactScanLimit)
+    {
+        std::vector<std::pair<int, int>> distances;
+        distances.reserve(slots.size());
+        for (int slot = 0; slot < (int)sketches.size(); ++slot)
+            distances.emplace_back(juce::countNumberOfBits(sketches[(size_t)slot] ^ query.sketch), slot);
+        std::nth_element(distances.begin(), distances.begin() + sketchCandidates, distances.end());
+        candidates.resize(sketchCandidates);
+        for (int i = 0; i < sketchCandidates; ++i)
+            candidates[(size_t)i] = distances[(size_t)i].second;
+    }
+
+    std::vector<std::pair<float, int>> scored;
+    for (const auto slot : candidates)
+    {
+        const auto& record = records[slots[(size_t)slot]];
+        const float similarity = (float)dot(query.vector, record.vector) * query.scale * record.scale;
+        if (similarity >= minSimilarity)
+            scored.emplace_back(similarity, slot);
+    }
+
+    const auto numResults = std::min((size_t)maxResults, scored.size());
+    std::partial_sort(scored.begin(), scored.begin() + (std::ptrdiff_t)numResults, scored.end(),
+        [](const auto& a, const auto& b) { return a.first > b.first; });
+
+    std::vector<Suggestion> suggestions;
+    suggestions.reserve(numResults);
+    for (size_t i = 0; i < numResults; ++i)
+    {
+        const auto& record = records[slots[(size_t)scored[i].second]];
+        suggestions.push_back({ record.key, juce::String::fromUTF8(record.text, record.textLength), scored[i].first });
+    }
+    return suggestions;
+}
+
+void PromptIndex::embed(const juce::String& canonical, Record& record)
+{
+    // Trigrams catch typos and word forms ("plucky"/"pluck"); whole words weigh more
+    const auto padded = (" " + canonical + " ").toStdString();
+    float vector[dimensions] = {};
+    for (size_t i = 0; i + 3 <= padded.size(); ++i)
+        addFeature(vector, hashFeature(padded.data() + i, 3, 't'), 1.0f);
+    for (size_t start = 1; start < padded.size();)
+    {
+        const auto end = padded.find(' ', start);
+        addFeature(vector, hashFeature(padded.data() + start, end - start, 'w'), 2.0f);
+        start = end + 1;
+    }
+
+    float norm = 0.0f;
+    float largest = 0.0f;
+    for (const auto value : vector)
+    {
+        norm += value * value;
+        largest = std::max(largest, std::abs(value));
+    }
+    if (norm <= 0.0f)
+        return;
+    norm = std::sqrt(norm);
+
+    const auto& signs = getPlaneSigns();
+    float projections[64] = {};
+    for (int d = 0; d < dimensions; ++d)
+        for (int plane = 0; plane < 64; ++plane)
+            projections[plane] += ((signs[(size_t)d] >> plane) & 1) != 0 ? vector[d] : -vector[d];
+    record.sketch = 0;
+    for (int plane = 0; plane < 64; ++plane)
+        if (projections[plane] > 0.0f)
+            record.sketch |= (juce::uint64)1 << plane;
+
+    // Symmetric range, so two -128s can never overflow a 16-bit pair sum in dot()
+    const float step = largest / 127.0f;
+    for (int d = 0; d < dimensions; ++d)
+        record.vector[d] = (juce::int8)juce::jlimit(-127, 127, juce::roundToInt(vector[d] / step));
+    record.scale = step / norm;
+
+    // Cut on a character boundary
+    const auto utf8 = canonical.toStdString();
+    auto length = std::min(utf8.size(), sizeof(record.text));
+    while (length > 0 && length < utf8.size() && ((juce::uint8)utf8[length] & 0xc0) == 0x80)
+        --length;
+    std::memcpy(record.text, utf8.data(), length);
+    record.textLength = (juce::int32)length;
+}
+
+int PromptIndex::dot(const juce::int8* a, const juce::int8* b) noexcept
+{
+#if SUMMONER_PROMPT_INDEX_SSE2
+    // Sign-extend to 16 bits and multiply-add neighbouring pairs into 32-bit lanes
+    const auto zero = _mm_setzero_si128();
+    auto sum = _mm_setzero_si128();
+    for (int i = 0; i < dimensions; i += 16)
+    {
+        const auto x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        const auto y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        const auto xSign = _mm_cmpgt_epi8(zero, x);
+        const auto ySign = _mm_cmpgt_epi8(zero, y);
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_unpacklo_epi8(x, xSign), _mm_unpacklo_epi8(y, ySign)));
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_unpackhi_epi8(x, xSign), _mm_unpackhi_epi8(y, ySign)));
+    }
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(sum);
+#elif SUMMONER_PROMPT_INDEX_NEON
+    auto sum = vdupq_n_s32(0);
+    for (int i = 0; i < dimensions; i += 16)
+    {
+        const auto x = vld1q_s8(a + i);
+        const auto y = vld1q_s8(b + i);
+        auto products = vmull_s8(vget_low_s8(x), vget_low_s8(y));
+        products = vmlal_s8(products, vget_high_s8(x), vget_high_s8(y));
+        sum = vpadalq_s16(sum, products);
+    }
+    return vgetq_lane_s32(sum, 0) + vgetq_lane_s32(sum, 1) + vgetq_lane_s32(sum, 2) + vgetq_lane_s32(sum, 3);
+#else
+    int sum = 0;
+    for (int i = 0; i < dimensions; ++i)
+        sum += (int)a[i] * (int)b[i];
+    return sum;
+#endif
+}
+
+void PromptIndex::load()
+{
+    if (!file.existsAsFile())
+        return;
+
+    map = std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readOnly);
+    const auto size = (juce::int64)map->getSize();
+    const auto* header = static_cast<const char*>(map->getData());
+    if (header == nullptr || size < headerSize
+        || juce::ByteOrder::littleEndianInt(header) != (juce::uint32)headerMagic
+        || juce::ByteOrder::littleEndianInt(header + 4) != (juce::uint32)formatVersion
+        || juce::ByteOrder::littleEndianInt(header + 8) != (juce::uint32)dimensions
+        || juce::ByteOrder::littleEndianInt(header + 12) != (juce::uint32)sizeof(Record))
+    {
+        DBG("Prompt index is from another version, starting over");
+        map.reset();
+        file.deleteFile();
+        return;
+    }
+
+    const auto* records = reinterpret_cast<const Record*>(header + headerSize);
+    numRecords = (int)((size - headerSize) / (juce::int64)sizeof(Record));
+    for (int i = 0; i < numRecords; ++i)
+        insert(records[i], i);
+
+    if (numRecords - (int)slots.size() > (int)slots.size())
+    {
+        compact(records);
+        DBG("Prompt index loaded " << (int)slots.size() << " prompts, compacted");
+        return;
+    }
+
+    // A torn write at the end would misalign every record appended after it
+    const auto validSize = headerSize + (juce::int64)numRecords * (juce::int64)sizeof(Record);
+    if (validSize != size)
+    {
+        map.reset();
+        juce::FileOutputStream out(file);
+        if (out.openedOk() && out.setPosition(validSize))
+            out.truncate();
+    }
+    DBG("Prompt index loaded " << (int)slots.size() << " prompts");
+}
+
+void PromptIndex::compact(const Record* records)
+{
+    // Written beside the index and swapped in, so a failure leaves the old file as it was
+    juce::TemporaryFile temp(file);
+    {
+        juce::FileOutputStream out(temp.getFile());
+        if (!out.openedOk())
+            return;
+        writeHeader(out);
+        for (const auto recordNumber : slots)
+            if (!out.write(&records[recordNumber], sizeof(Record)))
+                return;
+    }
+
+    map.reset();
+    if (!temp.overwriteTargetFileWithTemporary())
+    {
+        DBG("Prompt index could not be compacted");
+        return;
+    }
+    std::iota(slots.begin(), slots.end(), 0);
+    numRecords = (int)slots.size();
+}
+
+void PromptIndex::insert(const Record& record, int recordNumber)
+{
+    if (record.scale <= 0.0f)
+    {
+        // A removal: the last slot moves into the freed one so slots stay dense
+        const auto removed = slotForKey.find(record.key);
+        if (removed == slotForKey.end())
+            return;
+        const auto slot = (size_t)removed->second;
+        slotForKey.erase(removed);
+        if (slot + 1 < slots.size())
+        {
+            slots[slot] = slots.back();
+            sketches[slot] = sketches.back();
+            slotKeys[slot] = slotKeys.back();
+            slotForKey[slotKeys[slot]] = (int)slot;
+        }
+        slots.pop_back();
+        sketches.pop_back();
+        slotKeys.pop_back();
+        return;
+    }
+
+    const auto [it, added] = slotForKey.try_emplace(record.key, (int)slots.size());
+    if (added)
+    {
+        slots.push_back(recordNumber);
+        sketches.push_back(record.sketch);
+        slotKeys.push_back(record.key);
+        return;
+    }
+    slots[(size_t)it->second] = recordNumber;
+    sketches[(size_t)it->second] = record.sketch;
+}
+
+const PromptIndex::Record* PromptIndex::getRecords() const
+{
+    // Remap once the file has grown past the current mapping
+    const auto needed = (size_t)headerSize + (size_t)numRecords * sizeof(Record);
+    if (map == nullptr || map->getSize() < needed)
+    {
+        map = std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readOnly);
+        if (map->getData() == nullptr || map->getSize() < needed)
+        {
+            map.reset();
+            return nullptr;
+        }
+    }
+    return reinterpret_cast<const Record*>(static_cast<const char*>(map->getData()) + headerSize);
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <JuceHeader.h>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "PromptCache.h"
+
+// Finds past prompts that read like the one being typed, so their cached
+// responses can be offered before anything is sent. Each prompt becomes a
+// 128-dimension vector of hashed character trigrams and words, stored as int8
+// with a 64-bit sign sketch. Records are fixed-size and appended to one file
+// that is searched through a memory mapping: small histories are scanned in
+// full, larger ones first narrow to the closest sketches by Hamming distance,
+// then rank those by cosine. Fifty thousand prompts search in about a millisecond.
+// Replaced and removed prompts leave dead records behind; the file is rewritten
+// with only the live ones on load once the dead outnumber them.
+class PromptIndex
+{
+public:
+    static constexpr int dimensions = 128;
+
+    struct Suggestion
+    {
+        juce::int64 key = 0;    // the prompt cache key of the response
+        juce::String prompt;    // canonical form, shortened if very long
+        float similarity = 0.0f;
+    };
+
+    explicit PromptIndex(const juce::File& directory = PromptCache::getDefaultDirectory());
+
+    // Message thread. Adding a key again replaces its earlier record.
+    void add(juce::int64 key, const juce::String& canonical);
+    void remove(juce::int64 key);
+    void clear();
+    std::vector<Suggestion> search(const juce::String& text, int maxResults) const;
+    int getNumEntries() const { return (int)slots.size(); }
+
+private:
+    struct Record
+    {
+        juce::int64 key;
+        juce::uint64 sketch;
+        float scale;            // int8 vector times scale is the unit vector; 0 marks the key removed
+        juce::int32 textLength;
+        char text[104];         // UTF-8, not terminated when full
+        juce::int8 vector[dimensions];
+    };
+    static_assert(sizeof(Record) == 256, "records are read in place from the mapped file");
+
+    static void embed(const juce::String& canonical, Record& record);
+    static int dot(const juce::int8* a, const juce::int8* b) noexcept;
+    static void writeHeader(juce::OutputStream& out);
+    void load();
+    void compact(const Record* records);
+    void append(const Record& record);
+    void insert(const Record& record, int recordNumber);
+    const Record* getRecords() const;
+
+    static constexpr int headerMagic = 0x53585056;   // "SXPV"
+    static constexpr int headerSize = 16;
+    static constexpr int exactScanLimit = 4096;      // below this every record is ranked
+    static constexpr int sketchCandidates = 2048;
+    static constexpr float minSimilarity = 0.35f;
+
+    juce::File file;
+    int numRecords = 0;
+    mutable std::unique_ptr<juce::MemoryMappedFile> map;
+    std::vector<int> slots;                    // record number of each live prompt
+    std::vector<juce::uint64> sketches;        // in slot order, so the prefilter never touches the file
+    std::vector<juce::int64> slotKeys;         // in slot order, for moving a slot when another is removed
+    std::unordered_map<juce::int64, int> slotForKey;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PromptIndex)
+};
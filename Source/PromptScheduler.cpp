@@ -0,0 +1,134 @@
+#include "PromptScheduler.h"
+#include "PromptCache.h"
+#include <algorithm>
+
+PromptScheduler::Ticket PromptScheduler::submit(const juce::String& prompt, Priority priority)
+{
+    const auto canonical = PromptCache::canonicalize(prompt);
+
+    if (active.ticket != 0 && active.canonical == canonical)
+    {
+        DBG("Prompt \"" << canonical << "\" is already running");
+        return active.ticket;
+    }
+
+    for (auto it = queue.begin(); it != queue.end(); ++it)
+    {
+        if (it->canonical != canonical)
+            continue;
+
+        DBG("Prompt \"" << canonical << "\" is already queued");
+        const auto ticket = it->ticket;
+        if (priority > it->priority)
+        {
+            auto job = *it;
+            job.priority = priority;
+            queue.erase(it);
+            auto position = std::find_if(queue.begin(), queue.end(), [priority](const Job& j) { return j.priority < priority; });
+            queue.insert(position, std::move(job));
+            notifyQueueChanged();
+        }
+        return ticket;
+    }
+
+    Job job{ nextTicket++, prompt, canonical, priority };
+    const auto ticket = job.ticket;
+    if (active.ticket == 0)
+    {
+        queue.insert(queue.begin(), std::move(job));
+        startNext();
+        return ticket;
+    }
+
+    if ((int)queue.size() >= maxQueued)
+    {
+        // Make room only by dropping the newest of the least urgent prompts
+        if (queue.back().priority >= priority)
+        {
+            DBG("Prompt queue is full, rejecting \"" << canonical << "\"");
+            return 0;
+        }
+        DBG("Prompt queue is full, dropping \"" << queue.back().canonical << "\"");
+        const auto dropped = std::move(queue.back());
+        queue.pop_back();
+        if (onDropped)
+            onDropped(dropped.ticket, dropped.prompt);
+    }
+
+    auto position = std::find_if(queue.begin(), queue.end(), [priority](const Job& j) { return j.priority < priority; });
+    queue.insert(position, std::move(job));
+    notifyQueueChanged();
+    return ticket;
+}
+
+bool PromptScheduler::cancel(Ticket ticket)
+{
+    if (ticket == 0)
+        return false;
+
+    if (ticket == active.ticket)
+    {
+        DBG("Cancelling running prompt \"" << active.canonical << "\"");
+        active = {};
+        if (onCancel)
+            onCancel(ticket);
+        startNext();
+        return true;
+    }
+
+    auto it = std::find_if(queue.begin(), queue.end(), [ticket](const Job& j) { return j.ticket == ticket; });
+    if (it == queue.end())
+        return false;
+
+    queue.erase(it);
+    notifyQueueChanged();
+    return true;
+}
+
+void PromptScheduler::cancelAll()
+{
+    queue.clear();
+    if (active.ticket != 0)
+    {
+        const auto ticket = active.ticket;
+        active = {};
+        if (onCancel)
+            onCancel(ticket);
+    }
+    notifyQueueChanged();
+}
+
+void PromptScheduler::finished(Ticket ticket)
+{
+    // Late reports for cancelled prompts are expected and ignored
+    if (ticket == 0 || ticket != active.ticket)
+        return;
+
+    active = {};
+    startNext();
+}
+
+void PromptScheduler::startNext()
+{
+    if (queue.empty())
+    {
+        notifyQueueChanged();
+        return;
+    }
+
+    active = std::move(queue.front());
+    queue.erase(queue.begin());
+    notifyQueueChanged();
+
+    // May finish synchronously (cache hit, no credits...), which starts the next one in turn
+    const auto ticket = active.ticket;
+    const auto prompt = active.prompt;
+    if (onStart)
+        onStart(ticket, prompt);
+}
+
+void PromptScheduler::notifyQueueChanged()
+{
+    if (onQueueChanged)
+        onQueueChanged();
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <JuceHeader.h>
+#include <functional>
+#include <vector>
+
+// Decides which prompt talks to the server next. One generation runs at a time;
+// up to maxQueued more wait behind it, highest priority first and in submission
+// order within a priority. A prompt that reads the same as one already running or
+// waiting (see PromptCache::canonicalize) joins it instead of costing a second
+// request. Every submission gets a ticket that can cancel it at any point.
+// Message thread only.
+class PromptScheduler
+{
+public:
+    enum class Priority
+    {
+        normal = 0,
+        high        // jumps ahead of everything waiting, never of the running prompt
+    };
+
+    using Ticket = int;   // 0 is never a valid ticket
+
+    static constexpr int maxQueued = 3;
+
+    // Starts the work for a prompt; the owner calls finished(ticket) when it is over,
+    // possibly before onStart returns
+    std::function<void(Ticket, const juce::String& prompt)> onStart;
+    // Aborts the work onStart began; finished() need not follow
+    std::function<void(Ticket)> onCancel;
+    std::function<void()> onQueueChanged;
+    // A waiting prompt pushed out of a full queue by a more urgent one; it never starts
+    std::function<void(Ticket, const juce::String& prompt)> onDropped;
+
+    // Returns the ticket of the prompt this one was coalesced into, if any,
+    // or 0 when the queue is full of prompts at least as urgent
+    Ticket submit(const juce::String& prompt, Priority priority = Priority::normal);
+    bool cancel(Ticket ticket);
+    void cancelAll();
+    void finished(Ticket ticket);
+
+    bool isBusy() const { return active.ticket != 0; }
+    Ticket getActiveTicket() const { return active.ticket; }
+    const juce::String& getActivePrompt() const { return active.prompt; }
+    int getNumQueued() const { return (int)queue.size(); }
+
+private:
+    struct Job
+    {
+        Ticket ticket = 0;
+        juce::String prompt;
+        juce::String canonical;
+        Priority priority = Priority::normal;
+    };
+
+    void startNext();
+    void notifyQueueChanged();
+
+    Job active;
+    std::vector<Job> queue;   // kept in start order
+    Ticket nextTicket = 1;
+};
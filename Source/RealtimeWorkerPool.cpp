@@ -0,0 +1,127 @@
+#include "RealtimeWorkerPool.h"
+
+RealtimeWorkerPool::RealtimeWorkerPool(int numWorkers)
+{
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        workers.push_back(std::make_unique<Worker>(*this, i));
+        workers.back()->startThread(juce::Thread::Priority::highest);
+    }
+    DBG("RealtimeWorkerPool started with " << numWorkers << " workers");
+}
+
+RealtimeWorkerPool::~RealtimeWorkerPool()
+{
+    for (auto& worker : workers)
+    {
+        worker->signalThreadShouldExit();
+        worker->wakeEvent.signal();
+    }
+    for (auto& worker : workers)
+        worker->stopThread(1000);
+}
+
+void RealtimeWorkerPool::dispatch(Job jobToRun, void* jobContext, int numJobs) noexcept
+{
+    if (numJobs <= 0)
+        return;
+
+    job = jobToRun;
+    context = jobContext;
+    jobCount.store(numJobs);
+    remainingJobs.store(numJobs);
+
+    const uint32_t round = currentRound.load() + 1;
+    claimState.store((uint64_t)round << 32);
+    currentRound.store(round);
+
+    for (auto& worker : workers)
+        if (worker->sleeping.load())
+            worker->wakeEvent.signal();
+}
+
+bool RealtimeWorkerPool::helpAndWait(juce::int64 deadlineTicks) noexcept
+{
+    runClaimedJobs(currentRound.load());
+    while (remainingJobs.load() > 0)
+    {
+        if (juce::Time::getHighResolutionTicks() >= deadlineTicks)
+            return false;
+        juce::Thread::yield();
+    }
+    return true;
+}
+
+bool RealtimeWorkerPool::claimJob(uint32_t round, int& jobIndex) noexcept
+{
+    auto state = claimState.load();
+    for (;;)
+    {
+        if ((uint32_t)(state >> 32) != round)
+            return false;
+
+        const auto nextIndex = (int)(state & 0xffffffffu);
+        if (nextIndex >= jobCount.load())
+            return false;
+
+        // Fails if another thread claimed this index or a new round started
+        if (claimState.compare_exchange_weak(state, state + 1))
+        {
+            jobIndex = nextIndex;
+            return true;
+        }
+    }
+}
+
+void RealtimeWorkerPool::runClaimedJobs(uint32_t round) noexcept
+{
+    int jobIndex = 0;
+    while (claimJob(round, jobIndex))
+    {
+        job(context, jobIndex);
+        remainingJobs.fetch_sub(1);
+    }
+}
+
+RealtimeWorkerPool::Worker::Worker(RealtimeWorkerPool& owner, int index)
+    : juce::Thread("Summoner Render Worker " + juce::String(index)),
+      wakeEvent(false),
+      pool(owner)
+{
+}
+
+void RealtimeWorkerPool::Worker::run()
+{
+    juce::ScopedNoDenormals noDenormals;
+    // Long enough to catch the next block of a small buffer without a wake-up, short
+    // enough that an idle session doesn't keep cores busy
+    const auto spinTicks = juce::Time::secondsToHighResolutionTicks(0.0002);
+    uint32_t lastRound = pool.currentRound.load();
+    auto idleSince = juce::Time::getHighResolutionTicks();
+
+    while (!threadShouldExit())
+    {
+        const auto round = pool.currentRound.load();
+        if (round != lastRound)
+        {
+            lastRound = round;
+            pool.runClaimedJobs(round);
+            idleSince = juce::Time::getHighResolutionTicks();
+            continue;
+        }
+
+        if (juce::Time::getHighResolutionTicks() - idleSince < spinTicks)
+        {
+            juce::Thread::yield();
+            continue;
+        }
+
+        // Publish that we are asleep before re-checking, so dispatch() either sees
+        // the flag or we see the new round.
+        sleeping.store(true);
+        if (pool.currentRound.load() == lastRound && !threadShouldExit())
+            wakeEvent.wait(100);
+        sleeping.store(false);
+        idleSince = juce::Time::getHighResolutionTicks();
+    }
+}
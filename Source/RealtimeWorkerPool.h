@@ -0,0 +1,55 @@
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+#include <vector>
+
+// Fixed set of worker threads that help the audio thread with a batch of jobs.
+// dispatch() and helpAndWait() never allocate or take a lock on the audio
+// thread: jobs are claimed from an atomic counter tagged with the round number,
+// the calling thread works through the batch too, and idle workers are only
+// woken when they have actually gone to sleep.
+class RealtimeWorkerPool
+{
+public:
+    using Job = void (*)(void* context, int jobIndex);
+
+    explicit RealtimeWorkerPool(int numWorkers);
+    ~RealtimeWorkerPool();
+
+    int getNumWorkers() const noexcept { return (int)workers.size(); }
+
+    // Audio thread: dispatch returns immediately; helpAndWait returns true once every
+    // job of the batch has finished, or false when deadlineTicks (high resolution
+    // ticks) passes first. Jobs still running then carry on, and no new batch may be
+    // dispatched until isBusy() is false again.
+    void dispatch(Job jobToRun, void* jobContext, int numJobs) noexcept;
+    bool helpAndWait(juce::int64 deadlineTicks) noexcept;
+    bool isBusy() const noexcept { return remainingJobs.load() > 0; }
+
+private:
+    class Worker : public juce::Thread
+    {
+    public:
+        Worker(RealtimeWorkerPool& owner, int index);
+        void run() override;
+
+        std::atomic<bool> sleeping{ false };
+        juce::WaitableEvent wakeEvent;
+
+    private:
+        RealtimeWorkerPool& pool;
+    };
+
+    bool claimJob(uint32_t round, int& jobIndex) noexcept;
+    void runClaimedJobs(uint32_t round) noexcept;
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<uint64_t> claimState{ 0 };  // high 32 bits: round, low 32 bits: next job index
+    std::atomic<uint32_t> currentRound{ 0 };
+    std::atomic<int> remainingJobs{ 0 };
+    std::atomic<int> jobCount{ 0 };
+    Job job = nullptr;          // only read after a job of the current round has been claimed
+    void* context = nullptr;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RealtimeWorkerPool)
+};
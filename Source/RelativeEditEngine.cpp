@@ -0,0 +1,253 @@
+#include "RelativeEditEngine.h"
+#include "ParameterNormalizer.h"
+#include "PromptCache.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // Targets by position in getTargets()
+    enum TargetId
+    {
+        brightness,
+        resonance,
+        reverb,
+        delay,
+        chorus,
+        distortion,
+        detune,
+        width,
+        attack,
+        decay,
+        sustain,
+        release,
+        length,
+        volume,
+        noise,
+        sub
+    };
+
+    struct Comparative
+    {
+        const char* word;
+        float direction;
+        int target;   // used unless the edit names its own
+    };
+
+    const Comparative comparatives[] = {
+        { "brighter", 1.0f, brightness }, { "darker", -1.0f, brightness }, { "duller", -1.0f, brightness },
+        { "wetter", 1.0f, reverb }, { "drier", -1.0f, reverb }, { "dryer", -1.0f, reverb },
+        { "dirtier", 1.0f, distortion }, { "grittier", 1.0f, distortion }, { "cleaner", -1.0f, distortion },
+        { "thicker", 1.0f, detune }, { "fatter", 1.0f, detune }, { "thinner", -1.0f, detune },
+        { "wider", 1.0f, width }, { "narrower", -1.0f, width },
+        { "longer", 1.0f, length }, { "shorter", -1.0f, length },
+        { "punchier", -1.0f, attack }, { "softer", 1.0f, attack },
+        { "louder", 1.0f, volume }, { "quieter", -1.0f, volume }
+    };
+
+    float directionOf(const juce::String& word)
+    {
+        for (const auto* up : { "more", "increase", "raise", "boost", "add", "up", "higher", "bigger", "extra" })
+            if (word == up)
+                return 1.0f;
+        for (const auto* down : { "less", "decrease", "lower", "reduce", "cut", "down", "fewer", "smaller" })
+            if (word == down)
+                return -1.0f;
+        return 0.0f;
+    }
+
+    float amountOf(const juce::String& word)
+    {
+        for (const auto* small : { "slightly", "bit", "little", "touch", "tad", "tiny" })
+            if (word == small)
+                return 0.5f;
+        for (const auto* large : { "much", "lot", "lots", "way", "very", "really", "significantly", "heaps" })
+            if (word == large)
+                return 2.0f;
+        return 0.0f;
+    }
+
+    bool isFiller(const juce::String& word)
+    {
+        for (const auto* filler : { "a", "an", "the", "and", "it", "its", "make", "please", "some", "of", "on",
+                                    "with", "to", "sound", "also", "then", "too", "just", "give", "me" })
+            if (word == filler)
+                return true;
+        return false;
+    }
+
+    int findIndex(const std::map<std::string, int>& parameterIndices, const char* name)
+    {
+        // The normalizer owns the mapping from the server's names to Serum's
+        const auto it = parameterIndices.find(normalizeValue(name, "=0").first);
+        return it == parameterIndices.end() ? -1 : it->second;
+    }
+}
+
+RelativeEditEngine::RelativeEditEngine()
+{
+    const auto& targets = getTargets();
+    for (int i = 0; i < (int)targets.size(); ++i)
+        for (const auto* word : targets[(size_t)i].words)
+            targetIndex.emplace(word, i);
+}
+
+bool RelativeEditEngine::interpret(const juce::String& prompt, juce::AudioPluginInstance& instance,
+    const std::map<std::string, int>& parameterIndices,
+    std::vector<ParameterChange>& plan, std::map<std::string, std::string>& response) const
+{
+    std::vector<Edit> edits;
+    if (!parse(prompt, edits))
+        return false;
+
+    const auto& parameters = instance.getParameters();
+    const auto valueAt = [&parameters](int index) { return parameters[index]->getValue(); };
+    const auto& targets = getTargets();
+
+    std::vector<ParameterChange> changes;
+    std::vector<std::pair<const char*, std::string>> values;
+    for (const auto& edit : edits)
+    {
+        const auto& target = targets[(size_t)edit.target];
+        bool switchedOn = false;
+        if (target.enable != nullptr)
+        {
+            const int enableIndex = findIndex(parameterIndices, target.enable);
+            if (enableIndex >= 0 && enableIndex < parameters.size() && valueAt(enableIndex) < 0.5f)
+            {
+                // Less of an effect that is off is already done; more of it starts from nothing.
+                // A filter that is off is already as bright as it gets, so only darker switches it on.
+                if (target.offIsFull ? edit.amount > 0.0f : edit.amount < 0.0f)
+                    continue;
+                changes.push_back({ enableIndex, normalizeValue(target.enable, "on").second });
+                values.emplace_back(target.enable, "on");
+                switchedOn = true;
+            }
+        }
+
+        for (const auto* name : target.parameters)
+        {
+            const int index = findIndex(parameterIndices, name);
+            if (index < 0 || index >= parameters.size())
+                continue;
+            const float current = switchedOn && !target.offIsFull ? 0.0f : valueAt(index);
+            const float value = juce::jlimit(0.0f, 1.0f, current + edit.amount * target.step);
+            if (std::abs(value - current) < 1.0e-4f && !switchedOn)
+                continue;
+            changes.push_back({ index, value });
+            values.emplace_back(name, rawNormalizedValue(value));
+        }
+    }
+
+    plan = std::move(changes);
+    for (auto& [name, value] : values)
+        response.insert_or_assign(name, std::move(value));
+    DBG("Relative edit \"" << prompt << "\": " << (int)edits.size() << " edits, " << (int)plan.size() << " parameter changes");
+    return true;
+}
+
+bool RelativeEditEngine::parse(const juce::String& prompt, std::vector<Edit>& edits) const
+{
+    const auto words = juce::StringArray::fromTokens(PromptCache::canonicalize(prompt), " ", "");
+
+    float direction = 0.0f;
+    float amount = 1.0f;
+    int target = -1;
+    bool targetIsImplied = false;   // from a comparative ("shorter"), replaced by a named target
+    const auto complete = [&]() { return direction != 0.0f && target >= 0; };
+    const auto flush = [&]()
+    {
+        edits.push_back({ target, direction * amount });
+        direction = 0.0f;
+        amount = 1.0f;
+        target = -1;
+        targetIsImplied = false;
+    };
+
+    for (const auto& word : words)
+    {
+        if (const float scale = amountOf(word); scale > 0.0f)
+        {
+            if (complete())
+                flush();
+            amount *= scale;
+            continue;
+        }
+        if (isFiller(word))
+            continue;
+
+        const auto comparative = std::find_if(std::begin(comparatives), std::end(comparatives),
+            [&word](const Comparative& c) { return word == c.word; });
+        if (comparative != std::end(comparatives))
+        {
+            // "release shorter" keeps its named target; otherwise the comparative starts a new edit
+            if (target >= 0 && !targetIsImplied && direction == 0.0f)
+            {
+                direction = comparative->direction;
+                continue;
+            }
+            if (complete())
+                flush();
+            direction = comparative->direction;
+            target = comparative->target;
+            targetIsImplied = true;
+            continue;
+        }
+
+        if (const float next = directionOf(word); next != 0.0f)
+        {
+            if (complete())
+                flush();
+            direction = next;
+            continue;
+        }
+
+        auto it = targetIndex.find(word.toStdString());
+        if (it == targetIndex.end())
+            return false;   // not an edit word: the prompt is for the server
+        if (target >= 0 && !targetIsImplied)
+        {
+            // "more reverb and delay": the direction carries over to the next target
+            if (direction == 0.0f)
+                return false;
+            const float carried = direction;
+            flush();
+            direction = carried;
+        }
+        target = it->second;
+        targetIsImplied = false;
+    }
+
+    if (direction != 0.0f || target >= 0)
+    {
+        if (!complete())
+            return false;
+        flush();
+    }
+    return !edits.empty();
+}
+
+const std::vector<RelativeEditEngine::Target>& RelativeEditEngine::getTargets()
+{
+    // In TargetId order. Steps are in normalized units: about a third of an
+    // octave of cutoff, a tenth of an effect's mix, a notch on the envelope tables.
+    static const std::vector<Target> targets = {
+        { { "brightness", "cutoff", "filter", "highs", "treble" }, { "Fil Cutoff" }, 0.08f, "Filter On", true },
+        { { "resonance", "reso", "res", "resonant" }, { "Fil Reso" }, 0.08f, nullptr },
+        { { "reverb", "verb", "space", "room", "ambience" }, { "Verb Wet" }, 0.1f, "Rev Enable" },
+        { { "delay", "echo", "echoes" }, { "Dly_Wet" }, 0.1f, "Dly Enable" },
+        { { "chorus" }, { "Cho_Wet" }, 0.1f, "Cho Enable" },
+        { { "distortion", "drive", "grit", "dirt", "saturation", "crunch" }, { "Dist_Drv" }, 0.1f, "Dist Enable" },
+        { { "detune", "detuning", "unison" }, { "A UniDet", "B UniDet" }, 0.08f, nullptr },
+        { { "width", "stereo", "spread" }, { "HypDim_Mix" }, 0.1f, "Hyp Enable" },
+        { { "attack" }, { "Env1 Atk" }, 0.06f, nullptr },
+        { { "decay" }, { "Env1 Dec" }, 0.06f, nullptr },
+        { { "sustain" }, { "Env1 Sus" }, 0.08f, nullptr },
+        { { "release", "tail" }, { "Env1 Rel" }, 0.06f, nullptr },
+        { { "length", "notes" }, { "Env1 Dec", "Env1 Rel" }, 0.06f, nullptr },
+        { { "volume", "level", "gain" }, { "A Vol" }, 0.08f, nullptr },
+        { { "noise", "air" }, { "Noise Level" }, 0.08f, "Osc N On" },
+        { { "sub", "bass", "lows" }, { "Sub Osc Level" }, 0.08f, "Osc S On" },
+    };
+    return targets;
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <JuceHeader.h>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "PresetSwitchScheduler.h"
+
+// Understands tweak prompts ("brighter", "more reverb", "a bit shorter release
+// and less detune") without the server. Each edit is a direction, an optional
+// amount and a target; a target names the parameters it moves and by how much
+// per step. The new values are computed from what the instance plays right now,
+// so an edit works on any sound, generated or not.
+// A prompt is only taken when every word is part of an edit; anything else
+// ("brighter like a 90s trance lead") is left for the server.
+class RelativeEditEngine
+{
+public:
+    using ParameterChange = PresetSwitchScheduler::ParameterChange;
+
+    RelativeEditEngine();
+
+    // Fills plan with the changes against instance's current values and writes the
+    // new values into response (in the normalizer's "=0.42" form). Returns false,
+    // touching neither, when the prompt isn't made of relative edits.
+    bool interpret(const juce::String& prompt, juce::AudioPluginInstance& instance,
+        const std::map<std::string, int>& parameterIndices,
+        std::vector<ParameterChange>& plan, std::map<std::string, std::string>& response) const;
+
+private:
+    struct Target
+    {
+        std::vector<const char*> words;
+        std::vector<const char*> parameters;   // names as the server writes them
+        float step;                             // normalized change for "more"/"less"
+        const char* enable;                     // switched on when raising an effect that is off; may be null
+        bool offIsFull = false;                 // off passes everything (a filter), so it is switched on when lowering
+    };
+
+    struct Edit
+    {
+        int target;
+        float amount;   // signed steps
+    };
+
+    bool parse(const juce::String& prompt, std::vector<Edit>& edits) const;
+    static const std::vector<Target>& getTargets();
+
+    std::unordered_map<std::string, int> targetIndex;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RelativeEditEngine)
+};
@@ -0,0 +1,263 @@
+#include "ResponseDecoder.h"
+#include "ParameterNormalizer.h"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    // Position of the next '"' or '\\' at or after from, or size. Eight bytes are
+    // tested at a time (SWAR: a byte equal to the target becomes zero after the XOR,
+    // and the usual has-zero-byte trick finds it), so long plain strings cost about
+    // one step per word instead of one per character.
+    size_t findQuoteOrEscape(const char* data, size_t size, size_t from)
+    {
+        constexpr juce::uint64 ones = 0x0101010101010101ull;
+        constexpr juce::uint64 highBits = 0x8080808080808080ull;
+        constexpr juce::uint64 quotes = ones * (juce::uint64)'"';
+        constexpr juce::uint64 escapes = ones * (juce::uint64)'\\';
+
+        size_t i = from;
+        for (; i + 8 <= size; i += 8)
+        {
+            juce::uint64 word;
+            std::memcpy(&word, data + i, 8);
+            const auto q = word ^ quotes;
+            const auto e = word ^ escapes;
+            if ((((q - ones) & ~q) | ((e - ones) & ~e)) & highBits)
+                break;
+        }
+        for (; i < size; ++i)
+            if (data[i] == '"' || data[i] == '\\')
+                return i;
+        return size;
+    }
+
+    int hexValue(char c)
+    {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    void appendUtf8(std::string& out, juce::uint32 codePoint)
+    {
+        if (codePoint < 0x80)
+        {
+            out += (char)codePoint;
+        }
+        else if (codePoint < 0x800)
+        {
+            out += (char)(0xc0 | (codePoint >> 6));
+            out += (char)(0x80 | (codePoint & 0x3f));
+        }
+        else if (codePoint < 0x10000)
+        {
+            out += (char)(0xe0 | (codePoint >> 12));
+            out += (char)(0x80 | ((codePoint >> 6) & 0x3f));
+            out += (char)(0x80 | (codePoint & 0x3f));
+        }
+        else
+        {
+            out += (char)(0xf0 | (codePoint >> 18));
+            out += (char)(0x80 | ((codePoint >> 12) & 0x3f));
+            out += (char)(0x80 | ((codePoint >> 6) & 0x3f));
+            out += (char)(0x80 | (codePoint & 0x3f));
+        }
+    }
+}
+
+bool ResponseDecoder::decode(std::string_view json, const std::map<std::string, int>& parameterIndices, Result& result)
+{
+    if (!begin(json))
+        return false;
+
+    result.plan.reserve(lastMemberCount);
+    size_t memberCount = 0;
+    std::string_view key, value;
+    int status;
+    while ((status = next(key, value)) > 0)
+    {
+        ++memberCount;
+        if (key == "detail")
+        {
+            result.detail = juce::String::fromUTF8(value.data(), (int)value.size());
+            continue;
+        }
+
+        nameArgument.assign(key);
+        valueArgument.assign(value);
+        const auto normalized = normalizeValue(nameArgument, valueArgument);
+        result.response.insert_or_assign(nameArgument, valueArgument);
+
+        auto it = parameterIndices.find(normalized.first);
+        if (it != parameterIndices.end())
+            result.plan.push_back({ it->second, std::clamp(normalized.second, 0.0f, 1.0f) });
+        else
+            DBG("Parameter " << normalized.first << " not found in parameter map.");
+    }
+
+    lastMemberCount = std::max(lastMemberCount, memberCount);
+    return status == 0;
+}
+
+bool ResponseDecoder::begin(std::string_view json)
+{
+    input = json;
+    position = 0;
+    first = true;
+    skipWhitespace();
+    if (position >= input.size() || input[position] != '{')
+        return false;
+    ++position;
+    return true;
+}
+
+int ResponseDecoder::next(std::string_view& key, std::string_view& value)
+{
+    skipWhitespace();
+    if (position >= input.size())
+        return -1;
+    if (input[position] == '}')
+    {
+        ++position;
+        return 0;
+    }
+    if (!first)
+    {
+        if (input[position] != ',')
+            return -1;
+        ++position;
+        skipWhitespace();
+    }
+    first = false;
+
+    if (position >= input.size() || input[position] != '"' || !readString(key, keyScratch))
+        return -1;
+    skipWhitespace();
+    if (position >= input.size() || input[position] != ':')
+        return -1;
+    ++position;
+    skipWhitespace();
+    if (position >= input.size())
+        return -1;
+
+    const bool ok = input[position] == '"' ? readString(value, valueScratch) : readLiteral(value);
+    return ok ? 1 : -1;
+}
+
+bool ResponseDecoder::readString(std::string_view& out, std::string& scratch)
+{
+    const char* data = input.data();
+    const size_t size = input.size();
+    const size_t start = ++position;   // past the opening quote
+
+    size_t special = findQuoteOrEscape(data, size, start);
+    if (special >= size)
+        return false;
+    if (data[special] == '"')
+    {
+        // The common case: no escapes, so the value is a view straight into the body
+        out = input.substr(start, special - start);
+        position = special + 1;
+        return true;
+    }
+
+    scratch.assign(data + start, special - start);
+    position = special;
+    while (position < size)
+    {
+        const char c = data[position];
+        if (c == '"')
+        {
+            ++position;
+            out = scratch;
+            return true;
+        }
+        if (c != '\\')
+        {
+            special = findQuoteOrEscape(data, size, position);
+            scratch.append(data + position, special - position);
+            position = special;
+            continue;
+        }
+
+        if (++position >= size)
+            return false;
+        switch (data[position++])
+        {
+            case '"':  scratch += '"';  break;
+            case '\\': scratch += '\\'; break;
+            case '/':  scratch += '/';  break;
+            case 'b':  scratch += '\b'; break;
+            case 'f':  scratch += '\f'; break;
+            case 'n':  scratch += '\n'; break;
+            case 'r':  scratch += '\r'; break;
+            case 't':  scratch += '\t'; break;
+            case 'u':
+            {
+                if (position + 4 > size)
+                    return false;
+                juce::uint32 codePoint = 0;
+                for (int i = 0; i < 4; ++i)
+                {
+                    const int digit = hexValue(data[position++]);
+                    if (digit < 0)
+                        return false;
+                    codePoint = (codePoint << 4) | (juce::uint32)digit;
+                }
+                // A surrogate pair spells one code point above the BMP
+                if (codePoint >= 0xd800 && codePoint < 0xdc00 && position + 6 <= size
+                    && data[position] == '\\' && data[position + 1] == 'u')
+                {
+                    juce::uint32 low = 0;
+                    bool valid = true;
+                    for (int i = 2; i < 6; ++i)
+                    {
+                        const int digit = hexValue(data[position + (size_t)i]);
+                        valid = valid && digit >= 0;
+                        low = (low << 4) | (juce::uint32)juce::jmax(0, digit);
+                    }
+                    if (valid && low >= 0xdc00 && low < 0xe000)
+                    {
+                        codePoint = 0x10000 + ((codePoint - 0xd800) << 10) + (low - 0xdc00);
+                        position += 6;
+                    }
+                }
+                appendUtf8(scratch, codePoint);
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+    return false;
+}
+
+bool ResponseDecoder::readLiteral(std::string_view& out)
+{
+    // Numbers, true, false and null; nested objects and arrays are not part of the format
+    const size_t start = position;
+    while (position < input.size())
+    {
+        const char c = input[position];
+        if (c == ',' || c == '}' || c == ' ' || c == '\t' || c == '\r' || c == '\n')
+            break;
+        if (c == '{' || c == '[' || c == '"')
+            return false;
+        ++position;
+    }
+    out = input.substr(start, position - start);
+    return !out.empty();
+}
+
+void ResponseDecoder::skipWhitespace()
+{
+    while (position < input.size())
+    {
+        const char c = input[position];
+        if (c != ' ' && c != '\t' && c != '\r' && c != '\n')
+            break;
+        ++position;
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <JuceHeader.h>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "PresetSwitchScheduler.h"
+
+// Single-pass reader for the flat JSON objects the generation endpoints return
+// ({"Env1 Atk": "12 ms", ...} and the streamed {"name": ..., "value": ...} lines).
+// There is no value tree: members are handed out as views into the body, and
+// only strings with escapes are copied, into scratch buffers that are reused
+// from one call to the next. decode() normalizes each member as it is read and
+// writes the apply plan directly, so a response is parsed exactly once.
+// Not thread-safe; give each caller its own decoder.
+class ResponseDecoder
+{
+public:
+    using ParameterChange = PresetSwitchScheduler::ParameterChange;
+
+    struct Result
+    {
+        std::map<std::string, std::string> response;
+        std::vector<ParameterChange> plan;
+        juce::String detail;   // set when the server answered with an error instead
+    };
+
+    // Returns false if the body is not a flat JSON object
+    bool decode(std::string_view json, const std::map<std::string, int>& parameterIndices, Result& result);
+
+    // Calls onMember(key, value) for each member in document order. String values
+    // arrive unquoted and unescaped, anything else (numbers, true, null) as written.
+    // Views are only valid during the call. Returns false on malformed or nested input.
+    template <typename Handler>
+    bool forEachMember(std::string_view json, Handler&& onMember)
+    {
+        if (!begin(json))
+            return false;
+
+        std::string_view key, value;
+        int status;
+        while ((status = next(key, value)) > 0)
+            onMember(key, value);
+        return status == 0;
+    }
+
+    static std::string_view viewOf(const juce::String& text)
+    {
+        return { text.toRawUTF8(), text.getNumBytesAsUTF8() };
+    }
+
+private:
+    bool begin(std::string_view json);
+    // 1: a member was read, 0: end of the object, -1: malformed
+    int next(std::string_view& key, std::string_view& value);
+    bool readString(std::string_view& out, std::string& scratch);
+    bool readLiteral(std::string_view& out);
+    void skipWhitespace();
+
+    std::string_view input;
+    size_t position = 0;
+    bool first = true;
+    std::string keyScratch, valueScratch;
+    std::string nameArgument, valueArgument;   // the normalizer takes std::string
+    size_t lastMemberCount = 64;
+};
@@ -1,6 +1,7 @@
 #include "SerumInterfaceComponent.h"
 #include <juce_audio_processors/juce_audio_processors.h>
 #include "PluginProcessor.h" 
+#include <map>
 
 class SerumButtonLookAndFeel : public juce::LookAndFeel_V4
 {
@@ -51,6 +52,20 @@ SerumInterfaceComponent::SerumInterfaceComponent(juce::AudioProcessor& processor
     addAndMakeVisible(nextButton);
     addAndMakeVisible(prevButton);
     addAndMakeVisible(responseCounter);
+    addAndMakeVisible(abModeButton);
+    addChildComponent(abSwitchButton);
+    addAndMakeVisible(stackButton);
+    addAndMakeVisible(layersButton);
+    addAndMakeVisible(switchModeButton);
+    addAndMakeVisible(morphButton);
+    addAndMakeVisible(outputMeter);
+    for (auto* button : { &abModeButton, &abSwitchButton, &stackButton, &layersButton, &switchModeButton, &morphButton })
+    {
+        button->setColour(juce::TextButton::buttonColourId, juce::Colours::black);
+        button->setColour(juce::TextButton::textColourOnId, juce::Colours::whitesmoke);
+        button->setColour(juce::TextButton::textColourOffId, juce::Colours::white);
+        button->setLookAndFeel(&customSerumButtons);
+    }
     nextButton.setButtonText("Next");
     nextButton.setColour(juce::TextButton::buttonColourId, juce::Colours::black);
     nextButton.setColour(juce::TextButton::textColourOnId, juce::Colours::whitesmoke);
@@ -81,22 +96,102 @@ SerumInterfaceComponent::SerumInterfaceComponent(juce::AudioProcessor& processor
         }
         };
 
+    abModeButton.onClick = [this]() {
+        if (auto* proc = dynamic_cast<SummonerXSerum2AudioProcessor*>(&parentProcessor))
+        {
+            proc->setABMode(!isABModeEnabled());
+            updateResponseCounter();
+        }
+        };
+
+    abSwitchButton.onClick = [this]() {
+        if (auto* proc = dynamic_cast<SummonerXSerum2AudioProcessor*>(&parentProcessor))
+        {
+            proc->toggleAudition();
+            updateResponseCounter();
+        }
+        };
+
+    stackButton.onClick = [this]() {
+        if (auto* proc = dynamic_cast<SummonerXSerum2AudioProcessor*>(&parentProcessor))
+            proc->addLayerFromResponse(proc->getCurrentResponseIndex());
+        };
+
+    layersButton.onClick = [this]() {
+        showLayerMenu();
+        };
+
+    // Morphs the current response with up to three that follow it
+    morphButton.onClick = [this]() {
+        if (auto* proc = dynamic_cast<SummonerXSerum2AudioProcessor*>(&parentProcessor))
+        {
+            if (proc->isMorphActive())
+            {
+                proc->clearMorph();
+            }
+            else
+            {
+                std::vector<int> sources;
+                for (int index = proc->getCurrentResponseIndex(); index < proc->getResponseCount() && (int)sources.size() < MorphEngine::maxSources; ++index)
+                    sources.push_back(index);
+                proc->setMorphSources(sources);
+            }
+            morphButton.setButtonText(proc->isMorphActive() ? "Unmorph" : "Morph");
+        }
+        };
+
+    switchModeButton.onClick = [this]() {
+        if (auto* proc = dynamic_cast<SummonerXSerum2AudioProcessor*>(&parentProcessor))
+        {
+            const int next = ((int)proc->getSwitchMode() + 1) % ((int)PresetSwitchScheduler::Mode::nextSilence + 1);
+            proc->setSwitchMode((PresetSwitchScheduler::Mode)next);
+            updateSwitchModeButton();
+        }
+        };
+
     responseCounter.setJustificationType(juce::Justification::centred);
     responseCounter.setFont(juce::Font("Press Start 2P", 12.0f, juce::Font::plain));
     updateResponseCounter();
+    updateABButtons();
+    // The processor is still being constructed here, so show its default mode
+    switchModeButton.setButtonText("On " + PresetSwitchScheduler::getModeName(PresetSwitchScheduler::Mode::immediate));
+
+    instanceSlot.onReclaimed = [this](std::unique_ptr<juce::AudioPluginInstance> instance) {
+        addToStandbyPool(std::move(instance));
+        };
+    auditionSlot.onReclaimed = instanceSlot.onReclaimed;
+    layerGraph.setReclaimHandler(instanceSlot.onReclaimed);
+
+    cpuGovernor.getInstances = [this] {
+        juce::Array<juce::AudioPluginInstance*> instances;
+        if (auto* instance = getSerumInstance())
+            instances.add(instance);
+        if (auto* audition = getAuditionInstance())
+            instances.add(audition);
+        for (int i = 0; i < LayerGraph::maxLayers; ++i)
+            if (auto* layer = layerGraph.getLayerInstance(i))
+                instances.add(layer);
+        return instances;
+        };
 }
 
 SerumInterfaceComponent::~SerumInterfaceComponent()
 {
-    const juce::ScopedLock lock(criticalSection);
+    cpuGovernor.getInstances = nullptr;
+    instanceSlot.onReclaimed = nullptr;
+    auditionSlot.onReclaimed = nullptr;
+    layerGraph.setReclaimHandler(nullptr);
+    layerGraph.clear();
     serumEditor = nullptr;
-    serumInstance = nullptr;
+    instanceSlot.clear();
+    auditionSlot.clear();
+    standbyPool.clear();
 }
 
 void SerumInterfaceComponent::paint(juce::Graphics& g)
 {
     g.fillAll(juce::Colours::black);
-    if (!serumInstance)
+    if (getSerumInstance() == nullptr)
     {
         g.setColour(juce::Colours::white);
         g.setFont(juce::Font("Press Start 2P", 12.0f, juce::Font::plain));
@@ -113,13 +208,14 @@ void SerumInterfaceComponent::setPluginInstance(juce::AudioPluginInstance* newPl
         return;
     }
 
-    if (serumInstance.get() == newPlugin)
+    if (getSerumInstance() == newPlugin)
     {
         DBG("setPluginInstance called, but instance is already set.");
         return;
     }
-    serumInstance.reset(newPlugin);
-    serumEditor.reset(serumInstance->createEditorIfNeeded());
+    serumEditor.reset();
+    instanceSlot.publish(std::unique_ptr<juce::AudioPluginInstance>(newPlugin));
+    serumEditor.reset(newPlugin->createEditorIfNeeded());
     if (serumEditor)
     {
         DBG("Editor successfully created in SerumInterfaceComponent.");
@@ -134,10 +230,26 @@ void SerumInterfaceComponent::setPluginInstance(juce::AudioPluginInstance* newPl
 
 void SerumInterfaceComponent::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
-    if (serumInstance != nullptr)
+    // Scratch space for rendering the outgoing instance during a hot-swap crossfade
+    crossfadeBuffer.setSize(2, samplesPerBlock, false, true, true);
+    crossfadeMidi.ensureSize(4096);
+    auditionBuffer.setSize(2, samplesPerBlock, false, true, true);
+    auditionMidi.ensureSize(4096);
+    resumeMidi.ensureSize(4096);
+    abCrossfadeSamples = juce::jmax(1, juce::roundToInt(sampleRate * abCrossfadeSeconds));
+
+    if (auto* audition = getAuditionInstance())
+        audition->prepareToPlay(sampleRate, samplesPerBlock);
+    layerGraph.prepareToPlay(sampleRate, samplesPerBlock);
+    silenceGate.prepare(sampleRate);
+    cpuGovernor.prepare(sampleRate);
+    outputMeter.prepare(sampleRate);
+
+    if (auto* instance = getSerumInstance())
     {
         DBG("Preparing Serum with sample rate: " << sampleRate << " and block size: " << samplesPerBlock);
-        serumInstance->prepareToPlay(sampleRate, samplesPerBlock);
+        instance->prepareToPlay(sampleRate, samplesPerBlock);
+        silenceGate.setPluginTailSeconds(instance->getTailLengthSeconds());
     }
     else
     {
@@ -165,9 +277,12 @@ void SerumInterfaceComponent::processMidiAndAudio(juce::AudioBuffer<float>& audi
     {
         //DBG("MIDI buffer is empty. No notes sent to Serum.");
     }
-    if (serumInstance != nullptr)
+    // Never take a lock here: the instance is read through the slot's epoch guard,
+    // and a missing instance simply renders silence for this block.
+    HostedInstanceSlot::ReadScope readScope(instanceSlot);
+    auto* instance = readScope.get();
+    if (instance != nullptr)
     {
-        juce::ScopedLock lock(criticalSection);
         //DBG("processMidiAndAudio called!");
         //DBG("Audio buffer before Serum: " << audioBuffer.getMagnitude(0, audioBuffer.getNumSamples()));
         if (!midiMessages.isEmpty())
@@ -178,17 +293,42 @@ void SerumInterfaceComponent::processMidiAndAudio(juce::AudioBuffer<float>& audi
         {
             //DBG("MIDI buffer is empty before forwarding to Serum.");
         }
-        serumInstance->processBlock(audioBuffer, midiMessages);
-        //DBG("Audio buffer after Serum: " << audioBuffer.getMagnitude(0, audioBuffer.getNumSamples()));
+        // Idle instances are not called at all until MIDI arrives again
+        if (!silenceGate.shouldProcess(midiMessages))
+        {
+            audioBuffer.clear();
+            return;
+        }
+
+        const auto renderStartTicks = juce::Time::getHighResolutionTicks();
 
-        if (audioBuffer.getMagnitude(0, audioBuffer.getNumSamples()) > 0.0f)
+        // Layers start on the workers first so they overlap with the primary render
+        const bool layersRendering = layerGraph.beginRender(midiMessages, audioBuffer.getNumChannels(), audioBuffer.getNumSamples());
+
+        HostedInstanceSlot::ReadScope auditionScope(auditionSlot);
+        auto* audition = abModeEnabled.load() || auditionReleasePending.load() ? auditionScope.get() : nullptr;
+        if (audition != nullptr)
         {
-            //DBG("Audio data present in buffer.");
+            renderAB(readScope, *instance, *audition, audioBuffer, midiMessages);
         }
         else
         {
-            //DBG("No audio generated by Serum.");
+            auditionGain = 0.0f;
+            auditionSuspended = true;
+            renderPrimaryResuming(readScope, *instance, audioBuffer, midiMessages);
         }
+        auditionFadedOut = auditionGain <= 0.0f;
+
+        if (layersRendering)
+            layerGraph.finishAndMix(audioBuffer);
+        cpuGovernor.recordBlock(juce::Time::getHighResolutionTicks() - renderStartTicks, audioBuffer.getNumSamples());
+        //DBG("Audio buffer after Serum: " << audioBuffer.getMagnitude(0, audioBuffer.getNumSamples()));
+
+        // Never sleep in the middle of a hot-swap crossfade or an A/B ramp
+        const float auditionTarget = auditionActive.load() ? 1.0f : 0.0f;
+        const bool transitionRunning = fadingInstance != nullptr || (audition != nullptr && auditionGain != auditionTarget);
+        silenceGate.analyse(audioBuffer, !transitionRunning);
+        outputMeter.push(audioBuffer);
         if (!midiMessages.isEmpty())
             DBG("MIDI forwarded to Serum!");
     }
@@ -199,15 +339,428 @@ void SerumInterfaceComponent::processMidiAndAudio(juce::AudioBuffer<float>& audi
     }
 }
 
+void SerumInterfaceComponent::renderPrimary(HostedInstanceSlot::ReadScope& readScope, juce::AudioPluginInstance& instance,
+    juce::AudioBuffer<float>& audioBuffer, juce::MidiBuffer& midiMessages)
+{
+    if (auto* outgoing = readScope.getOutgoing())
+    {
+        if (outgoing != fadingInstance)
+        {
+            fadingInstance = outgoing;
+            crossfadePosition = 0;
+        }
+        renderCrossfade(instance, *outgoing, readScope, audioBuffer, midiMessages);
+    }
+    else
+    {
+        fadingInstance = nullptr;
+        instance.processBlock(audioBuffer, midiMessages);
+    }
+}
+
+void SerumInterfaceComponent::renderAB(HostedInstanceSlot::ReadScope& readScope, juce::AudioPluginInstance& primary,
+    juce::AudioPluginInstance& audition, juce::AudioBuffer<float>& audioBuffer, juce::MidiBuffer& midiMessages)
+{
+    const int numSamples = audioBuffer.getNumSamples();
+    const int numChannels = audioBuffer.getNumChannels();
+    if (numChannels > auditionBuffer.getNumChannels() || numSamples > auditionBuffer.getNumSamples())
+    {
+        renderPrimary(readScope, primary, audioBuffer, midiMessages);
+        return;
+    }
+
+    // Ramp the audition gain towards its target at a fixed per-sample slope, so a
+    // toggle always produces the same crossfade regardless of block size.
+    const float target = auditionActive.load() ? 1.0f : 0.0f;
+    const float startGain = auditionGain;
+    const float slope = 1.0f / (float)juce::jmax(1, abCrossfadeSamples);
+    const int rampSamples = juce::jmin(numSamples, (int)std::ceil(std::abs(target - startGain) / slope));
+    const float endGain = rampSamples > 0
+        ? (target > startGain ? juce::jmin(target, startGain + slope * rampSamples) : juce::jmax(target, startGain - slope * rampSamples))
+        : target;
+
+    const bool suspend = suspendInactiveInstance.load();
+    const bool renderPrimaryInstance = !(suspend && startGain >= 1.0f && endGain >= 1.0f);
+    const bool renderAuditionInstance = !(suspend && startGain <= 0.0f && endGain <= 0.0f);
+
+    // Both instances see the same MIDI; a resumed instance first gets all-notes-off
+    // so notes released while it was suspended do not hang.
+    juce::AudioBuffer<float> auditionView(auditionBuffer.getArrayOfWritePointers(), numChannels, numSamples);
+    if (renderAuditionInstance)
+    {
+        auditionView.clear();
+        auditionMidi.clear();
+        if (auditionSuspended)
+            addAllNotesOff(auditionMidi);
+        auditionMidi.addEvents(midiMessages, 0, numSamples, 0);
+        audition.processBlock(auditionView, auditionMidi);
+    }
+    auditionSuspended = !renderAuditionInstance;
+
+    if (renderPrimaryInstance)
+    {
+        renderPrimaryResuming(readScope, primary, audioBuffer, midiMessages);
+    }
+    else
+    {
+        audioBuffer.clear();
+        primarySuspended = true;
+    }
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        audioBuffer.applyGainRamp(channel, 0, rampSamples, 1.0f - startGain, 1.0f - endGain);
+        audioBuffer.applyGain(channel, rampSamples, numSamples - rampSamples, 1.0f - endGain);
+        if (renderAuditionInstance)
+        {
+            audioBuffer.addFromWithRamp(channel, 0, auditionView.getReadPointer(channel), rampSamples, startGain, endGain);
+            audioBuffer.addFrom(channel, rampSamples, auditionView, channel, rampSamples, numSamples - rampSamples, endGain);
+        }
+    }
+    auditionGain = endGain;
+}
+
+void SerumInterfaceComponent::renderPrimaryResuming(HostedInstanceSlot::ReadScope& readScope, juce::AudioPluginInstance& primary,
+    juce::AudioBuffer<float>& audioBuffer, juce::MidiBuffer& midiMessages)
+{
+    if (!primarySuspended)
+    {
+        renderPrimary(readScope, primary, audioBuffer, midiMessages);
+        return;
+    }
+
+    resumeMidi.clear();
+    addAllNotesOff(resumeMidi);
+    resumeMidi.addEvents(midiMessages, 0, audioBuffer.getNumSamples(), 0);
+    renderPrimary(readScope, primary, audioBuffer, resumeMidi);
+    primarySuspended = false;
+}
+
+void SerumInterfaceComponent::addAllNotesOff(juce::MidiBuffer& buffer)
+{
+    for (int midiChannel = 1; midiChannel <= 16; ++midiChannel)
+        buffer.addEvent(juce::MidiMessage::allNotesOff(midiChannel), 0);
+}
+
+void SerumInterfaceComponent::renderCrossfade(juce::AudioPluginInstance& incoming, juce::AudioPluginInstance& outgoing,
+    HostedInstanceSlot::ReadScope& readScope, juce::AudioBuffer<float>& audioBuffer, juce::MidiBuffer& midiMessages)
+{
+    const int numSamples = audioBuffer.getNumSamples();
+    const int numChannels = audioBuffer.getNumChannels();
+    if (numChannels > crossfadeBuffer.getNumChannels() || numSamples > crossfadeBuffer.getNumSamples())
+    {
+        // Host exceeded the prepared block size; cut over rather than allocate here
+        readScope.finishCrossfade();
+        fadingInstance = nullptr;
+        incoming.processBlock(audioBuffer, midiMessages);
+        return;
+    }
+
+    // Non-owning view over the preallocated scratch channels
+    juce::AudioBuffer<float> outgoingBuffer(crossfadeBuffer.getArrayOfWritePointers(), numChannels, numSamples);
+    for (int channel = 0; channel < numChannels; ++channel)
+        outgoingBuffer.copyFrom(channel, 0, audioBuffer, channel, 0, numSamples);
+    crossfadeMidi.clear();
+    crossfadeMidi.addEvents(midiMessages, 0, numSamples, 0);
+
+    outgoing.processBlock(outgoingBuffer, crossfadeMidi);
+    incoming.processBlock(audioBuffer, midiMessages);
+
+    const int length = juce::jmax(1, readScope.getCrossfadeLength());
+    const int fadeSamples = juce::jlimit(0, numSamples, length - crossfadePosition);
+    const float startGain = (float)crossfadePosition / (float)length;
+    const float endGain = (float)(crossfadePosition + fadeSamples) / (float)length;
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        audioBuffer.applyGainRamp(channel, 0, fadeSamples, startGain, endGain);
+        audioBuffer.addFromWithRamp(channel, 0, outgoingBuffer.getReadPointer(channel), fadeSamples, 1.0f - startGain, 1.0f - endGain);
+    }
+
+    crossfadePosition += fadeSamples;
+    if (crossfadePosition >= length)
+    {
+        readScope.finishCrossfade();
+        fadingInstance = nullptr;
+    }
+}
+
+bool SerumInterfaceComponent::setABModeEnabled(bool shouldBeEnabled)
+{
+    if (!shouldBeEnabled)
+    {
+        // B ramps back to A like any other toggle; the instance goes once it is silent
+        auditionActive = false;
+        if (getAuditionInstance() != nullptr)
+            auditionReleasePending = true;
+        abModeEnabled = false;
+        updateABButtons();
+        if (auditionReleasePending.load())
+            releaseAuditionWhenFadedOut(auditionReleaseMaxPolls);
+        return true;
+    }
+
+    auto* primary = getSerumInstance();
+    if (primary == nullptr)
+    {
+        DBG("Cannot enable A/B mode without a loaded Serum instance.");
+        return false;
+    }
+
+    if (getAuditionInstance() == nullptr)
+    {
+        auto instance = createSiblingInstance();
+        if (instance == nullptr)
+        {
+            DBG("Failed to create A/B audition instance");
+            return false;
+        }
+        auditionSlot.publish(std::move(instance));
+    }
+
+    auditionActive = false;
+    abModeEnabled = true;
+    auditionReleasePending = false;
+    updateABButtons();
+    DBG("A/B mode enabled");
+    return true;
+}
+
+void SerumInterfaceComponent::releaseAuditionWhenFadedOut(int pollsLeft)
+{
+    juce::Timer::callAfterDelay(auditionReleasePollMs, [safeThis = juce::Component::SafePointer<SerumInterfaceComponent>(this), pollsLeft]()
+        {
+            // Re-enabled meanwhile: the instance is still in use
+            if (safeThis == nullptr || !safeThis->auditionReleasePending.load() || safeThis->abModeEnabled.load())
+                return;
+            if (!safeThis->auditionFadedOut.load() && pollsLeft > 0)
+            {
+                safeThis->releaseAuditionWhenFadedOut(pollsLeft - 1);
+                return;
+            }
+            safeThis->auditionReleasePending = false;
+            safeThis->auditionSlot.clear(); // parked in the standby pool for the next A/B session
+        });
+}
+
+int SerumInterfaceComponent::addLayer()
+{
+    auto instance = createSiblingInstance();
+    if (instance == nullptr)
+    {
+        DBG("Failed to create layer instance");
+        return -1;
+    }
+    return layerGraph.addLayer(std::move(instance));
+}
+
+std::unique_ptr<juce::AudioPluginInstance> SerumInterfaceComponent::createSiblingInstance()
+{
+    // A prepared copy of the primary instance: same plugin, same parameter values
+    auto* primary = getSerumInstance();
+    if (primary == nullptr)
+        return nullptr;
+
+    const auto description = primary->getPluginDescription();
+    const double sampleRate = parentProcessor.getSampleRate();
+    const int blockSize = parentProcessor.getBlockSize();
+
+    auto instance = takeFromStandbyPool(description.fileOrIdentifier);
+    if (instance == nullptr)
+    {
+        juce::String errorMessage;
+        instance = formatManager.createPluginInstance(description, sampleRate, blockSize, errorMessage);
+        if (instance == nullptr)
+        {
+            DBG("Error creating sibling instance: " << errorMessage);
+            return nullptr;
+        }
+    }
+    if (sampleRate > 0.0 && blockSize > 0)
+        instance->prepareToPlay(sampleRate, blockSize);
+    copyCompatibleParameters(*primary, *instance);
+    return instance;
+}
+
+void SerumInterfaceComponent::setAuditionActive(bool shouldHearB)
+{
+    auditionActive = shouldHearB && isABModeEnabled();
+    updateABButtons();
+}
+
 void SerumInterfaceComponent::loadSerum(const juce::File& pluginPath)
 {
-    if (serumInstance != nullptr)
+    juce::PluginDescription pluginDescription;
+    if (!findSerumDescription(pluginPath, pluginDescription))
+        return;
+
+    double sampleRate = parentProcessor.getSampleRate();
+    int blockSize = parentProcessor.getBlockSize();
+    std::unique_ptr<juce::AudioPluginInstance> instance = takeFromStandbyPool(pluginDescription.fileOrIdentifier);
+    if (instance == nullptr)
     {
-        serumEditor.reset();
-        serumInstance.reset();
-        DBG("Unloaded previous plugin instance.");
+        juce::String errorMessage;
+        instance = formatManager.createPluginInstance(pluginDescription, sampleRate, blockSize, errorMessage);
+        if (instance == nullptr)
+        {
+            DBG("Error loading plugin: " << errorMessage);
+            return;
+        }
     }
     
+    DBG("Plugin loaded successfully: " << instance->getName());
+    DBG("Plugin loaded successfully!");
+
+    // Through the slot like a hot-swap: whatever was loaded keeps playing until the
+    // new instance is published, so a failed load never leaves the track silent
+    completeHotSwap(std::move(instance));
+    DBG("Serum instance initialized!");
+}
+
+void SerumInterfaceComponent::hotSwapSerum(const juce::File& pluginPath)
+{
+    // The generation counter, the standby pool and the slot are message-thread state,
+    // and hosts may call prepareToPlay from elsewhere
+    if (!juce::MessageManager::getInstance()->isThisTheMessageThread())
+    {
+        juce::Component::SafePointer<SerumInterfaceComponent> safeThis(this);
+        juce::MessageManager::callAsync([safeThis, pluginPath]() {
+            if (safeThis != nullptr)
+                safeThis->hotSwapSerum(pluginPath);
+            });
+        return;
+    }
+
+    // Hosts often prepare several times while the first load is still running
+    if (pluginPath == pendingSwapPath)
+        return;
+
+    juce::PluginDescription pluginDescription;
+    if (!findSerumDescription(pluginPath, pluginDescription))
+        return;
+
+    // Any load still in flight is now stale and will go to the standby pool
+    const int generation = ++hotSwapGeneration;
+    pendingSwapPath = juce::File();
+
+    if (auto pooled = takeFromStandbyPool(pluginDescription.fileOrIdentifier))
+    {
+        DBG("Hot-swapping to standby instance: " << pooled->getName());
+        completeHotSwap(std::move(pooled));
+        return;
+    }
+
+    // The async variant keeps the current instance playing while the new one is
+    // created, but it only moves the work off the caller's stack: VST3 (like every
+    // format that needs the message thread) is constructed on the message thread,
+    // and completeHotSwap prepares it there too, so the UI stalls for both. Audio
+    // keeps running on the old instance meanwhile.
+    juce::Component::SafePointer<SerumInterfaceComponent> safeThis(this);
+    pendingSwapPath = pluginPath;
+    formatManager.createPluginInstanceAsync(pluginDescription,
+        parentProcessor.getSampleRate(),
+        parentProcessor.getBlockSize(),
+        [safeThis, generation](std::unique_ptr<juce::AudioPluginInstance> instance, const juce::String& errorMessage)
+        {
+            if (safeThis == nullptr)
+                return;
+            if (generation == safeThis->hotSwapGeneration)
+                safeThis->pendingSwapPath = juce::File();
+            if (instance == nullptr)
+            {
+                DBG("Hot-swap failed to load plugin: " << errorMessage);
+                return;
+            }
+            if (generation != safeThis->hotSwapGeneration)
+            {
+                DBG("Hot-swap superseded, parking " << instance->getName() << " in standby pool");
+                safeThis->addToStandbyPool(std::move(instance));
+                return;
+            }
+            safeThis->completeHotSwap(std::move(instance));
+        });
+}
+
+void SerumInterfaceComponent::completeHotSwap(std::unique_ptr<juce::AudioPluginInstance> instance)
+{
+    // Message thread. Prepared before publishing so the audio thread never sees an unprepared instance
+    const double sampleRate = parentProcessor.getSampleRate();
+    const int blockSize = parentProcessor.getBlockSize();
+    if (sampleRate > 0.0 && blockSize > 0)
+        instance->prepareToPlay(sampleRate, blockSize);
+
+    auto* previous = getSerumInstance();
+    if (previous != nullptr)
+        copyCompatibleParameters(*previous, *instance);
+
+    const int crossfadeSamples = (previous != nullptr && sampleRate > 0.0)
+        ? juce::roundToInt(sampleRate * hotSwapCrossfadeSeconds)
+        : 0;
+
+    // The audition instance belongs to the old build; A/B restarts against the new one
+    if (isABModeEnabled())
+        setABModeEnabled(false);
+
+    serumEditor.reset();
+    instanceSlot.publish(std::move(instance), crossfadeSamples);
+    DBG("Hot-swap published, crossfading over " << crossfadeSamples << " samples");
+
+    resized();
+    repaint();
+    if (onInstanceSwapped)
+        onInstanceSwapped();
+}
+
+void SerumInterfaceComponent::copyCompatibleParameters(juce::AudioPluginInstance& source, juce::AudioPluginInstance& destination)
+{
+    std::map<juce::String, float> sourceValues;
+    for (auto* param : source.getParameters())
+        if (param != nullptr)
+            sourceValues[param->getName(128)] = param->getValue();
+
+    int copied = 0;
+    for (auto* param : destination.getParameters())
+    {
+        if (param == nullptr)
+            continue;
+        auto it = sourceValues.find(param->getName(128));
+        if (it != sourceValues.end())
+        {
+            param->setValue(it->second);
+            ++copied;
+        }
+    }
+    DBG("Copied " << copied << " compatible parameters to new instance");
+}
+
+void SerumInterfaceComponent::addToStandbyPool(std::unique_ptr<juce::AudioPluginInstance> instance)
+{
+    if (instance == nullptr)
+        return;
+
+    instance->releaseResources();
+    standbyPool.push_back(std::move(instance));
+    while (standbyPool.size() > maxStandbyInstances)
+        standbyPool.erase(standbyPool.begin());
+    DBG("Standby pool size: " << (int)standbyPool.size());
+}
+
+std::unique_ptr<juce::AudioPluginInstance> SerumInterfaceComponent::takeFromStandbyPool(const juce::String& fileOrIdentifier)
+{
+    for (auto it = standbyPool.begin(); it != standbyPool.end(); ++it)
+    {
+        if ((*it)->getPluginDescription().fileOrIdentifier == fileOrIdentifier)
+        {
+            auto instance = std::move(*it);
+            standbyPool.erase(it);
+            instance->reset();
+            return instance;
+        }
+    }
+    return nullptr;
+}
+
+bool SerumInterfaceComponent::findSerumDescription(const juce::File& pluginPath, juce::PluginDescription& pluginDescription)
+{
     juce::File actualPluginPath = pluginPath;
     
     // If the specified path doesn't exist, try fallback paths for Serum 2
@@ -236,7 +789,7 @@ void SerumInterfaceComponent::loadSerum(const juce::File& pluginPath)
         if (!foundValidPath)
         {
             DBG("No valid Serum plugin paths found");
-            return;
+            return false;
         }
     }
     if (actualPluginPath.isDirectory())
@@ -250,28 +803,22 @@ void SerumInterfaceComponent::loadSerum(const juce::File& pluginPath)
     else
     {
         DBG("Plugin path is neither a valid file nor directory: " << actualPluginPath.getFullPathName());
-        return;
+        return false;
     }
     juce::AudioProcessor::BusesLayout layout;
     if (!isBusesLayoutSupported(layout))
     {
         DBG("Unsupported bus layout");
-        return;
+        return false;
     }
     DBG("Bus layout is supported, proceeding to load plugin.");
-    double sampleRate = parentProcessor.getSampleRate();
-    int blockSize = parentProcessor.getBlockSize();
-    DBG("Sample Rate: " << sampleRate);
-    DBG("Block Size: " << blockSize);
     auto* format = formatManager.getFormat(0);
     if (format == nullptr)
     {
         DBG("No plugin formats available!");
-        return;
+        return false;
     }
     juce::KnownPluginList pluginList;
-    juce::PluginDescription pluginDescription;
-    juce::String errorMessage;
     juce::OwnedArray<juce::PluginDescription> descriptions;
     if (!pluginList.scanAndAddFile(actualPluginPath.getFullPathName(),
         true,
@@ -279,12 +826,12 @@ void SerumInterfaceComponent::loadSerum(const juce::File& pluginPath)
         *format))
     {
         DBG("Failed to scan and add plugin: " << actualPluginPath.getFullPathName());
-        return;
+        return false;
     }
     if (descriptions.isEmpty())
     {
         DBG("No plugin descriptions found!");
-        return;
+        return false;
     }
     
     // Look for Serum 2 specifically
@@ -320,7 +867,7 @@ void SerumInterfaceComponent::loadSerum(const juce::File& pluginPath)
         else
         {
             DBG("No valid plugin descriptions found!");
-            return;
+            return false;
         }
     }
     if (!pluginDescription.fileOrIdentifier.isEmpty())
@@ -338,39 +885,20 @@ void SerumInterfaceComponent::loadSerum(const juce::File& pluginPath)
     {
         DBG("Plugin description is invalid.");
     }
-    std::unique_ptr<juce::AudioPluginInstance> instance;
-    instance = formatManager.createPluginInstance(pluginDescription, sampleRate, blockSize, errorMessage);
-    if (instance == nullptr)
-    {
-        DBG("Error loading plugin: " << errorMessage);
-        return;
-    }
-    
-    DBG("Plugin loaded successfully: " << instance->getName());
-    DBG("Plugin loaded successfully!");
-    
-    // Use the critical section for thread safety
-    {
-        const juce::ScopedLock lock(criticalSection);
-        serumInstance = std::move(instance);
-        DBG("Serum instance initialized!");
-        
-        // Don't create editor here - let it be created when needed in resized() or paint()
-        DBG("Plugin loaded successfully, editor will be created when component is displayed");
-    }
+    return true;
 }
 
 void SerumInterfaceComponent::resized()
 {
-    const juce::ScopedLock lock(criticalSection);
     auto bounds = getLocalBounds();
     
     // Create editor if we have a serum instance but no editor yet
-    if (serumInstance != nullptr && serumEditor == nullptr && juce::MessageManager::getInstance()->isThisTheMessageThread())
+    auto* instance = getSerumInstance();
+    if (instance != nullptr && serumEditor == nullptr && juce::MessageManager::getInstance()->isThisTheMessageThread())
     {
         try
         {
-            serumEditor.reset(serumInstance->createEditorIfNeeded());
+            serumEditor.reset(instance->createEditorIfNeeded());
             if (serumEditor != nullptr)
             {
                 DBG("Editor created successfully in resized()!");
@@ -404,6 +932,16 @@ void SerumInterfaceComponent::resized()
     prevButton.setBounds(controlsX, controlsY, buttonWidth, buttonHeight);
     responseCounter.setBounds(controlsX + buttonWidth + spacing, controlsY, counterWidth, buttonHeight);
     nextButton.setBounds(controlsX + buttonWidth + counterWidth + spacing * 2, controlsY, buttonWidth, buttonHeight);
+    abModeButton.setBounds(controlsX - buttonWidth - spacing, controlsY, buttonWidth, buttonHeight);
+    abSwitchButton.setBounds(nextButton.getRight() + spacing, controlsY, buttonWidth, buttonHeight);
+    stackButton.setBounds(abModeButton.getX() - buttonWidth - spacing, controlsY, buttonWidth, buttonHeight);
+    layersButton.setBounds(abSwitchButton.getRight() + spacing, controlsY, buttonWidth, buttonHeight);
+    switchModeButton.setBounds(stackButton.getX() - buttonWidth - spacing, controlsY, buttonWidth, buttonHeight);
+    morphButton.setBounds(layersButton.getRight() + spacing, controlsY, buttonWidth, buttonHeight);
+
+    // The meter sits above the controls and must stay in front of the Serum editor
+    outputMeter.setBounds(bounds.getWidth() - 200 - margin, controlsY - 80 - spacing, 200, 80);
+    outputMeter.toFront(false);
 }
 
 void SerumInterfaceComponent::updateResponseCounter()
@@ -434,6 +972,137 @@ void SerumInterfaceComponent::updateResponseCounter()
     }
 }
 
+void SerumInterfaceComponent::showLayerMenu()
+{
+    // One submenu per stacked layer: where it sits on the keyboard, which channel it listens to, how loud it is
+    juce::PopupMenu menu;
+    for (int layer = 0; layer < LayerGraph::maxLayers; ++layer)
+    {
+        if (layerGraph.getLayerInstance(layer) == nullptr)
+            continue;
+
+        const auto keys = layerGraph.getKeyRange(layer);
+        juce::PopupMenu keyMenu;
+        keyMenu.addItem("Whole keyboard", true, keys == juce::Range<int>(0, 127),
+            [this, layer] { layerGraph.setKeyRange(layer, 0, 127); });
+        keyMenu.addItem("Below C3", true, keys == juce::Range<int>(0, splitNote - 1),
+            [this, layer] { layerGraph.setKeyRange(layer, 0, splitNote - 1); });
+        keyMenu.addItem("C3 and above", true, keys == juce::Range<int>(splitNote, 127),
+            [this, layer] { layerGraph.setKeyRange(layer, splitNote, 127); });
+
+        const int channel = layerGraph.getMidiChannel(layer);
+        juce::PopupMenu channelMenu;
+        channelMenu.addItem("Omni", true, channel == 0, [this, layer] { layerGraph.setMidiChannel(layer, 0); });
+        for (int c = 1; c <= 16; ++c)
+            channelMenu.addItem("Channel " + juce::String(c), true, channel == c, [this, layer, c] { layerGraph.setMidiChannel(layer, c); });
+
+        const float gain = layerGraph.getGain(layer);
+        juce::PopupMenu gainMenu;
+        for (const float option : { 1.0f, 0.75f, 0.5f, 0.25f })
+            gainMenu.addItem(juce::String(juce::roundToInt(option * 100.0f)) + "%", true, std::abs(gain - option) < 0.001f,
+                [this, layer, option] { layerGraph.setGain(layer, option); });
+
+        juce::PopupMenu layerMenu;
+        layerMenu.addSubMenu("Keys", keyMenu);
+        layerMenu.addSubMenu("MIDI", channelMenu);
+        layerMenu.addSubMenu("Level", gainMenu);
+        layerMenu.addSeparator();
+        layerMenu.addItem("Remove", [this, layer] { layerGraph.removeLayer(layer); });
+        menu.addSubMenu("Layer " + juce::String(layer + 1), layerMenu);
+    }
+
+    if (menu.getNumItems() == 0)
+    {
+        menu.addItem("Nothing stacked yet", false, false, nullptr);
+    }
+    else
+    {
+        menu.addSeparator();
+        menu.addItem("Remove all", [this] {
+            if (auto* proc = dynamic_cast<SummonerXSerum2AudioProcessor*>(&parentProcessor))
+                proc->clearLayers();
+            });
+    }
+    menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(&layersButton));
+}
+
+void SerumInterfaceComponent::updateABButtons()
+{
+    const bool enabled = isABModeEnabled();
+    abModeButton.setButtonText(enabled ? "A/B On" : "A/B Off");
+    abSwitchButton.setButtonText(isAuditionActive() ? "Hear A" : "Hear B");
+    abSwitchButton.setVisible(enabled);
+}
+
+bool SerumInterfaceComponent::isInterestedInFileDrag(const juce::StringArray& files)
+{
+    for (const auto& file : files)
+        if (juce::File(file).hasFileExtension("wav;flac;aif;aiff"))
+            return true;
+    return false;
+}
+
+void SerumInterfaceComponent::filesDropped(const juce::StringArray& files, int, int)
+{
+    auto* proc = dynamic_cast<SummonerXSerum2AudioProcessor*>(&parentProcessor);
+    if (proc == nullptr)
+        return;
+
+    for (const auto& path : files)
+    {
+        juce::File file(path);
+        if (!file.hasFileExtension("wav;flac;aif;aiff"))
+            continue;
+
+        juce::Component::SafePointer<SerumInterfaceComponent> safeThis(this);
+        const bool started = proc->matchReference(file, [safeThis](int generation, int numGenerations) {
+            if (safeThis == nullptr)
+                return;
+            if (generation < numGenerations)
+                safeThis->responseCounter.setText("Match " + juce::String(generation) + "/" + juce::String(numGenerations), juce::dontSendNotification);
+            else
+                safeThis->updateResponseCounter();
+            });
+
+        if (started)
+            responseCounter.setText("Match 0", juce::dontSendNotification);
+        else
+            juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::WarningIcon, "Sound Match",
+                "Could not start matching " + file.getFileName() + ". Check that Serum is loaded and the file is valid audio.");
+        return;
+    }
+}
+
+void SerumInterfaceComponent::updateSwitchModeButton()
+{
+    if (auto* proc = dynamic_cast<SummonerXSerum2AudioProcessor*>(&parentProcessor))
+        switchModeButton.setButtonText("On " + PresetSwitchScheduler::getModeName(proc->getSwitchMode()));
+}
+
+void SerumInterfaceComponent::applyParameterChanges(bool toAudition, const std::vector<PresetSwitchScheduler::ParameterChange>& changes) noexcept
+{
+    HostedInstanceSlot::ReadScope readScope(toAudition ? auditionSlot : instanceSlot);
+    if (auto* instance = readScope.get())
+    {
+        const auto& parameters = instance->getParameters();
+        for (const auto& change : changes)
+            if (auto* param = parameters[change.parameterIndex])
+                param->setValue(change.value);
+    }
+}
+
+void SerumInterfaceComponent::applyParameterValues(const int* parameterIndices, const float* values, int numValues) noexcept
+{
+    HostedInstanceSlot::ReadScope readScope(instanceSlot);
+    if (auto* instance = readScope.get())
+    {
+        const auto& parameters = instance->getParameters();
+        for (int i = 0; i < numValues; ++i)
+            if (auto* param = parameters[parameterIndices[i]])
+                param->setValue(values[i]);
+    }
+}
+
 bool SerumInterfaceComponent::isBusesLayoutSupported(const juce::AudioProcessor::BusesLayout& layouts) const
 {
     const auto& mainOutput = layouts.getMainOutputChannelSet();
@@ -1,8 +1,14 @@
 #pragma once
 #include <JuceHeader.h>
 #include <juce_audio_processors/juce_audio_processors.h>
+#include "HostedInstanceSlot.h"
+#include "LayerGraph.h"
+#include "SilenceGate.h"
+#include "CpuBudgetGovernor.h"
+#include "PresetSwitchScheduler.h"
+#include "OutputMeter.h"
 
-class SerumInterfaceComponent : public juce::Component
+class SerumInterfaceComponent : public juce::Component, public juce::FileDragAndDropTarget
 {
 public:
     SerumInterfaceComponent(juce::AudioProcessor& processor);
@@ -11,22 +17,114 @@ public:
     void setPluginInstance(juce::AudioPluginInstance* newPlugin);
     void paint(juce::Graphics&) override;
     void resized() override;
+    // Both replace the current instance through the slot, crossfading from it if there
+    // is one. loadSerum creates the new one synchronously on the message thread;
+    // hotSwapSerum may be called from any thread and creates it asynchronously, though
+    // VST3 construction and prepareToPlay still happen on the message thread.
     void loadSerum(const juce::File& pluginPath);
+    void hotSwapSerum(const juce::File& pluginPath);
     void processMidiAndAudio(juce::AudioBuffer<float>& audioBuffer, juce::MidiBuffer& midiMessages, double sampleRate);
-    juce::AudioPluginInstance* getSerumInstance() const { return serumInstance.get(); }
-    std::unique_ptr<juce::AudioPluginInstance> serumInstance;
+    juce::AudioPluginInstance* getSerumInstance() const { return instanceSlot.get(); }
     void prepareToPlay(double sampleRate, int samplesPerBlock);
     void updateResponseCounter();
 
+    // Dropping a WAV/FLAC/AIFF starts a local search for a matching sound
+    bool isInterestedInFileDrag(const juce::StringArray& files) override;
+    void filesDropped(const juce::StringArray& files, int x, int y) override;
+
+    // A/B auditioning: a second warm instance receives the same MIDI and the
+    // output crossfades between the two when toggled.
+    bool setABModeEnabled(bool shouldBeEnabled);
+    bool isABModeEnabled() const { return abModeEnabled.load(); }
+    void setAuditionActive(bool shouldHearB);
+    bool isAuditionActive() const { return auditionActive.load(); }
+    void setSuspendInactiveInstance(bool shouldSuspend) { suspendInactiveInstance = shouldSuspend; }
+    juce::AudioPluginInstance* getAuditionInstance() const { return auditionSlot.get(); }
+
+    // Layering: extra instances stacked on the primary, rendered in parallel
+    int addLayer();
+    LayerGraph& getLayerGraph() { return layerGraph; }
+
+    // Stops calling the hosted instances while idle; wakes on any MIDI
+    SilenceGate& getSilenceGate() { return silenceGate; }
+
+    // Lowers unison voice counts while the hosted render overruns its budget
+    CpuBudgetGovernor& getCpuGovernor() { return cpuGovernor; }
+    std::function<void()> onInstanceSwapped;
+
+    // Audio thread: applies a staged preset switch between two renders
+    void applyParameterChanges(bool toAudition, const std::vector<PresetSwitchScheduler::ParameterChange>& changes) noexcept;
+    // Audio thread: pushes morphed values to the primary instance
+    void applyParameterValues(const int* parameterIndices, const float* values, int numValues) noexcept;
+
 private:
     juce::AudioPluginFormatManager formatManager;
     std::unique_ptr<juce::AudioProcessorEditor> serumEditor;
     juce::AudioProcessor& parentProcessor;
     bool isBusesLayoutSupported(const juce::AudioProcessor::BusesLayout& layouts) const;
-    juce::CriticalSection criticalSection;
+    HostedInstanceSlot instanceSlot;
+
+    // Hot-swap: replacement instances are loaded off the audio path and faded in
+    static constexpr double hotSwapCrossfadeSeconds = 0.05;
+    static constexpr size_t maxStandbyInstances = 2;
+    bool findSerumDescription(const juce::File& pluginPath, juce::PluginDescription& description);
+    void completeHotSwap(std::unique_ptr<juce::AudioPluginInstance> instance);
+    void copyCompatibleParameters(juce::AudioPluginInstance& source, juce::AudioPluginInstance& destination);
+    void addToStandbyPool(std::unique_ptr<juce::AudioPluginInstance> instance);
+    std::unique_ptr<juce::AudioPluginInstance> takeFromStandbyPool(const juce::String& fileOrIdentifier);
+    std::unique_ptr<juce::AudioPluginInstance> createSiblingInstance();
+    void renderCrossfade(juce::AudioPluginInstance& incoming, juce::AudioPluginInstance& outgoing,
+        HostedInstanceSlot::ReadScope& readScope, juce::AudioBuffer<float>& audioBuffer, juce::MidiBuffer& midiMessages);
+    std::vector<std::unique_ptr<juce::AudioPluginInstance>> standbyPool; // prepared-once instances, message thread only
+    int hotSwapGeneration = 0;
+    juce::File pendingSwapPath;   // the plugin the current async load is creating; message thread only
+    juce::AudioBuffer<float> crossfadeBuffer;   // audio thread only
+    juce::MidiBuffer crossfadeMidi;             // audio thread only
+    juce::AudioPluginInstance* fadingInstance = nullptr;
+    int crossfadePosition = 0;
+
+    static constexpr double abCrossfadeSeconds = 0.02;
+    HostedInstanceSlot auditionSlot;
+    std::atomic<bool> abModeEnabled{ false };
+    std::atomic<bool> auditionActive{ false };
+    std::atomic<bool> suspendInactiveInstance{ true };
+    std::atomic<bool> auditionReleasePending{ false };   // A/B is off but B is still ramping out
+    std::atomic<bool> auditionFadedOut{ true };          // set by the audio thread once B is silent
+    void releaseAuditionWhenFadedOut(int pollsLeft);
+    static constexpr int auditionReleasePollMs = 10;
+    static constexpr int auditionReleaseMaxPolls = 50;   // gives up waiting when no audio is running
+    void renderPrimary(HostedInstanceSlot::ReadScope& readScope, juce::AudioPluginInstance& instance,
+        juce::AudioBuffer<float>& audioBuffer, juce::MidiBuffer& midiMessages);
+    void renderPrimaryResuming(HostedInstanceSlot::ReadScope& readScope, juce::AudioPluginInstance& primary,
+        juce::AudioBuffer<float>& audioBuffer, juce::MidiBuffer& midiMessages);
+    void renderAB(HostedInstanceSlot::ReadScope& readScope, juce::AudioPluginInstance& primary,
+        juce::AudioPluginInstance& audition, juce::AudioBuffer<float>& audioBuffer, juce::MidiBuffer& midiMessages);
+    static void addAllNotesOff(juce::MidiBuffer& buffer);
+    juce::AudioBuffer<float> auditionBuffer;    // audio thread only
+    juce::MidiBuffer auditionMidi;              // audio thread only
+    juce::MidiBuffer resumeMidi;                // audio thread only
+    int abCrossfadeSamples = 882;
+    float auditionGain = 0.0f;                  // 0 = A, 1 = B
+    bool primarySuspended = false;
+    bool auditionSuspended = true;
+
+    LayerGraph layerGraph;
+    SilenceGate silenceGate;
+    CpuBudgetGovernor cpuGovernor;
+    OutputMeter outputMeter;
     juce::TextButton nextButton{ "Next" };
     juce::TextButton prevButton{ "Previous" };
     juce::Label responseCounter;
+    juce::TextButton abModeButton{ "A/B Off" };
+    juce::TextButton abSwitchButton{ "Hear B" };
+    juce::TextButton stackButton{ "Stack" };
+    juce::TextButton layersButton{ "Layers" };
+    juce::TextButton switchModeButton{ "On Now" };
+    juce::TextButton morphButton{ "Morph" };
+    void updateABButtons();
+    void updateSwitchModeButton();
+    void showLayerMenu();
+    static constexpr int splitNote = 60;   // C3 in Serum's octave numbering; key splits fall either side of it
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SerumInterfaceComponent)
 };
\ No newline at end of file
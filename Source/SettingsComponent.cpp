@@ -1,4 +1,5 @@
 #include "SettingsComponent.h"
+#include "PluginProcessor.h"
 
 class SettingsButtonLookAndFeel : public juce::LookAndFeel_V4
 {
@@ -27,6 +28,7 @@ public:
 };
 
 SettingsComponent::SettingsComponent(SummonerXSerum2AudioProcessor& processor)
+    : processor(processor)
 {
     static SettingsButtonLookAndFeel customSettingsButtons;
     juce::PropertiesFile::Options options;
@@ -104,6 +106,67 @@ SettingsComponent::SettingsComponent(SummonerXSerum2AudioProcessor& processor)
     };
     addAndMakeVisible(purchaseCreditsButton);
 
+    // Performance section
+    performanceLabel.setText("Performance:", juce::dontSendNotification);
+    performanceLabel.setColour(juce::Label::textColourId, juce::Colours::indianred);
+    performanceLabel.setFont(juce::Font("Press Start 2P", 12.0f, juce::Font::italic));
+    addAndMakeVisible(performanceLabel);
+    sleepInactiveToggle.setColour(juce::ToggleButton::textColourId, juce::Colours::white);
+    sleepInactiveToggle.setColour(juce::ToggleButton::tickColourId, juce::Colours::darkgoldenrod);
+    sleepInactiveToggle.setToggleState(applicationProperties.getUserSettings()->getBoolValue("sleepInactiveInstance", true), juce::dontSendNotification);
+    sleepInactiveToggle.onClick = [this]() {
+        applicationProperties.getUserSettings()->setValue("sleepInactiveInstance", sleepInactiveToggle.getToggleState());
+        applicationProperties.getUserSettings()->saveIfNeeded();
+        applyPerformanceSettings();
+        };
+    addAndMakeVisible(sleepInactiveToggle);
+    spillPreviewsToggle.setColour(juce::ToggleButton::textColourId, juce::Colours::white);
+    spillPreviewsToggle.setColour(juce::ToggleButton::tickColourId, juce::Colours::darkgoldenrod);
+    spillPreviewsToggle.setToggleState(applicationProperties.getUserSettings()->getBoolValue("spillPreviews", false), juce::dontSendNotification);
+    spillPreviewsToggle.onClick = [this]() {
+        applicationProperties.getUserSettings()->setValue("spillPreviews", spillPreviewsToggle.getToggleState());
+        applicationProperties.getUserSettings()->saveIfNeeded();
+        applyPerformanceSettings();
+        };
+    addAndMakeVisible(spillPreviewsToggle);
+    silenceGateToggle.setColour(juce::ToggleButton::textColourId, juce::Colours::white);
+    silenceGateToggle.setColour(juce::ToggleButton::tickColourId, juce::Colours::darkgoldenrod);
+    silenceGateToggle.setToggleState(applicationProperties.getUserSettings()->getBoolValue("silenceGate", true), juce::dontSendNotification);
+    silenceGateToggle.onClick = [this]() {
+        applicationProperties.getUserSettings()->setValue("silenceGate", silenceGateToggle.getToggleState());
+        applicationProperties.getUserSettings()->saveIfNeeded();
+        applyPerformanceSettings();
+        };
+    addAndMakeVisible(silenceGateToggle);
+    setupPerformanceSlider(gateTailSlider, gateTailLabel, "Sleep after", "silenceGateTail", 0.5, 10.0, 0.5, 2.0, " s");
+    setupPerformanceSlider(gateThresholdSlider, gateThresholdLabel, "Silent below", "silenceGateThreshold", -120.0, -60.0, 1.0, -90.0, " dB");
+    cpuGovernorToggle.setColour(juce::ToggleButton::textColourId, juce::Colours::white);
+    cpuGovernorToggle.setColour(juce::ToggleButton::tickColourId, juce::Colours::darkgoldenrod);
+    cpuGovernorToggle.setToggleState(applicationProperties.getUserSettings()->getBoolValue("cpuGovernor", true), juce::dontSendNotification);
+    cpuGovernorToggle.onClick = [this]() {
+        applicationProperties.getUserSettings()->setValue("cpuGovernor", cpuGovernorToggle.getToggleState());
+        applicationProperties.getUserSettings()->saveIfNeeded();
+        applyPerformanceSettings();
+        };
+    addAndMakeVisible(cpuGovernorToggle);
+    setupPerformanceSlider(cpuBudgetSlider, cpuBudgetLabel, "CPU budget", "cpuBudget", 10.0, 100.0, 5.0, 70.0, " %");
+    cpuStatsLabel.setFont(juce::Font("Press Start 2P", 8.0f, juce::Font::plain));
+    cpuStatsLabel.setColour(juce::Label::textColourId, juce::Colours::grey);
+    addAndMakeVisible(cpuStatsLabel);
+    cpuLogButton.setLookAndFeel(&customSettingsButtons);
+    cpuLogButton.setButtonText("CPU Log");
+    cpuLogButton.setColour(juce::TextButton::buttonColourId, juce::Colours::white);
+    cpuLogButton.setColour(juce::TextButton::textColourOnId, juce::Colours::black);
+    cpuLogButton.setColour(juce::TextButton::textColourOffId, juce::Colours::black);
+    cpuLogButton.onClick = [this]() { showCpuLog(); };
+    addAndMakeVisible(cpuLogButton);
+    previewStatsLabel.setFont(juce::Font("Press Start 2P", 8.0f, juce::Font::plain));
+    previewStatsLabel.setColour(juce::Label::textColourId, juce::Colours::grey);
+    addAndMakeVisible(previewStatsLabel);
+    applyPerformanceSettings();
+    updatePreviewStats();
+    updateCpuStats();
+
     // Initialize mystical floating boxes effect
     floatingBoxes.reserve(40); // Reserve space for up to 40 boxes
     startTimer(50); // 50ms timer for smooth animation (20 FPS)
@@ -116,6 +179,7 @@ SettingsComponent::~SettingsComponent()
     resetButton.setLookAndFeel(nullptr);
     logoutButton.setLookAndFeel(nullptr);
     purchaseCreditsButton.setLookAndFeel(nullptr);
+    cpuLogButton.setLookAndFeel(nullptr);
 }
 
 void SettingsComponent::resetSavedPath()
@@ -248,8 +312,98 @@ void SettingsComponent::resized()
 
     // Logout button
     logoutButton.setBounds(bounds.getX(), bounds.getY(), buttonWidth, buttonHeight);
+    bounds.removeFromTop(buttonHeight + buttonSpacing * 5);
+
+    // Performance section
+    performanceLabel.setBounds(bounds.removeFromTop(20));
+    bounds.removeFromTop(buttonSpacing);
+    sleepInactiveToggle.setBounds(bounds.removeFromTop(24).withWidth(buttonWidth * 3));
+    spillPreviewsToggle.setBounds(bounds.removeFromTop(24).withWidth(buttonWidth * 3));
+    silenceGateToggle.setBounds(bounds.removeFromTop(24).withWidth(buttonWidth * 3));
+    for (auto [slider, label] : { std::pair{ &gateTailSlider, &gateTailLabel }, std::pair{ &gateThresholdSlider, &gateThresholdLabel } })
+    {
+        auto row = bounds.removeFromTop(24).withWidth(buttonWidth * 3);
+        label->setBounds(row.removeFromLeft(buttonWidth));
+        slider->setBounds(row);
+    }
+    cpuGovernorToggle.setBounds(bounds.removeFromTop(24).withWidth(buttonWidth * 3));
+    auto budgetRow = bounds.removeFromTop(24).withWidth(buttonWidth * 3);
+    cpuBudgetLabel.setBounds(budgetRow.removeFromLeft(buttonWidth));
+    cpuBudgetSlider.setBounds(budgetRow);
+    previewStatsLabel.setBounds(bounds.removeFromTop(20));
+    auto cpuRow = bounds.removeFromTop(24);
+    cpuLogButton.setBounds(cpuRow.removeFromRight(buttonWidth).reduced(0, 2));
+    cpuStatsLabel.setBounds(cpuRow);
+}
+
+void SettingsComponent::setupPerformanceSlider(juce::Slider& slider, juce::Label& label, const juce::String& text, const juce::String& key,
+                                               double minimum, double maximum, double interval, double defaultValue, const juce::String& suffix)
+{
+    label.setText(text, juce::dontSendNotification);
+    label.setColour(juce::Label::textColourId, juce::Colours::white);
+    addAndMakeVisible(label);
+
+    slider.setSliderStyle(juce::Slider::LinearHorizontal);
+    slider.setTextBoxStyle(juce::Slider::TextBoxRight, false, 70, 20);
+    slider.setColour(juce::Slider::thumbColourId, juce::Colours::darkgoldenrod);
+    slider.setRange(minimum, maximum, interval);
+    slider.setTextValueSuffix(suffix);
+    slider.setValue(applicationProperties.getUserSettings()->getDoubleValue(key, defaultValue), juce::dontSendNotification);
+    slider.onValueChange = [this, &slider, key]() {
+        applicationProperties.getUserSettings()->setValue(key, slider.getValue());
+        applyPerformanceSettings();
+        };
+    slider.onDragEnd = [this]() { applicationProperties.getUserSettings()->saveIfNeeded(); };
+    addAndMakeVisible(slider);
+}
+
+void SettingsComponent::applyPerformanceSettings()
+{
+    auto& serumInterface = processor.getSerumInterface();
+    serumInterface.setSuspendInactiveInstance(sleepInactiveToggle.getToggleState());
+
+    auto& gate = serumInterface.getSilenceGate();
+    gate.setEnabled(silenceGateToggle.getToggleState());
+    gate.setTailSeconds(gateTailSlider.getValue());
+    gate.setThresholdDecibels((float)gateThresholdSlider.getValue());
+
+    auto& governor = serumInterface.getCpuGovernor();
+    governor.setEnabled(cpuGovernorToggle.getToggleState());
+    governor.setBudget((float)(cpuBudgetSlider.getValue() / 100.0));
+
+    // Re-enabling would drop what is already on disk, so only a change is passed on
+    auto& cache = processor.getPreviewRenderer().getCache();
+    if (cache.isSpillEnabled() != spillPreviewsToggle.getToggleState())
+        cache.setSpillEnabled(spillPreviewsToggle.getToggleState());
 }
 
+void SettingsComponent::updatePreviewStats()
+{
+    const auto stats = processor.getPreviewRenderer().getCache().getStats();
+    previewStatsLabel.setText("Previews: " + juce::String(juce::roundToInt(stats.getHitRate() * 100.0)) + "% hits, "
+        + juce::String((double)stats.memoryBytes / (1024.0 * 1024.0), 1) + " MB in memory, "
+        + juce::String((double)stats.spillBytes / (1024.0 * 1024.0), 1) + " MB on disk", juce::dontSendNotification);
+}
+
+void SettingsComponent::updateCpuStats()
+{
+    const auto& governor = processor.getSerumInterface().getCpuGovernor();
+    cpuStatsLabel.setText("CPU: " + juce::String(juce::roundToInt(governor.getRecentPeakLoad() * 100.0f)) + "% of block at peak, unison cut "
+        + juce::String(governor.getLevel()) + "/" + juce::String(CpuBudgetGovernor::maxLevel), juce::dontSendNotification);
+}
+
+void SettingsComponent::showCpuLog()
+{
+    const auto& log = processor.getSerumInterface().getCpuGovernor().getInterventionLog();
+    juce::StringArray recent;
+    for (int i = juce::jmax(0, log.size() - 20); i < log.size(); ++i)
+        recent.add(log[i]);
+
+    juce::AlertWindow::showMessageBoxAsync(
+        juce::AlertWindow::InfoIcon,
+        "CPU Interventions",
+        recent.isEmpty() ? juce::String("No voices have been reduced yet.") : recent.joinIntoString("\n"));
+}
 
 void SettingsComponent::savePath(const juce::String& path)
 {
@@ -297,6 +451,16 @@ int SettingsComponent::getCredits() const
 
 void SettingsComponent::timerCallback()
 {
+    if (--statsCountdown <= 0)
+    {
+        statsCountdown = 20;   // once a second
+        if (isShowing())
+        {
+            updatePreviewStats();
+            updateCpuStats();
+        }
+    }
+
     updateFloatingBoxes();
     
     // Randomly create new boxes
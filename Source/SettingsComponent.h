@@ -69,5 +69,27 @@ private:
     juce::TextButton purchaseCreditsButton;
     int currentCredits = 0;
 
+    // Performance section: engine options saved with the other settings and pushed to the processor
+    SummonerXSerum2AudioProcessor& processor;
+    juce::Label performanceLabel;
+    juce::ToggleButton sleepInactiveToggle{ "Sleep the silent A/B side" };
+    juce::ToggleButton spillPreviewsToggle{ "Keep evicted previews on disk" };
+    juce::ToggleButton silenceGateToggle{ "Skip rendering while silent" };
+    juce::Label gateTailLabel, gateThresholdLabel;
+    juce::Slider gateTailSlider, gateThresholdSlider;
+    juce::ToggleButton cpuGovernorToggle{ "Lower unison when the CPU is busy" };
+    juce::Label cpuBudgetLabel;
+    juce::Slider cpuBudgetSlider;
+    juce::Label cpuStatsLabel;
+    juce::TextButton cpuLogButton;
+    juce::Label previewStatsLabel;
+    int statsCountdown = 0;   // timer ticks until the preview cache figures are refreshed
+    void setupPerformanceSlider(juce::Slider& slider, juce::Label& label, const juce::String& text, const juce::String& key,
+                                double minimum, double maximum, double interval, double defaultValue, const juce::String& suffix);
+    void applyPerformanceSettings();
+    void updatePreviewStats();
+    void updateCpuStats();
+    void showCpuLog();
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SettingsComponent)
 };
\ No newline at end of file
@@ -0,0 +1,92 @@
+#include "SilenceGate.h"
+
+void SilenceGate::prepare(double sampleRate)
+{
+    if (sampleRate > 0.0)
+        currentSampleRate = sampleRate;
+    heldNotes.reset();
+    sustainHeld.fill(false);
+    silentSamples = 0;
+    sleeping = false;
+    sleepingFlag = false;
+}
+
+bool SilenceGate::shouldProcess(const juce::MidiBuffer& midiMessages) noexcept
+{
+    for (const auto metadata : midiMessages)
+        trackMidi(metadata.data, metadata.numBytes);
+
+    if (!enabled.load() || !midiMessages.isEmpty())
+    {
+        silentSamples = 0;
+        sleeping = false;
+    }
+
+    sleepingFlag.store(sleeping);
+    return !sleeping;
+}
+
+void SilenceGate::analyse(const juce::AudioBuffer<float>& output, bool mayClose) noexcept
+{
+    const int numSamples = output.getNumSamples();
+    float peak = 0.0f;
+    for (int channel = 0; channel < output.getNumChannels(); ++channel)
+    {
+        auto range = juce::FloatVectorOperations::findMinAndMax(output.getReadPointer(channel), numSamples);
+        peak = juce::jmax(peak, std::abs(range.getStart()), std::abs(range.getEnd()));
+    }
+
+    if (!mayClose || peak > thresholdGain.load() || heldNotes.any() || anySustainHeld())
+    {
+        silentSamples = 0;
+        return;
+    }
+
+    silentSamples += numSamples;
+    const auto tailSamples = (juce::int64)(juce::jmax(tailSeconds.load(), pluginTailSeconds.load()) * currentSampleRate);
+    if (enabled.load() && silentSamples >= tailSamples)
+    {
+        if (!sleeping)
+            DBG("Silence gate closed");
+        sleeping = true;
+    }
+}
+
+void SilenceGate::trackMidi(const juce::uint8* data, int numBytes) noexcept
+{
+    if (numBytes < 3 || data[0] >= 0xf0)
+        return;
+
+    const int channel = data[0] & 0x0f;
+    const int type = data[0] & 0xf0;
+    const size_t noteBit = (size_t)(channel * 128 + (data[1] & 0x7f));
+
+    if (type == 0x90 && data[2] > 0)
+    {
+        heldNotes.set(noteBit);
+    }
+    else if (type == 0x80 || type == 0x90)
+    {
+        heldNotes.reset(noteBit);
+    }
+    else if (type == 0xb0)
+    {
+        if (data[1] == 64)
+        {
+            sustainHeld[(size_t)channel] = data[2] >= 64;
+        }
+        else if (data[1] == 120 || data[1] == 123)
+        {
+            for (int note = 0; note < 128; ++note)
+                heldNotes.reset((size_t)(channel * 128 + note));
+        }
+    }
+}
+
+bool SilenceGate::anySustainHeld() const noexcept
+{
+    for (auto held : sustainHeld)
+        if (held)
+            return true;
+    return false;
+}
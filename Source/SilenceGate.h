@@ -0,0 +1,58 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <cmath>
+
+// Skips hosted rendering while nothing can be heard. The gate tracks held notes
+// and the sustain pedal from the incoming MIDI and the output peak of every
+// rendered block; it only closes after the output has stayed below the threshold
+// for the whole tail time with no notes held, and any MIDI opens it again
+// before the block is rendered.
+class SilenceGate
+{
+public:
+    SilenceGate() = default;
+
+    // Message thread
+    void prepare(double sampleRate);
+    void setEnabled(bool shouldBeEnabled) { enabled = shouldBeEnabled; }
+    void setTailSeconds(double seconds) { tailSeconds = clampTail(seconds); }
+    // The hosted plugin's own reported tail; the gate waits for the longer of the two.
+    // An infinite tail (reported by some plugins) waits for maxTailSeconds.
+    void setPluginTailSeconds(double seconds) { pluginTailSeconds = clampTail(seconds); }
+    void setThresholdDecibels(float decibels) { thresholdGain = juce::Decibels::decibelsToGain(decibels); }
+    bool isSleeping() const noexcept { return sleepingFlag.load(); }
+    // Audio thread: the last analysed block was silent with nothing held
+    bool isQuiet() const noexcept { return sleeping || silentSamples > 0; }
+
+    // Audio thread: call before rendering; false means the block can be silent
+    bool shouldProcess(const juce::MidiBuffer& midiMessages) noexcept;
+    // Audio thread: call after rendering; mayClose is false while a transition
+    // (crossfade, A/B ramp) is still running
+    void analyse(const juce::AudioBuffer<float>& output, bool mayClose) noexcept;
+
+    static constexpr double maxTailSeconds = 60.0;
+
+private:
+    static double clampTail(double seconds) noexcept
+    {
+        return std::isfinite(seconds) ? juce::jlimit(0.0, maxTailSeconds, seconds) : (seconds > 0.0 ? maxTailSeconds : 0.0);
+    }
+    void trackMidi(const juce::uint8* data, int numBytes) noexcept;
+    bool anySustainHeld() const noexcept;
+
+    std::atomic<bool> enabled{ true };
+    std::atomic<double> tailSeconds{ 2.0 };
+    std::atomic<double> pluginTailSeconds{ 0.0 };
+    std::atomic<float> thresholdGain{ juce::Decibels::decibelsToGain(-90.0f) };
+    std::atomic<bool> sleepingFlag{ false };
+    double currentSampleRate = 44100.0;
+
+    // Audio thread only
+    std::bitset<16 * 128> heldNotes;
+    std::array<bool, 16> sustainHeld{};
+    juce::int64 silentSamples = 0;
+    bool sleeping = false;
+};
@@ -0,0 +1,213 @@
+#include "SoundMatcher.h"
+#include "ParameterNormalizer.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+SoundMatcher::SoundMatcher(PreviewRenderer& renderer)
+    : previewRenderer(renderer)
+{
+}
+
+SoundMatcher::~SoundMatcher()
+{
+    alive->store(false);
+}
+
+bool SoundMatcher::loadReference(const juce::File& file)
+{
+    juce::AudioFormatManager formats;
+    formats.registerBasicFormats();
+    std::unique_ptr<juce::AudioFormatReader> reader(formats.createReaderFor(file));
+    if (reader == nullptr)
+    {
+        DBG("SoundMatcher could not decode " << file.getFullPathName());
+        return false;
+    }
+
+    // Match at most the first few seconds; that is all the audition phrase covers
+    const double seconds = juce::jlimit(0.5, 3.0, reader->lengthInSamples / reader->sampleRate);
+    const int numSamples = (int)(seconds * reader->sampleRate);
+    juce::AudioBuffer<float> reference(2, numSamples);
+    reference.clear();
+    reader->read(&reference, 0, (int)juce::jmin((juce::int64)numSamples, reader->lengthInSamples), 0, true, reader->numChannels > 1);
+    if (reader->numChannels == 1)
+        reference.copyFrom(1, 0, reference, 0, 0, numSamples);
+
+    AudioFeatureExtractor extractor;
+    referenceFeatures = extractor.analyse(reference, reader->sampleRate);
+    referenceEnvelope = computeEnvelope(reference);
+    hasReference = referenceFeatures.valid;
+
+    // Render candidates over the same length with a single held note
+    matchPhrase = previewRenderer.getPhrase();
+    matchPhrase.notes = { 48 };
+    matchPhrase.holdSeconds = seconds * 0.7;
+    matchPhrase.tailSeconds = seconds * 0.3;
+
+    DBG("Reference loaded: " << file.getFileName() << ", centroid " << referenceFeatures.spectralCentroidHz
+        << " Hz, loudness " << referenceFeatures.loudnessDb << " dB");
+    return hasReference;
+}
+
+bool SoundMatcher::start(std::vector<Dimension> dimensions)
+{
+    if (!hasReference || dimensions.empty())
+        return false;
+
+    searchDimensions = std::move(dimensions);
+    mean.assign(searchDimensions.size(), 0.5f);
+    stepSizes.assign(searchDimensions.size(), 0.3f);
+    best = {};
+    generation = 0;
+    ++runId;
+    running = true;
+    startGeneration();
+    return true;
+}
+
+void SoundMatcher::cancel()
+{
+    ++runId;
+    running = false;
+}
+
+void SoundMatcher::startGeneration()
+{
+    population.assign((size_t)populationSize, {});
+    remaining = populationSize;
+
+    const auto savedPhrase = previewRenderer.getPhrase();
+    previewRenderer.setPhrase(matchPhrase);
+    for (int i = 0; i < populationSize; ++i)
+    {
+        auto& candidate = population[(size_t)i];
+        candidate.values.resize(searchDimensions.size());
+        std::vector<PreviewRenderer::ParameterChange> plan;
+        plan.reserve(searchDimensions.size());
+        for (size_t d = 0; d < searchDimensions.size(); ++d)
+        {
+            // Box-Muller sample around the current mean
+            const float u1 = juce::jmax(1.0e-6f, random.nextFloat());
+            const float u2 = random.nextFloat();
+            const float gaussian = std::sqrt(-2.0f * std::log(u1)) * std::cos(juce::MathConstants<float>::twoPi * u2);
+            candidate.values[d] = juce::jlimit(0.0f, 1.0f, mean[d] + stepSizes[d] * gaussian);
+            plan.push_back({ searchDimensions[d].parameterIndex, candidate.values[d] });
+        }
+
+        previewRenderer.render(i, std::move(plan),
+            [this, alive = alive, run = runId](int candidateId, const juce::AudioBuffer<float>& audio, const AudioFeatures& features)
+            {
+                if (!alive->load() || run != runId)
+                    return;
+                auto& rendered = population[(size_t)candidateId];
+                rendered.rendered = features.valid;
+                if (features.valid)
+                    rendered.loss = computeLoss(features, computeEnvelope(audio));
+                if (--remaining == 0)
+                    finishGeneration();
+            });
+    }
+    previewRenderer.setPhrase(savedPhrase);
+}
+
+void SoundMatcher::finishGeneration()
+{
+    std::vector<int> order((size_t)populationSize);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [this](int a, int b) {
+        return population[(size_t)a].loss < population[(size_t)b].loss;
+        });
+
+    if (!population[(size_t)order.front()].rendered)
+    {
+        DBG("SoundMatcher: no candidate rendered, stopping");
+        running = false;
+        return;
+    }
+
+    if (population[(size_t)order.front()].loss < best.loss)
+        best = population[(size_t)order.front()];
+
+    // Recombine the best half with log-rank weights and adapt each step size
+    std::array<float, parentCount> weights;
+    float weightSum = 0.0f;
+    for (int i = 0; i < parentCount; ++i)
+        weightSum += weights[(size_t)i] = std::log(parentCount + 0.5f) - std::log(i + 1.0f);
+
+    for (size_t d = 0; d < mean.size(); ++d)
+    {
+        float newMean = 0.0f;
+        for (int i = 0; i < parentCount; ++i)
+            newMean += weights[(size_t)i] / weightSum * population[(size_t)order[(size_t)i]].values[d];
+
+        float variance = 0.0f;
+        for (int i = 0; i < parentCount; ++i)
+        {
+            const float offset = population[(size_t)order[(size_t)i]].values[d] - mean[d];
+            variance += weights[(size_t)i] / weightSum * offset * offset;
+        }
+        stepSizes[d] = juce::jmax(minStepSize, 0.7f * stepSizes[d] + 0.3f * std::sqrt(variance));
+        mean[d] = newMean;
+    }
+
+    ++generation;
+    DBG("SoundMatcher generation " << generation << "/" << numGenerations << ", best loss " << best.loss);
+    if (onProgress)
+        onProgress(generation, numGenerations, best.loss);
+
+    if (generation >= numGenerations)
+        finish();
+    else
+        startGeneration();
+}
+
+void SoundMatcher::finish()
+{
+    running = false;
+    std::map<std::string, std::string> response;
+    for (size_t d = 0; d < searchDimensions.size(); ++d)
+        response[searchDimensions[d].name] = rawNormalizedValue(best.values[d]);
+
+    if (onFinished)
+        onFinished(std::move(response), best.loss);
+}
+
+float SoundMatcher::computeLoss(const AudioFeatures& features, const Envelope& envelope) const
+{
+    const float centroidRatio = juce::jmax(1.0f, features.spectralCentroidHz) / juce::jmax(1.0f, referenceFeatures.spectralCentroidHz);
+    float loss = std::abs(std::log2(centroidRatio));
+    loss += 2.0f * std::abs(features.brightness - referenceFeatures.brightness);
+    loss += 0.5f * std::abs(features.loudnessDb - referenceFeatures.loudnessDb) / 12.0f;
+    loss += 2.0f * std::abs(features.stereoWidth - referenceFeatures.stereoWidth);
+    loss += std::abs(features.transientSharpness - referenceFeatures.transientSharpness);
+
+    float envelopeError = 0.0f;
+    for (size_t i = 0; i < envelope.size(); ++i)
+        envelopeError += std::abs(envelope[i] - referenceEnvelope[i]);
+    return loss + envelopeError / (12.0f * (float)envelope.size());
+}
+
+SoundMatcher::Envelope SoundMatcher::computeEnvelope(const juce::AudioBuffer<float>& audio)
+{
+    // RMS of equal slices in dB relative to the loudest slice
+    Envelope envelope;
+    envelope.fill(-60.0f);
+    const int numSamples = audio.getNumSamples();
+    const int sliceLength = numSamples / envelopePoints;
+    if (sliceLength == 0)
+        return envelope;
+
+    float loudest = -100.0f;
+    for (int i = 0; i < envelopePoints; ++i)
+    {
+        float power = 0.0f;
+        for (int channel = 0; channel < audio.getNumChannels(); ++channel)
+            power += audio.getRMSLevel(channel, i * sliceLength, sliceLength);
+        envelope[(size_t)i] = juce::Decibels::gainToDecibels(power / (float)juce::jmax(1, audio.getNumChannels()), -100.0f);
+        loudest = juce::jmax(loudest, envelope[(size_t)i]);
+    }
+    for (auto& level : envelope)
+        level = juce::jmax(-60.0f, level - loudest);
+    return envelope;
+}
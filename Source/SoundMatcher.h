@@ -0,0 +1,84 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "AudioFeatures.h"
+#include "PreviewRenderer.h"
+
+// Finds Serum settings that sound like a reference recording, entirely offline.
+// The reference is decoded with juce_audio_formats and reduced to spectral
+// features plus an amplitude envelope; an evolution strategy with per-parameter
+// step sizes (a diagonal CMA-ES) then samples whole generations of candidates,
+// renders them in parallel through the PreviewRenderer's hidden instances and
+// moves towards the ones that sound closest.
+class SoundMatcher
+{
+public:
+    static constexpr int envelopePoints = 16;
+    using Envelope = std::array<float, envelopePoints>;
+
+    struct Dimension
+    {
+        std::string name;       // Serum 2 parameter name
+        int parameterIndex = -1;
+    };
+
+    explicit SoundMatcher(PreviewRenderer& renderer);
+    ~SoundMatcher();
+
+    // Message thread
+    bool loadReference(const juce::File& file);
+    bool start(std::vector<Dimension> dimensions);
+    void cancel();
+    bool isRunning() const noexcept { return running; }
+
+    std::function<void(int generation, int numGenerations, float bestLoss)> onProgress;
+    // The best match as a response map of raw normalized values ("=0.42")
+    std::function<void(std::map<std::string, std::string> response, float loss)> onFinished;
+
+    static Envelope computeEnvelope(const juce::AudioBuffer<float>& audio);
+
+private:
+    struct Candidate
+    {
+        std::vector<float> values;
+        float loss = std::numeric_limits<float>::max();
+        bool rendered = false;
+    };
+
+    void startGeneration();
+    void finishGeneration();
+    void finish();
+    float computeLoss(const AudioFeatures& features, const Envelope& envelope) const;
+
+    static constexpr int populationSize = 12;
+    static constexpr int parentCount = populationSize / 2;
+    static constexpr int numGenerations = 14;
+    static constexpr float minStepSize = 0.02f;
+
+    PreviewRenderer& previewRenderer;
+    PreviewRenderer::Phrase matchPhrase;
+    AudioFeatures referenceFeatures;
+    Envelope referenceEnvelope{};
+    bool hasReference = false;
+
+    std::vector<Dimension> searchDimensions;
+    std::vector<float> mean;
+    std::vector<float> stepSizes;
+    std::vector<Candidate> population;
+    Candidate best;
+    int generation = 0;
+    int remaining = 0;
+    int runId = 0;
+    bool running = false;
+    juce::Random random;
+    std::shared_ptr<std::atomic<bool>> alive = std::make_shared<std::atomic<bool>>(true);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SoundMatcher)
+};